@@ -23,7 +23,9 @@
  ****************************************************************************/
 
 #include "AppDelegate.h"
-#include "HelloWorldScene.h"
+#include "LoadingScene.h"
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
 
 #include <vector>
 
@@ -80,6 +82,11 @@ static int register_all_packages()
 }
 
 bool AppDelegate::applicationDidFinishLaunching() {
+    tripeaks::Profiler::markLaunchBegin();
+#if TRIPEAKS_ENABLE_TRACING
+    tripeaks::TraceRecorder::setThreadName("main");
+#endif
+
     // initialize director
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
@@ -124,7 +131,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
     fileUtils->setSearchPaths(searchPaths);
 
     // create a scene. it's an autorelease object
-    auto scene = HelloWorld::createScene();
+    // card textures are decoded off the main thread by the loading scene before the game scene is built
+    auto scene = LoadingScene::createScene();
 
     // run
     director->runWithScene(scene);
@@ -135,6 +143,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
 // This function will be called when the app is inactive. Note, when receiving a phone call it is invoked.
 void AppDelegate::applicationDidEnterBackground() {
     Director::getInstance()->stopAnimation();
+    // let the running scene persist its state before the process may be killed
+    Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_COME_TO_BACKGROUND);
 
 #if USE_AUDIO_ENGINE
     AudioEngine::pauseAll();
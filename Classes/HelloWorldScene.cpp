@@ -24,10 +24,22 @@
 
 #include "HelloWorldScene.h"
 
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
 #include "views/GameView.h"
 
+#include <ctime>
+
 USING_NS_CC;
 
+namespace
+{
+
+// 两个本机进程的竞速端口，0 号玩家绑定前者
+constexpr std::uint16_t kRacePorts[2] = {47100, 47101};
+
+} // namespace
+
 Scene* HelloWorld::createScene()
 {
     return HelloWorld::create();
@@ -57,6 +69,7 @@ bool HelloWorld::init()
     addChild(_gameView, 1);
 
     _gameController = std::make_unique<GameController>();
+    _gameController->enablePersistence(SessionPersistence::getDefaultDirectory());
 
     const std::string levelPath = FileUtils::getInstance()->fullPathForFilename("levels/level_tripeaks_standard.json");
     if (levelPath.empty() || !_gameController->init(_gameView, levelPath))
@@ -66,6 +79,86 @@ bool HelloWorld::init()
                                    origin.y + visibleSize.height * 0.5F));
         addChild(message, 10);
     }
+    else
+    {
+        _gameView->setRaceCallback([this]() {
+            startRace();
+        });
+        _gameController->setRaceFinishedCallback([this]() {
+            _raceLink.reset();
+            _raceController.reset();
+        });
+    }
 
     return true;
 }
+
+void HelloWorld::startRace()
+{
+    using namespace tripeaks;
+
+    if (_raceController)
+    {
+        _gameController->cancelRace();
+        return;
+    }
+
+    auto link = std::make_unique<RaceLink>();
+    std::string errorMessage;
+    int localPlayer = 0;
+    // 0 号玩家的端口已被占用时说明对方先开始等待，改为 1 号玩家
+    if (!link->open(kRacePorts[0], kRacePorts[1], RaceLink::Options(), &errorMessage))
+    {
+        localPlayer = 1;
+        if (!link->open(kRacePorts[1], kRacePorts[0], RaceLink::Options(), &errorMessage))
+        {
+            _gameView->showStatusMessage(errorMessage);
+            return;
+        }
+    }
+
+    // 双方不交换种子，以当天日期为准即可发到同一副牌；日期不一致时 Hello 不匹配，不会开局
+    const unsigned int seed = static_cast<unsigned int>(std::time(nullptr) / (24 * 60 * 60));
+    _raceLink = std::move(link);
+    _raceController = std::make_unique<RaceController>();
+    _gameController->startRace(_raceController.get(), _raceLink.get(), seed, localPlayer, RaceController::Options());
+}
+
+void HelloWorld::onEnter()
+{
+    Scene::onEnter();
+
+    using namespace tripeaks;
+
+    // 场景在 init 时可能仍处于加载场景的帧内，进入后的首次绘制完成才是首个可交互帧
+    if (Profiler::getTimeToFirstFrameMs() < 0.0)
+    {
+        _firstFrameListener = _eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+            Profiler::markFirstInteractiveFrame();
+            TRIPEAKS_TRACE_INSTANT("startup", "firstInteractiveFrame");
+            CCLOG("time to first frame: %.1f ms", Profiler::getTimeToFirstFrameMs());
+            _eventDispatcher->removeEventListener(_firstFrameListener);
+            _firstFrameListener = nullptr;
+        });
+    }
+
+    // 切到后台后进程随时可能被系统杀掉，立即同步存档
+    _backgroundListener = _eventDispatcher->addCustomEventListener(EVENT_COME_TO_BACKGROUND, [this](EventCustom*) {
+        _gameController->flushSession();
+    });
+}
+
+void HelloWorld::onExit()
+{
+    if (_firstFrameListener)
+    {
+        _eventDispatcher->removeEventListener(_firstFrameListener);
+        _firstFrameListener = nullptr;
+    }
+    if (_backgroundListener)
+    {
+        _eventDispatcher->removeEventListener(_backgroundListener);
+        _backgroundListener = nullptr;
+    }
+    Scene::onExit();
+}
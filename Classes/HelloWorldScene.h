@@ -42,13 +42,23 @@ public:
     static cocos2d::Scene* createScene();
 
     virtual bool init();
+    void onEnter() override;
+    void onExit() override;
     
     // implement the "static create()" method manually
     CREATE_FUNC(HelloWorld);
 
 private:
+    // 与本机另一个进程竞速：先按下的一方占用 0 号玩家的端口，另一方自动成为 1 号玩家；等待对方时再按一次取消
+    void startRace();
+
     tripeaks::GameView* _gameView = nullptr;
+    // 竞速对象先于 GameController 声明，后者持有它们的指针，须先析构
+    std::unique_ptr<tripeaks::RaceController> _raceController;
+    std::unique_ptr<tripeaks::RaceLink> _raceLink;
     std::unique_ptr<tripeaks::GameController> _gameController;
+    cocos2d::EventListenerCustom* _firstFrameListener = nullptr;
+    cocos2d::EventListenerCustom* _backgroundListener = nullptr;
 };
 
 #endif // __HELLOWORLD_SCENE_H__
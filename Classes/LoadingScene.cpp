@@ -0,0 +1,171 @@
+#include "LoadingScene.h"
+
+#include "HelloWorldScene.h"
+#include "utils/DecodedTextureCache.h"
+#include "utils/TraceRecorder.h"
+#include "views/CardFaceCache.h"
+
+USING_NS_CC;
+
+namespace
+{
+
+constexpr float kBarWidth = 600.0F;
+constexpr float kBarHeight = 24.0F;
+
+// 工作线程的加载结果，交回主线程上传
+struct TextureLoadResult
+{
+    std::string fullPath;
+    Image* image = nullptr;
+    bool fromCache = false;
+    std::string errorMessage;
+};
+
+} // namespace
+
+Scene* LoadingScene::createScene()
+{
+    return LoadingScene::create();
+}
+
+bool LoadingScene::init()
+{
+    if (!Scene::init())
+    {
+        return false;
+    }
+
+    const auto visibleSize = Director::getInstance()->getVisibleSize();
+    const auto origin = Director::getInstance()->getVisibleOrigin();
+    const Vec2 center(origin.x + visibleSize.width * 0.5F, origin.y + visibleSize.height * 0.5F);
+
+    auto background = LayerColor::create(Color4B(20, 70, 120, 255), visibleSize.width, visibleSize.height);
+    background->setPosition(origin);
+    addChild(background, -1);
+
+    // 进度条只用纯色层绘制，自身不依赖任何待加载的纹理
+    auto track = LayerColor::create(Color4B(0, 0, 0, 120), kBarWidth, kBarHeight);
+    track->setPosition(center.x - kBarWidth * 0.5F, center.y - kBarHeight * 0.5F);
+    addChild(track);
+
+    _progressBar = LayerColor::create(Color4B(240, 200, 80, 255), 0.0F, kBarHeight);
+    _progressBar->setPosition(track->getPosition());
+    addChild(_progressBar);
+
+    _progressLabel = Label::createWithSystemFont("", "Arial", 36);
+    _progressLabel->setPosition(center.x, center.y + kBarHeight + 30.0F);
+    addChild(_progressLabel);
+
+    // fullPathForFilename 不是线程安全的，先在主线程解析完整路径；缺失的散图由 CardFaceCache 以纯色占位回退，这里直接跳过
+    auto fileUtils = FileUtils::getInstance();
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const std::string& path : tripeaks::CardFaceCache::getTexturePaths())
+    {
+        const std::string fullPath = fileUtils->fullPathForFilename(path);
+        if (!fullPath.empty() && !textureCache->getTextureForKey(fullPath))
+        {
+            _texturePaths.emplace_back(fullPath);
+        }
+    }
+    updateProgress();
+
+    TRIPEAKS_TRACE_ASYNC_BEGIN("startup", "preloadTextures", 0);
+    if (_texturePaths.empty())
+    {
+        scheduleEnterGame();
+        return true;
+    }
+
+    // 读取磁盘缓存或解码 PNG 在 IO 线程中进行，回调在主线程上传纹理并以完整路径登记到 TextureCache
+    _decodedCache = std::make_shared<tripeaks::DecodedTextureCache>(tripeaks::DecodedTextureCache::getDefaultDirectory());
+    for (const std::string& fullPath : _texturePaths)
+    {
+        auto result = std::make_shared<TextureLoadResult>();
+        result->fullPath = fullPath;
+        std::shared_ptr<const tripeaks::DecodedTextureCache> decodedCache = _decodedCache;
+
+        // 任务回调前保持场景存活
+        retain();
+        AsyncTaskPool::getInstance()->enqueue(
+            AsyncTaskPool::TaskType::TASK_IO,
+            [this, result](void*) {
+                onTextureLoaded(result->fullPath, result->image, result->fromCache, result->errorMessage);
+                CC_SAFE_RELEASE(result->image);
+                release();
+            },
+            nullptr,
+            [result, decodedCache]() {
+                result->image = decodedCache->loadImage(result->fullPath, &result->fromCache, &result->errorMessage);
+            });
+    }
+
+    return true;
+}
+
+void LoadingScene::onExit()
+{
+    _exited = true;
+    Scene::onExit();
+}
+
+void LoadingScene::onTextureLoaded(const std::string& fullPath, Image* image, bool fromCache,
+                                   const std::string& errorMessage)
+{
+    // 加载未完成就离开场景时丢弃剩余结果
+    if (_exited)
+    {
+        return;
+    }
+
+    if (image)
+    {
+        TRIPEAKS_TRACE_SCOPE_ARG("startup", "uploadTexture", "fromCache", fromCache ? 1 : 0);
+        Director::getInstance()->getTextureCache()->addImage(image, fullPath);
+        if (fromCache)
+        {
+            ++_cachedCount;
+        }
+    }
+    else
+    {
+        log("LoadingScene: %s", errorMessage.c_str());
+    }
+
+    ++_loadedCount;
+    updateProgress();
+    if (_loadedCount >= static_cast<int>(_texturePaths.size()))
+    {
+        scheduleEnterGame();
+    }
+}
+
+void LoadingScene::updateProgress()
+{
+    const int total = static_cast<int>(_texturePaths.size());
+    const float progress = total > 0 ? static_cast<float>(_loadedCount) / total : 1.0F;
+    _progressBar->changeWidth(kBarWidth * progress);
+    _progressLabel->setString(StringUtils::format("Loading %d/%d", _loadedCount, total));
+}
+
+void LoadingScene::scheduleEnterGame()
+{
+    // 场景可能尚未开始运行（如 init 中没有需要加载的纹理），统一推迟到场景运行后的下一次调度再切换
+    scheduleOnce([this](float) { enterGame(); }, 0.0F, "enterGame");
+}
+
+void LoadingScene::enterGame()
+{
+    TRIPEAKS_TRACE_ASYNC_END("startup", "preloadTextures", 0);
+    CCLOG("LoadingScene: %d/%d textures from decoded cache", _cachedCount, static_cast<int>(_texturePaths.size()));
+
+    // 纹理均已在缓存中，注册图集帧与游戏场景中的牌面烘焙都不会再解码图片
+    tripeaks::CardFaceCache::loadAtlas();
+
+    Scene* gameScene = nullptr;
+    {
+        TRIPEAKS_TRACE_SCOPE("startup", "createGameScene");
+        gameScene = HelloWorld::createScene();
+    }
+    Director::getInstance()->replaceScene(gameScene);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tripeaks
+{
+class DecodedTextureCache;
+}
+
+/**
+ * 启动加载场景。
+ * 在 AsyncTaskPool 的 IO 线程中加载牌面所需的全部纹理并显示进度：优先 mmap 可写目录中的解码缓存，
+ * 缓存缺失或过期时解码 PNG 并写回缓存。全部就绪后注册图集帧并切换到游戏场景，使游戏场景的首帧不再同步解码 PNG。
+ */
+class LoadingScene : public cocos2d::Scene
+{
+public:
+    static cocos2d::Scene* createScene();
+
+    bool init() override;
+    void onExit() override;
+
+    CREATE_FUNC(LoadingScene);
+
+private:
+    void onTextureLoaded(const std::string& fullPath, cocos2d::Image* image, bool fromCache,
+                         const std::string& errorMessage);
+    void updateProgress();
+    void scheduleEnterGame();
+    void enterGame();
+
+    std::shared_ptr<tripeaks::DecodedTextureCache> _decodedCache;
+    std::vector<std::string> _texturePaths;     // 完整路径，同时作为 TextureCache 的键
+    int _loadedCount = 0;
+    int _cachedCount = 0;
+    bool _exited = false;
+
+    cocos2d::LayerColor* _progressBar = nullptr;
+    cocos2d::Label* _progressLabel = nullptr;
+};
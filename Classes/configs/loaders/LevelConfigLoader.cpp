@@ -3,6 +3,8 @@
 #include "cocos2d.h"
 
 #include "json/document.h"
+#include "models/MatchRule.h"
+#include "utils/TraceRecorder.h"
 #include <utility>
 
 namespace tripeaks
@@ -94,7 +96,8 @@ bool parseCardArray(const rapidjson::Value& jsonArray, std::vector<LevelCardConf
                         y = static_cast<float>(yValue.GetDouble());
                     }
                 }
-                config.position = cocos2d::Vec2(x, y);
+                config.position.x = x;
+                config.position.y = y;
             }
         }
 
@@ -126,6 +129,7 @@ bool LevelConfigLoader::loadFromFile(const std::string& filePath,
                                      LevelConfig& outConfig,
                                      std::string* errorMessage)
 {
+    TRIPEAKS_TRACE_SCOPE("model", "LevelConfigLoader::loadFromFile");
     using cocos2d::FileUtils;
 
     auto fileUtils = FileUtils::getInstance();
@@ -193,6 +197,35 @@ bool LevelConfigLoader::loadFromFile(const std::string& filePath,
         outConfig.stackCards.clear();
     }
 
+    outConfig.stockRecycles = 0;
+    if (hasMember(document, "stockRecycles", "StockRecycles"))
+    {
+        const auto& recyclesValue = getMember(document, "stockRecycles", "StockRecycles");
+        if (!recyclesValue.IsInt() || recyclesValue.GetInt() < -1)
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Invalid stockRecycles value";
+            }
+            return false;
+        }
+        outConfig.stockRecycles = recyclesValue.GetInt();
+    }
+
+    outConfig.matchRule = MatchRule::TriPeaks;
+    if (hasMember(document, "matchRule", "MatchRule"))
+    {
+        const auto& ruleValue = getMember(document, "matchRule", "MatchRule");
+        if (!ruleValue.IsString() || !parseMatchRuleName(ruleValue.GetString(), outConfig.matchRule))
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Invalid matchRule value";
+            }
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "cocos2d.h"
-
 #include <vector>
 
 namespace tripeaks
@@ -32,11 +30,28 @@ enum class CardFaceType
     King
 };
 
+// Which cards may be played onto the tray card; each rule is a compile-time match table (see models/MatchRule.h)
+enum class MatchRule
+{
+    TriPeaks = 0,          // rank +-1, K and A wrap around
+    Golf,                  // rank +-1, no wrap-around
+    SameSuit,              // rank +-1 with wrap-around, suits must match
+    AlternatingColor,      // rank +-1 with wrap-around, colors must differ
+    KingsWild              // TriPeaks plus kings match anything and anything matches a king
+};
+
+// Card position in scene coordinates; the core has no cocos2d dependency, views convert to cocos2d::Vec2
+struct CardPosition
+{
+    float x = 0.0F;
+    float y = 0.0F;
+};
+
 struct LevelCardConfig
 {
     int cardFace = -1;                     // 0~12 maps to A~K, -1 means random
     int cardSuit = -1;                     // 0~3 maps to suits, -1 means random
-    cocos2d::Vec2 position;                // card position in the scene
+    CardPosition position;                 // card position in the scene
     bool faceUp = false;                   // initial face-up state
     std::vector<int> coveredBy;            // IDs of cards covering this card
 };
@@ -45,6 +60,8 @@ struct LevelConfig
 {
     std::vector<LevelCardConfig> playfieldCards; // cards placed on the playfield
     std::vector<LevelCardConfig> stackCards;     // cards in the stock pile
+    int stockRecycles = 0;                       // times the waste pile may be turned back into an empty stock, -1 means unlimited
+    MatchRule matchRule = MatchRule::TriPeaks;   // match rule of this game variant
 };
 
 } // namespace tripeaks
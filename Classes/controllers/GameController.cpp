@@ -1,16 +1,89 @@
 #include "controllers/GameController.h"
 
+#include "configs/loaders/LevelConfigLoader.h"
+#include "controllers/InputRules.h"
+#include "services/SessionSerializer.h"
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
 #include "views/GameView.h"
+#include "views/RaceMiniBoardView.h"
 
 namespace tripeaks
 {
 
+namespace
+{
+
+// 竞速时间线的 tick 频率，双方一致
+constexpr int kRaceTicksPerSecond = 60;
+// 连上之前 Hello 的发送间隔；连上之后本方 tick 停住（领先过多）时也按此间隔重发输入，丢包不会让双方互等
+constexpr int kRaceResendIntervalMs = 50;
+// 对方确认到结果后再继续发送一段时间，本方最后的数据报丢失时对方也能确认结果
+constexpr int kRaceLingerMs = 500;
+// 连上之后对方至少每个重发间隔发一帧，超过该时长没有数据视为对方已离开
+constexpr int kRacePeerTimeoutMs = 5000;
+
+const char* getRaceOutcomeText(RaceOutcome outcome)
+{
+    switch (outcome)
+    {
+    case RaceOutcome::Won:
+        return "You won the race";
+    case RaceOutcome::Lost:
+        return "Your opponent won the race";
+    case RaceOutcome::Draw:
+        return "The race is a draw";
+    default:
+        return "";
+    }
+}
+
+} // namespace
+
 bool GameController::init(GameView* view, const std::string& levelPath)
 {
     _view = view;
 
+    if (_view)
+    {
+        _view->setCardTapCallback([this](int cardId) { onCardTapped(cardId); });
+        _view->setStockTapCallback([this]() { onStockTapped(); });
+        _view->setUndoCallback([this]() { onUndoTapped(); });
+        _view->setRestartCallback([this]() { restartLevel(); });
+        _view->setHintCallback([this]() { onHintTapped(); });
+        _view->setFrameCallback([this]() {
+            _scheduler.update();
+            updateRace();
+        });
+        _events.subscribe(_view);
+
+        _hintManager.setHintCallback([this](const HintSearchService::Result& result) { onHintReady(result); });
+        _hintManager.setOutcomeCallback([this](HintSearchService::Outcome outcome) { onOutcomeAnalyzed(outcome); });
+        _hintManager.start();
+    }
+
+    return loadLevel(levelPath);
+}
+
+void GameController::enablePersistence(const std::string& directory)
+{
+    _persistenceDirectory = directory;
+    _persistence = std::make_unique<SessionPersistence>(directory);
+}
+
+void GameController::flushSession()
+{
+    if (_persistence)
+    {
+        _persistence->flush();
+    }
+}
+
+bool GameController::loadLevel(const std::string& levelPath)
+{
+    TRIPEAKS_TRACE_SCOPE("controller", "loadLevel");
     std::string errorMessage;
-    if (!GameModelFromLevelGenerator::generateFromLevel(levelPath, _model, &errorMessage))
+    if (!LevelConfigLoader::loadFromFile(levelPath, _levelConfig, &errorMessage))
     {
         if (_view)
         {
@@ -19,119 +92,571 @@ bool GameController::init(GameView* view, const std::string& levelPath)
         return false;
     }
 
-    if (_view)
+    _levelHash = SessionSerializer::computeLevelHash(_levelConfig);
+    if (!resumeSession())
     {
-        _view->bindModel(&_model);
-        _view->setCardTapCallback([this](int cardId) { onCardTapped(cardId); });
-        _view->setStockTapCallback([this]() { onStockTapped(); });
-        _view->setUndoCallback([this]() { onUndoTapped(); });
-        _view->buildInitialLayout();
+        startLevel();
     }
+    return true;
+}
 
-    _undoManager.clear();
-    _playfieldController.initialize(&_model, _view);
-    _stackController.initialize(&_model, _view);
+void GameController::restartLevel()
+{
+    // 对方的模拟里本方牌桌不会重开
+    if (_race)
+    {
+        if (_view)
+        {
+            _view->showStatusMessage("Cannot restart during a race");
+        }
+        return;
+    }
+    // 复用已解析的关卡配置，视图侧复用卡牌视图池，不重新读取文件也不分配节点
+    startLevel();
+}
 
-    if (!_stackController.drawInitialCard())
+void GameController::startRace(RaceController* race, RaceLink* link, unsigned int seed, int localPlayer,
+                               const RaceController::Options& options)
+{
+    _race = race;
+    _raceLink = link;
+    _raceSeed = seed;
+    _raceLastSent = std::chrono::steady_clock::time_point();
+    _raceClockRunning = false;
+    _raceShownOutcome = RaceOutcome::Racing;
+    _raceResultAcked = false;
+    // 竞速局面由双方共同的时间线决定，不能从存档恢复
+    _persistence.reset();
+
+    // 连上对方之后才发牌，先等待的一方不能提前看牌或走牌
+    _race->start(_levelConfig, seed, localPlayer, options);
+    if (_view)
+    {
+        _view->showStatusMessage("Waiting for opponent");
+    }
+}
+
+void GameController::cancelRace()
+{
+    if (!_race)
+    {
+        return;
+    }
+    if (_raceClockRunning)
     {
         if (_view)
         {
-            _view->showStatusMessage("No card available to draw");
+            _view->showStatusMessage("Cannot leave during a race");
         }
+        return;
+    }
+    finishRace("Race cancelled");
+}
+
+void GameController::setRaceFinishedCallback(const std::function<void()>& callback)
+{
+    _onRaceFinished = callback;
+}
+
+void GameController::startLevel()
+{
+    TRIPEAKS_TRACE_SCOPE("controller", "startLevel");
+    // 竞速时双方必须发到同一副牌，与 RaceController 中的 TableController::start 相同
+    if (_race)
+    {
+        GameModelFromLevelGenerator::generateFromConfig(_levelConfig, _raceSeed, _model);
+    }
+    else
+    {
+        GameModelFromLevelGenerator::generateFromConfig(_levelConfig, _model);
     }
+    resetBoardState();
+
     _undoManager.clear();
+    _inputQueue.clear();
+    _playfieldController.initialize(&_model, &_events);
+    _stackController.initialize(&_model, &_events);
+
+    if (!_stackController.drawInitialCard())
+    {
+        _events.publish(BoardEvent::statusMessage("No card available to draw"));
+    }
+    _undoManager.clear();
+
+    if (_persistence)
+    {
+        _persistence->beginLevel(_levelHash);
+        _persistence->writeSnapshot(_model, _undoManager.getMoves());
+    }
 
-    refreshCardStates();
     updateStockView();
-    handleVictoryCheck();
+    flushBoardChanges();
+}
 
+bool GameController::resumeSession()
+{
+    if (!_persistence)
+    {
+        return false;
+    }
+
+    TRIPEAKS_TRACE_SCOPE("controller", "resumeSession");
+    GameModelFromLevelGenerator::generateFromConfig(_levelConfig, _model);
+    std::vector<UndoMove> undoMoves;
+    std::vector<InputCommand> tail;
+    if (!_persistence->load(_levelHash, _model, undoMoves, tail))
+    {
+        return false;
+    }
+
+    _undoManager.assign(std::move(undoMoves));
+    _inputQueue.clear();
+    _playfieldController.initialize(&_model, &_events);
+    _stackController.initialize(&_model, &_events);
+
+    // 日志中只有当时成功的输入，在同一局面上无动画重放即可回到被杀前的状态
+    _gameState = GameState::Playing;
+    for (const InputCommand& command : tail)
+    {
+        applyInput(command, false);
+    }
+    resetBoardState();
+
+    // 把重放过的记录并入新快照，日志从这里重新开始
+    _persistence->writeSnapshot(_model, _undoManager.getMoves());
+
+    updateStockView();
+    flushBoardChanges();
     return true;
 }
 
-void GameController::onCardTapped(int cardId)
+void GameController::resetBoardState()
 {
-    UndoMove move;
-    if (!_playfieldController.handleCardTap(cardId, move))
+    // 布局重建时会全量刷新，生成阶段的变化与上一局未派发的事件都无需再交给视图
+    _model.takeChanges(_boardChanges);
+    _events.clear();
+    _scheduler.clear();
+    _hintManager.reset();
+    _deadEndDetector.rebuild(_model);
+    _provenUnwinnable = false;
+    _gameState = GameState::Playing;
+    _events.publish(BoardEvent::gameStateChanged(GameState::Playing));
+
+    if (_view)
     {
-        return;
+        _view->bindModel(&_model);
+        _view->buildInitialLayout();
     }
+}
 
-    _undoManager.push(move);
-    handleVictoryCheck();
+void GameController::onCardTapped(int cardId)
+{
+    TRIPEAKS_TRACE_SCOPE_ARG("controller", "onCardTapped", "cardId", cardId);
+    InputCommand command;
+    command.type = InputCommand::Type::CardTap;
+    command.cardId = cardId;
+    queueInput(command);
+    processInputQueue();
 }
 
 void GameController::onStockTapped()
 {
-    UndoMove move;
-    if (!_stackController.handleStockTap(move))
+    TRIPEAKS_TRACE_SCOPE("controller", "onStockTapped");
+    InputCommand command;
+    command.type = InputCommand::Type::StockTap;
+    queueInput(command);
+    processInputQueue();
+}
+
+void GameController::onUndoTapped()
+{
+    TRIPEAKS_TRACE_SCOPE("controller", "onUndoTapped");
+    InputCommand command;
+    command.type = InputCommand::Type::Undo;
+    queueInput(command);
+    processInputQueue();
+}
+
+void GameController::onHintTapped()
+{
+    TRIPEAKS_TRACE_SCOPE("controller", "onHintTapped");
+    _hintManager.requestHint();
+}
+
+void GameController::queueInput(const InputCommand& command)
+{
+    _inputQueue.emplace_back(command);
+}
+
+void GameController::processInputQueue()
+{
+    // 处理过程中由回调再次触发时只入队，由外层循环继续处理
+    if (_processingInput || _inputQueue.empty())
     {
         return;
     }
 
-    _undoManager.push(move);
-    handleVictoryCheck();
+    TRIPEAKS_PROFILE_SCOPE(Input);
+    TRIPEAKS_TRACE_SCOPE_ARG("controller", "processInputQueue", "inputs", _inputQueue.size());
+    // 竞速连上对方之前还没有发牌，此时的输入不属于竞速牌局
+    if (_race && !_raceClockRunning)
+    {
+        _inputQueue.clear();
+        if (_view)
+        {
+            _view->showStatusMessage("Waiting for opponent");
+        }
+        return;
+    }
+    if (_view)
+    {
+        // 上一批的动画尚未播完：画面先落到上一批的结果，只为这一批播放动画
+        _inputBacklog = isAnimationSettled(_animationFence) ? 0 : _inputBacklog + _inputQueue.size();
+        if (_inputBacklog > 0)
+        {
+            _view->coalesceAnimations(_inputBacklog);
+        }
+    }
+    _processingInput = true;
+    for (std::size_t index = 0; index < _inputQueue.size(); ++index)
+    {
+        const InputCommand command = _inputQueue[index];
+        const bool animated = index + 1 == _inputQueue.size();
+        if (!applyInput(command, animated))
+        {
+            continue;
+        }
+        if (_persistence)
+        {
+            _persistence->recordInput(command);
+        }
+        // 只转交生效的输入，对方模拟的本方牌桌与这里一致
+        if (_race)
+        {
+            _race->queueLocalInput(command);
+        }
+    }
+    _inputQueue.clear();
+    _processingInput = false;
+    // 玩家已自行走了一步，之前请求的提示不再显示
+    _hintManager.cancelRequest();
+
+    flushBoardChanges();
 }
 
-void GameController::onUndoTapped()
+bool GameController::applyInput(const InputCommand& command, bool animated)
+{
+    if (!InputRules::apply(command, _gameState, animated, _playfieldController, _stackController, _undoManager,
+                           _events))
+    {
+        return false;
+    }
+    if (command.type == InputCommand::Type::Undo)
+    {
+        // 被回退的这一步尚未执行的后续步骤不再需要
+        _scheduler.cancelFrom(getCurrentMove() + 1);
+        // 回退后的局面可能重新有胜算，由后台重新判定
+        _provenUnwinnable = false;
+    }
+    return true;
+}
+
+void GameController::updateRace()
 {
-    UndoMove move;
-    if (!_undoManager.pop(move))
+    if (!_race || !_raceLink)
     {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::string errorMessage;
+    while (_raceLink->receive(_raceReceived))
+    {
+        _raceLastReceived = now;
+        // 无法解析或不属于本局的帧丢弃，不影响后续的帧
+        if (!_race->receiveFrame(_raceReceived.data(), _raceReceived.size(), &errorMessage) && _view)
+        {
+            _view->showStatusMessage(errorMessage);
+        }
+    }
+
+    const bool resendDue = now - _raceLastSent > std::chrono::milliseconds(kRaceResendIntervalMs);
+    if (!_race->isConnected())
+    {
+        if (resendDue)
+        {
+            sendRaceFrame(false, now);
+        }
+        return;
+    }
+    if (!_raceClockRunning)
+    {
+        _raceClockRunning = true;
+        _raceClockStart = now;
+        // 再回一次 Hello，本方先前的 Hello 被丢弃时对方也能连上
+        sendRaceFrame(false, now);
+        startLevel();
+        _raceBoard = _view ? _view->showRaceBoard() : nullptr;
+        if (_raceBoard)
+        {
+            _raceBoard->refresh(_race->getOpponentTable().getModel());
+        }
         if (_view)
         {
-            _view->showStatusMessage("Nothing to undo");
+            _view->clearStatusMessage();
         }
+    }
+    else if (now - _raceLastReceived > std::chrono::milliseconds(kRacePeerTimeoutMs))
+    {
+        finishRace("Opponent left the race");
         return;
     }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _raceClockStart).count();
+    const std::uint32_t dueTick = static_cast<std::uint32_t>(elapsed * kRaceTicksPerSecond / 1000);
+    // 领先对方过多时 advanceTick 返回false，等对方的输入到达后再追上
+    bool advanced = false;
+    while (_race->getTick() < dueTick && _race->advanceTick())
+    {
+        advanced = true;
+    }
+    if (advanced || resendDue)
+    {
+        sendRaceFrame(true, now);
+    }
+    if (advanced && _raceBoard)
+    {
+        _raceBoard->refresh(_race->getOpponentTable().getModel());
+    }
 
-    switch (move.type)
+    // 只显示确认结果，预测结果可能被迟到的输入推翻
+    const RaceResult& result = _race->getConfirmedResult();
+    if (result.outcome != _raceShownOutcome)
     {
-    case UndoMove::Type::PlayfieldMatch:
-        _playfieldController.undoMatch(move);
-        break;
-    case UndoMove::Type::ReplaceTrayFromStock:
-        _stackController.undoDraw(move);
-        break;
-    default:
-        break;
+        _raceShownOutcome = result.outcome;
+        if (_view)
+        {
+            _view->showStatusMessage(getRaceOutcomeText(result.outcome));
+        }
     }
+    if (result.outcome == RaceOutcome::Racing || _race->getPeerAckTick() <= result.tick)
+    {
+        return;
+    }
+    if (!_raceResultAcked)
+    {
+        _raceResultAcked = true;
+        _raceResultAckedAt = now;
+    }
+    else if (now - _raceResultAckedAt > std::chrono::milliseconds(kRaceLingerMs))
+    {
+        finishRace(nullptr);
+    }
+}
 
-    handleVictoryCheck();
+void GameController::sendRaceFrame(bool inputs, std::chrono::steady_clock::time_point now)
+{
+    _raceOutgoing.clear();
+    if (inputs)
+    {
+        _race->writeInputs(_raceOutgoing);
+    }
+    else
+    {
+        _race->writeHello(_raceOutgoing);
+    }
+    _raceLink->send(_raceOutgoing);
+    _raceLastSent = now;
 }
 
-void GameController::refreshCardStates()
+void GameController::finishRace(const char* message)
 {
+    _race = nullptr;
+    _raceLink = nullptr;
+    _raceClockRunning = false;
+    if (_raceBoard)
+    {
+        _view->hideRaceBoard();
+        _raceBoard = nullptr;
+    }
+    if (message && _view)
+    {
+        _view->showStatusMessage(message);
+    }
+
+    // 竞速结束时的局面作为新的一局继续保存，之后可以重新开局
+    if (!_persistenceDirectory.empty())
+    {
+        enablePersistence(_persistenceDirectory);
+        _persistence->beginLevel(_levelHash);
+        _persistence->writeSnapshot(_model, _undoManager.getMoves());
+    }
+
+    // 回调中调用方会释放 race 与 link，放在最后
+    if (_onRaceFinished)
+    {
+        _onRaceFinished();
+    }
+}
+
+void GameController::flushBoardChanges()
+{
+    // 本批变化引发的动画记为新的一批，后续步骤据此等待
+    ++_animationFence;
     if (_view)
     {
-        _view->refreshCardStates();
+        _view->setAnimationFence(_animationFence);
+    }
+
+    _model.takeChanges(_boardChanges);
+    _deadEndDetector.applyChanges(_model, _boardChanges);
+    updateGameState();
+    scheduleSnapshot();
+
+    _events.dispatch();
+    if (_view && !_boardChanges.empty())
+    {
+        _view->queueChanges(_boardChanges);
     }
+
+    // 每步之后在后台为新局面预先搜索提示
+    _hintManager.onBoardChanged(_model);
+
+    // 无界面运行时条件立即满足，后续步骤在这里同步完成
+    _scheduler.update();
 }
 
 void GameController::updateStockView()
 {
-    if (_view)
+    _events.publish(BoardEvent::stockChanged());
+}
+
+void GameController::updateGameState()
+{
+    GameState state = GameState::Playing;
+    const char* reason = nullptr;
+    if (_model.isVictory())
+    {
+        state = GameState::Won;
+    }
+    else if (_deadEndDetector.isDeadEnd(_model))
     {
-        _view->layoutStock();
+        state = GameState::Lost;
+        reason = "No moves left";
+    }
+    else if (_provenUnwinnable)
+    {
+        state = GameState::Lost;
+        reason = "No way to win from here";
+    }
+
+    if (state != _gameState)
+    {
+        _gameState = state;
+        _events.publish(BoardEvent::gameStateChanged(state, reason));
+        if (state != GameState::Playing)
+        {
+            scheduleGameResult(state, reason);
+        }
     }
 }
 
-void GameController::handleVictoryCheck()
+void GameController::scheduleGameResult(GameState state, const char* reason)
 {
     if (!_view)
     {
         return;
     }
 
-    if (_model.isVictory())
+    const std::uint32_t fence = _animationFence;
+    _scheduler.schedule(
+        getCurrentMove(), [this, fence]() { return isAnimationSettled(fence); },
+        [this, state, reason]() {
+            if (state == GameState::Won)
+            {
+                _view->showVictory();
+            }
+            else
+            {
+                _view->showGameOver(reason ? reason : "");
+            }
+        });
+}
+
+void GameController::scheduleSnapshot()
+{
+    if (!_persistence || !_persistence->isSnapshotDue())
     {
-        _view->showVictory();
+        return;
     }
-    else
+
+    // 快照取执行时的局面，日志中已记下之前的全部输入，等待期间再走几步也不影响恢复
+    const std::uint32_t fence = _animationFence;
+    _scheduler.schedule(
+        getCurrentMove(), [this, fence]() { return isAnimationSettled(fence); },
+        [this]() {
+            // 同一快照可能被连续几批输入各挂起一次，已写过的跳过
+            if (_persistence && _persistence->isSnapshotDue())
+            {
+                _persistence->writeSnapshot(_model, _undoManager.getMoves());
+            }
+        });
+}
+
+bool GameController::isAnimationSettled(std::uint32_t fence) const
+{
+    return !_view || _view->isAnimationSettled(fence);
+}
+
+std::uint32_t GameController::getCurrentMove() const
+{
+    return static_cast<std::uint32_t>(_undoManager.getMoves().size());
+}
+
+void GameController::onOutcomeAnalyzed(HintSearchService::Outcome outcome)
+{
+    // 无法取胜的局面之后无论怎么走都无法取胜，直到回退或重新开局前保持结论
+    if (outcome != HintSearchService::Outcome::Unwinnable || _provenUnwinnable)
+    {
+        return;
+    }
+    _provenUnwinnable = true;
+    flushBoardChanges();
+}
+
+void GameController::onHintReady(const HintSearchService::Result& result)
+{
+    const std::uint32_t fence = _animationFence;
+    _scheduler.schedule(
+        getCurrentMove(), [this, fence]() { return isAnimationSettled(fence); },
+        [this, result]() {
+            // 等待期间玩家可能已经走了一步，过时的提示不再显示
+            if (result.stateHash == HintSearchService::computeStateHash(_model))
+            {
+                showHint(result);
+            }
+        });
+    _scheduler.update();
+}
+
+void GameController::showHint(const HintSearchService::Result& result)
+{
+    if (!_view)
     {
-        _view->hideVictory();
+        return;
     }
 
-    _view->refreshCardStates();
+    switch (result.move.type)
+    {
+    case HintSearchService::Move::Type::PlayfieldCard:
+        _view->showCardHint(result.move.cardId);
+        break;
+    case HintSearchService::Move::Type::DrawStock:
+        _view->showStockHint();
+        break;
+    default:
+        _view->showStatusMessage("No moves left");
+        break;
+    }
 }
 
 } // namespace tripeaks
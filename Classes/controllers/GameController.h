@@ -1,37 +1,149 @@
 #pragma once
 
 #include "controllers/PlayFieldController.h"
+#include "controllers/RaceController.h"
 #include "controllers/StackController.h"
+#include "managers/BoardEventBus.h"
+#include "managers/DeadEndDetector.h"
+#include "managers/HintManager.h"
+#include "managers/MoveScheduler.h"
+#include "managers/RaceLink.h"
+#include "managers/SessionPersistence.h"
 #include "managers/UndoManager.h"
+#include "models/InputCommand.h"
 #include "services/GameModelFromLevelGenerator.h"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace tripeaks
 {
 
+class GameView;
+class RaceMiniBoardView;
+
 class GameController
 {
 public:
     bool init(GameView* view, const std::string& levelPath);
 
+    // 在 init 之前调用：每步输入写入存档，加载关卡时若存档属于同一关卡则从存档恢复
+    void enablePersistence(const std::string& directory);
+    // 立即同步存档中尚未落盘的记录（切到后台时调用）
+    void flushSession();
+
+    // 加载新关卡；视图中的卡牌视图池与触摸监听在关卡之间复用
+    bool loadLevel(const std::string& levelPath);
+    // 以当前关卡配置重新开局
+    void restartLevel();
+
+    /**
+     * 在 init 之后调用：通过已打开的 link 加入竞速。每帧收取对方的帧，连上之前定期发送 Hello 并丢弃本方输入；
+     * 连上之后以共同的种子发牌并开始计时，本方生效的每条输入转交给 race，按真实时间推进 tick 并发出本方输入，
+     * 用对手的预测局面刷新视图中的缩略牌桌，确认结果后显示在状态栏。竞速期间不写存档、不能重新开局
+     */
+    void startRace(RaceController* race, RaceLink* link, unsigned int seed, int localPlayer,
+                   const RaceController::Options& options);
+    // 连上对方之前退出竞速；连上之后只能等结果
+    void cancelRace();
+    /**
+     * 竞速结束时调用：结果确认并通知到对方、对方长时间没有数据或等待中取消。
+     * 此时已不再引用 race 与 link，调用方可以释放；之后恢复存档与重新开局，当前局面作为新的一局继续
+     */
+    void setRaceFinishedCallback(const std::function<void()>& callback);
+
     void onCardTapped(int cardId);
     void onStockTapped();
     void onUndoTapped();
+    // 显示下一步提示；后台搜索尚未完成时在结果就绪后显示
+    void onHintTapped();
+
+    /**
+     * 输入队列：每条输入到来时立即作用于模型，不等待上一步的动画；队列中有多条时只有最后一步播放动画，
+     * 之前的步骤在画面上直接落到结果状态，牌桌变化在整批处理完后只提交一次。
+     * 上一批的动画尚未播完时由视图把进行中的动画直接落到终点，连续积压较多时加速播放
+     */
+    void queueInput(const InputCommand& command);
+    void processInputQueue();
+
+    // 每批输入处理完后更新；Lost 包括无路可走和后台证明已无法取胜两种情况
+    GameState getGameState() const { return _gameState; }
 
     GameModel& getModel() { return _model; }
     const GameModel& getModel() const { return _model; }
 
+    // 牌桌事件通道：视图在 init 时订阅，回放记录、统计等可额外订阅；不传视图时即为无界面运行
+    BoardEventBus& getEvents() { return _events; }
+
 private:
-    void refreshCardStates();
+    // 把本批输入发布的事件派发给订阅者，并把模型累积的增量变化交给视图，由视图在下一帧统一应用
+    void flushBoardChanges();
     void updateStockView();
-    void handleVictoryCheck();
+    void updateGameState();
+    void onOutcomeAnalyzed(HintSearchService::Outcome outcome);
+    // 提示结果就绪：等当前动画播完且局面未变时再高亮
+    void onHintReady(const HintSearchService::Result& result);
+    void showHint(const HintSearchService::Result& result);
+    // 本局结束：等最后一步的动画播完再显示结算界面，期间回退则取消
+    void scheduleGameResult(GameState state, const char* reason);
+    // 距上次快照的输入足够多时，等本批动画播完再写快照，序列化不与动画挤在同一帧
+    void scheduleSnapshot();
+    bool isAnimationSettled(std::uint32_t fence) const;
+    // 当前走法编号（回退栈深度），后续步骤按它挂起与取消
+    std::uint32_t getCurrentMove() const;
+    void startLevel();
+    // 从存档恢复当前关卡：套用快照后重放日志中的输入；没有可用存档时返回false
+    bool resumeSession();
+    // 开局与恢复共用：清空上一局残留的变化与事件，重建派生状态并让视图全量布局
+    void resetBoardState();
+    bool applyInput(const InputCommand& command, bool animated);
+    // 每帧调用：收取对方的帧，连接前发送 Hello，连接后按 60 tick/秒推进竞速时间线并发出本方输入
+    void updateRace();
+    // inputs 为false时发送 Hello
+    void sendRaceFrame(bool inputs, std::chrono::steady_clock::time_point now);
+    // message 为空时保留状态栏中的结果
+    void finishRace(const char* message);
 
+    LevelConfig _levelConfig;
     GameModel _model;
+    BoardChangeSet _boardChanges;   // 复用的变化缓冲区
+    BoardEventBus _events;
     UndoManager _undoManager;
     PlayFieldController _playfieldController;
     StackController _stackController;
+    DeadEndDetector _deadEndDetector;
+    HintManager _hintManager;       // 只在有视图时启动工作线程；同时在后台判定当前局面能否取胜
+    MoveScheduler _scheduler;       // 等待动画或后台结果的后续步骤，有视图时每帧检查
+    std::uint32_t _animationFence = 0;  // 每批变化交给视图前递增
+    std::unique_ptr<SessionPersistence> _persistence;   // 未启用存档或竞速期间为空
+    std::string _persistenceDirectory;                  // 竞速结束后据此重新启用存档
+    std::uint64_t _levelHash = 0;
     GameView* _view = nullptr;
+
+    std::vector<InputCommand> _inputQueue;
+    bool _processingInput = false;
+    std::size_t _inputBacklog = 0;  // 上一批动画播完前连续到来的输入数，动画播完后的首条输入时清零
+    GameState _gameState = GameState::Playing;
+    bool _provenUnwinnable = false;
+
+    RaceController* _race = nullptr;            // 未参加竞速时为空
+    RaceLink* _raceLink = nullptr;
+    RaceMiniBoardView* _raceBoard = nullptr;
+    std::vector<unsigned char> _raceReceived;   // 收发缓冲区，复用容量
+    std::vector<unsigned char> _raceOutgoing;
+    std::chrono::steady_clock::time_point _raceLastSent;
+    std::chrono::steady_clock::time_point _raceLastReceived;
+    unsigned int _raceSeed = 0;
+    bool _raceClockRunning = false;             // 连上对方并发牌后为true
+    std::chrono::steady_clock::time_point _raceClockStart;
+    RaceOutcome _raceShownOutcome = RaceOutcome::Racing;
+    bool _raceResultAcked = false;              // 对方已确认到结果之后的 tick
+    std::chrono::steady_clock::time_point _raceResultAckedAt;
+    std::function<void()> _onRaceFinished;
 };
 
 } // namespace tripeaks
@@ -0,0 +1,70 @@
+#include "controllers/InputRules.h"
+
+namespace tripeaks
+{
+
+bool InputRules::apply(const InputCommand& command, GameState gameState, bool animated,
+                       PlayFieldController& playfieldController, StackController& stackController,
+                       UndoManager& undoManager, BoardEventBus& events)
+{
+    // 一局结束后只接受回退
+    if (gameState != GameState::Playing && command.type != InputCommand::Type::Undo)
+    {
+        return false;
+    }
+
+    UndoMove move;
+    switch (command.type)
+    {
+    case InputCommand::Type::CardTap:
+        if (!playfieldController.handleCardTap(command.cardId, move, animated))
+        {
+            return false;
+        }
+        undoManager.push(move);
+        return true;
+    case InputCommand::Type::StockTap:
+        if (!stackController.handleStockTap(move, animated))
+        {
+            return false;
+        }
+        undoManager.push(move);
+        return true;
+    case InputCommand::Type::Undo:
+        break;
+    default:
+        return false;
+    }
+
+    if (!undoManager.pop(move))
+    {
+        events.publish(BoardEvent::statusMessage("Nothing to undo"));
+        return false;
+    }
+
+    bool undone = true;
+    switch (move.type)
+    {
+    case UndoMove::Type::PlayfieldMatch:
+        undone = playfieldController.undoMatch(move, animated);
+        break;
+    case UndoMove::Type::ReplaceTrayFromStock:
+        undone = stackController.undoDraw(move, animated);
+        break;
+    case UndoMove::Type::RecycleWaste:
+        stackController.undoRecycle(move);
+        break;
+    default:
+        break;
+    }
+    if (!undone)
+    {
+        // 回退记录与弃牌堆不一致：牌桌未被修改，记录放回栈顶
+        undoManager.push(move);
+        events.publish(BoardEvent::statusMessage("Cannot undo this move"));
+        return false;
+    }
+    return true;
+}
+
+} // namespace tripeaks
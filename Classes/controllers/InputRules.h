@@ -0,0 +1,27 @@
+#pragma once
+
+#include "controllers/PlayFieldController.h"
+#include "controllers/StackController.h"
+#include "managers/BoardEventBus.h"
+#include "managers/UndoManager.h"
+#include "models/BoardEvent.h"
+#include "models/InputCommand.h"
+
+namespace tripeaks
+{
+
+/**
+ * 一条输入作用于牌桌的规则，GameController 与 TableController 共用：
+ * 一局结束后只接受回退；走牌成功后压入回退栈；回退按记录的类型撤销最近一步。
+ * 对战同步依赖两端对同一串输入得到同一局面，规则只在这里维护；动画与视图相关的后续处理由调用方负责。
+ */
+class InputRules
+{
+public:
+    // 返回输入是否生效；回退记录与牌桌不一致时拒绝回退；animated 为false时画面直接落到结果状态
+    static bool apply(const InputCommand& command, GameState gameState, bool animated,
+                      PlayFieldController& playfieldController, StackController& stackController,
+                      UndoManager& undoManager, BoardEventBus& events);
+};
+
+} // namespace tripeaks
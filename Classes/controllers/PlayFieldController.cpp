@@ -1,21 +1,17 @@
 #include "controllers/PlayFieldController.h"
 
-#include "services/CardMatchService.h"
-
-#include <algorithm>
-
 namespace tripeaks
 {
 
-void PlayFieldController::initialize(GameModel* model, GameView* view)
+void PlayFieldController::initialize(GameModel* model, BoardEventBus* events)
 {
     _model = model;
-    _view = view;
+    _events = events;
 }
 
-bool PlayFieldController::handleCardTap(int cardId, UndoMove& outMove)
+bool PlayFieldController::handleCardTap(int cardId, UndoMove& outMove, bool animated)
 {
-    if (!_model || !_view)
+    if (!_model || !_events)
     {
         return false;
     }
@@ -30,13 +26,13 @@ bool PlayFieldController::handleCardTap(int cardId, UndoMove& outMove)
     const Card* trayCard = _model->getCardById(trayCardId);
     if (!trayCard)
     {
-        _view->showStatusMessage("Draw from the stock first");
+        _events->publish(BoardEvent::statusMessage("Draw from the stock first"));
         return false;
     }
 
-    if (!CardMatchService::canMatch(card->face, trayCard->face))
+    if (!_model->canMatch(*card, *trayCard))
     {
-        _view->showStatusMessage("Card cannot match the tray");
+        _events->publish(BoardEvent::statusMessage("Card cannot match the tray"));
         return false;
     }
 
@@ -53,18 +49,14 @@ bool PlayFieldController::handleCardTap(int cardId, UndoMove& outMove)
     outMove.previousTrayCardId = trayCardId;
     outMove.previousPlayfieldIndex = playfieldIndex;
 
-    // 替换手牌区顶部牌，并将旧的tray card移回stock
+    // 替换手牌区顶部牌，旧的tray card压入弃牌堆
     const int oldTrayCardId = _model->replaceTrayCard(cardId);
-    if (oldTrayCardId >= 0)
-    {
-        _model->returnCardToStock(oldTrayCardId);
-    }
     
     // 从桌面移除卡牌
     _model->removeCardFromPlayfield(cardId);
 
-    // 执行动画：桌面牌平移到手牌区替换顶部牌
-    _view->replaceTrayCardWithPlayfieldCard(cardId, oldTrayCardId, true);
+    // 执行动画：桌面牌平移到手牌区，盖住旧的顶部牌
+    _events->publish(BoardEvent::cardRemoved(cardId, oldTrayCardId, animated));
 
     // 处理自动翻开的卡牌
     Card* removedCard = _model->getCardById(cardId);
@@ -82,60 +74,49 @@ bool PlayFieldController::handleCardTap(int cardId, UndoMove& outMove)
             {
                 outMove.flipStates.push_back({coveredId, coveredCard->faceUp});
                 _model->setCardFaceUp(coveredId, true);
-                _view->flipCard(coveredId, true);
+                _events->publish(BoardEvent::cardFlipped(coveredId, true, animated));
             }
         }
     }
 
-    _view->refreshCardStates();
 
     return true;
 }
 
-void PlayFieldController::undoMatch(const UndoMove& move)
+bool PlayFieldController::undoMatch(const UndoMove& move, bool animated)
 {
-    if (!_model || !_view)
+    if (!_model || !_events)
     {
-        return;
+        return false;
     }
 
     if (move.type != UndoMove::Type::PlayfieldMatch)
     {
-        return;
+        return false;
     }
 
     const int cardId = move.movedCardId;
-    
+
+    // 弃牌堆顶部牌回到手牌区；先于其他修改检查，不一致时整步不回退
+    if (!_model->restorePreviousTrayCard(move.previousTrayCardId))
+    {
+        return false;
+    }
+
     // 恢复桌面牌
     _model->restoreCardToPlayfield(cardId, move.previousPlayfieldIndex);
     _model->setCardFaceUp(cardId, true);
-    
-    // 从stock移除当前的tray card（如果它在stock中）
-    const int currentTrayCardId = _model->getTrayCardId();
-    if (currentTrayCardId >= 0)
-    {
-        auto& stockIds = _model->getStockCardIds();
-        auto iter = std::find(stockIds.begin(), stockIds.end(), currentTrayCardId);
-        if (iter != stockIds.end())
-        {
-            stockIds.erase(iter);
-        }
-    }
-    
-    // 恢复手牌区顶部牌
-    _model->setTrayCard(move.previousTrayCardId);
 
     // 执行回退动画：手牌区牌平移回桌面
-    _view->undoReplaceTrayCard(cardId, move.previousTrayCardId, true);
+    _events->publish(BoardEvent::cardRestored(cardId, move.previousTrayCardId, animated));
 
     // 恢复自动翻开的卡牌状态
     for (const CardFlipState& flip : move.flipStates)
     {
         _model->setCardFaceUp(flip.cardId, flip.previousFaceUp);
-        _view->flipCard(flip.cardId, flip.previousFaceUp);
+        _events->publish(BoardEvent::cardFlipped(flip.cardId, flip.previousFaceUp, animated));
     }
-
-    _view->refreshCardStates();
+    return true;
 }
 
 } // namespace tripeaks
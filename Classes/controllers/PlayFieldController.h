@@ -1,8 +1,8 @@
 #pragma once
 
+#include "managers/BoardEventBus.h"
 #include "managers/UndoManager.h"
 #include "models/GameModel.h"
-#include "views/GameView.h"
 
 namespace tripeaks
 {
@@ -10,14 +10,17 @@ namespace tripeaks
 class PlayFieldController
 {
 public:
-    void initialize(GameModel* model, GameView* view);
+    // 表现层通过事件通道订阅结果，控制器不直接调用视图，可在无界面时运行
+    void initialize(GameModel* model, BoardEventBus* events);
 
-    bool handleCardTap(int cardId, UndoMove& outMove);
-    void undoMatch(const UndoMove& move);
+    // animated为false时画面直接落到结果状态（输入积压时的中间步骤）
+    bool handleCardTap(int cardId, UndoMove& outMove, bool animated = true);
+    // 回退记录与牌桌不一致时不做修改并返回false
+    bool undoMatch(const UndoMove& move, bool animated = true);
 
 private:
     GameModel* _model = nullptr;
-    GameView* _view = nullptr;
+    BoardEventBus* _events = nullptr;
 };
 
 } // namespace tripeaks
@@ -0,0 +1,266 @@
+#include "controllers/RaceController.h"
+
+#include "services/SessionSerializer.h"
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+std::size_t countRemainingPlayfieldCards(const GameModel& model)
+{
+    return model.getPlayfieldCardIds().size();
+}
+
+} // namespace
+
+void RaceController::start(const LevelConfig& config, unsigned int seed, int localPlayer, Options options)
+{
+    _config = config;
+    _levelHash = SessionSerializer::computeLevelHash(config);
+    _seed = seed;
+    _localPlayer = localPlayer == 0 ? 0 : 1;
+    _options = options;
+    _connected = false;
+
+    for (Simulation* simulation : {&_confirmed, &_predicted})
+    {
+        simulation->tables[0].start(_config, _seed);
+        simulation->tables[1].start(_config, _seed);
+        simulation->result = RaceResult();
+    }
+    _inputs[0].clear();
+    _inputs[1].clear();
+    _tick = 0;
+    _confirmedTick = 0;
+    _remoteEnd = 0;
+    _peerAck = 0;
+    _rollbackCount = 0;
+}
+
+void RaceController::writeHello(std::vector<unsigned char>& outBytes) const
+{
+    RaceProtocol::Hello hello;
+    hello.levelHash = _levelHash;
+    hello.seed = _seed;
+    hello.player = static_cast<std::uint8_t>(_localPlayer);
+    hello.inputDelay = static_cast<std::uint8_t>(std::min<std::uint32_t>(_options.inputDelay, 0xFF));
+    RaceProtocol::appendHello(hello, outBytes);
+}
+
+void RaceController::queueLocalInput(const InputCommand& command)
+{
+    TimedInput input;
+    input.tick = _tick + _options.inputDelay;
+    input.command = command;
+    _inputs[_localPlayer].emplace_back(input);
+}
+
+bool RaceController::advanceTick()
+{
+    if (!_connected || _tick >= _remoteEnd + _options.maxPredictionTicks)
+    {
+        return false;
+    }
+
+    // 对方在这个 tick 的输入若尚未收到则预测为无输入
+    simulateTick(_predicted, _tick);
+    ++_tick;
+    advanceConfirmed(false);
+    return true;
+}
+
+void RaceController::writeInputs(std::vector<unsigned char>& outBytes)
+{
+    // 当前 tick + inputDelay 上仍可能追加本方输入，之前的 tick 已经确定
+    const std::uint32_t endTick = _tick + _options.inputDelay;
+    _sendBuffer.clear();
+    for (const TimedInput& input : _inputs[_localPlayer])
+    {
+        if (input.tick >= _peerAck && input.tick < endTick)
+        {
+            _sendBuffer.emplace_back(input);
+        }
+    }
+    RaceProtocol::appendInputs(_remoteEnd, _peerAck, endTick, _sendBuffer.data(), _sendBuffer.size(), outBytes);
+}
+
+bool RaceController::receiveFrame(const unsigned char* data, std::size_t size, std::string* errorMessage)
+{
+    RaceProtocol::FrameType type = RaceProtocol::FrameType::Inputs;
+    if (!RaceProtocol::readFrameType(data, size, type))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Unknown race frame";
+        }
+        return false;
+    }
+
+    if (type == RaceProtocol::FrameType::Hello)
+    {
+        RaceProtocol::Hello hello;
+        if (!RaceProtocol::decodeHello(data, size, hello))
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Malformed race hello";
+            }
+            return false;
+        }
+        if (hello.levelHash != _levelHash || hello.seed != _seed || hello.player != 1 - _localPlayer)
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Opponent is playing a different deal";
+            }
+            return false;
+        }
+        _connected = true;
+        return true;
+    }
+
+    if (!RaceProtocol::decodeInputs(data, size, _frame))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Malformed race inputs";
+        }
+        return false;
+    }
+    // 对方发出输入说明已收到本方的 Hello（Hello 丢失时也能开始）
+    _connected = true;
+
+    // 对方不可能确认本方尚未发出的 tick，超出的部分视为无效
+    _peerAck = std::max(_peerAck, std::min(_frame.ack, _tick + _options.inputDelay));
+
+    // 帧必须与已收到的部分相接（firstTick 为对方所知的本方确认位置，不会超过 _remoteEnd），较旧的帧没有新内容
+    if (_frame.firstTick > _remoteEnd || _frame.endTick <= _remoteEnd)
+    {
+        pruneInputs();
+        return true;
+    }
+
+    const int remotePlayer = 1 - _localPlayer;
+    bool mispredicted = false;
+    for (const TimedInput& input : _frame.inputs)
+    {
+        if (input.tick < _remoteEnd)
+        {
+            continue;
+        }
+        _inputs[remotePlayer].emplace_back(input);
+        // 已按"无输入"模拟过的 tick 上出现了输入
+        if (input.tick < _tick)
+        {
+            mispredicted = true;
+        }
+    }
+    _remoteEnd = _frame.endTick;
+    advanceConfirmed(mispredicted);
+    return true;
+}
+
+void RaceController::simulateTick(Simulation& simulation, std::uint32_t tick)
+{
+    // 玩家 0 先于玩家 1，两端顺序一致
+    for (int player = 0; player < 2; ++player)
+    {
+        if (simulation.result.outcome != RaceOutcome::Racing)
+        {
+            return;
+        }
+        const std::deque<TimedInput>& inputs = _inputs[player];
+        auto iter = std::lower_bound(inputs.begin(), inputs.end(), tick,
+                                     [](const TimedInput& input, std::uint32_t value) { return input.tick < value; });
+        for (; iter != inputs.end() && iter->tick == tick; ++iter)
+        {
+            simulation.tables[player].applyInput(iter->command);
+        }
+    }
+    updateResult(simulation, tick);
+}
+
+void RaceController::updateResult(Simulation& simulation, std::uint32_t tick) const
+{
+    if (simulation.result.outcome != RaceOutcome::Racing)
+    {
+        return;
+    }
+
+    const TableController& local = simulation.tables[_localPlayer];
+    const TableController& opponent = simulation.tables[1 - _localPlayer];
+    const bool localWon = local.getGameState() == GameState::Won;
+    const bool opponentWon = opponent.getGameState() == GameState::Won;
+    RaceOutcome outcome = RaceOutcome::Racing;
+    if (localWon || opponentWon)
+    {
+        outcome = localWon && opponentWon ? RaceOutcome::Draw : (localWon ? RaceOutcome::Won : RaceOutcome::Lost);
+    }
+    else if (local.getGameState() == GameState::Lost && opponent.getGameState() == GameState::Lost)
+    {
+        // 双方都无路可走：比较剩余的桌面牌
+        const std::size_t localRemaining = countRemainingPlayfieldCards(local.getModel());
+        const std::size_t opponentRemaining = countRemainingPlayfieldCards(opponent.getModel());
+        outcome = localRemaining == opponentRemaining
+                      ? RaceOutcome::Draw
+                      : (localRemaining < opponentRemaining ? RaceOutcome::Won : RaceOutcome::Lost);
+    }
+
+    if (outcome != RaceOutcome::Racing)
+    {
+        simulation.result.outcome = outcome;
+        simulation.result.tick = tick;
+    }
+}
+
+void RaceController::advanceConfirmed(bool mispredicted)
+{
+    // 本方在 _tick 之前的输入都已确定，对方在 _remoteEnd 之前的输入都已收到
+    const std::uint32_t confirmedEnd = std::min(_tick, _remoteEnd);
+    while (_confirmedTick < confirmedEnd)
+    {
+        simulateTick(_confirmed, _confirmedTick);
+        ++_confirmedTick;
+    }
+
+    if (mispredicted)
+    {
+        TRIPEAKS_TRACE_SCOPE_ARG("race", "rollback", "ticks", _tick - _confirmedTick);
+        // 预测局面回到已确认局面，再用已知的输入重放到当前 tick
+        for (int player = 0; player < 2; ++player)
+        {
+            _confirmed.tables[player].save(_levelHash, _snapshot);
+            _predicted.tables[player].restore(_snapshot, _levelHash);
+        }
+        _predicted.result = _confirmed.result;
+        for (std::uint32_t tick = _confirmedTick; tick < _tick; ++tick)
+        {
+            simulateTick(_predicted, tick);
+        }
+        ++_rollbackCount;
+    }
+    pruneInputs();
+}
+
+void RaceController::pruneInputs()
+{
+    // 已确认的 tick 不会再重放；本方输入还要保留到对方确认，以便重发
+    std::deque<TimedInput>& local = _inputs[_localPlayer];
+    const std::uint32_t localKeep = std::min(_confirmedTick, _peerAck);
+    while (!local.empty() && local.front().tick < localKeep)
+    {
+        local.pop_front();
+    }
+    std::deque<TimedInput>& remote = _inputs[1 - _localPlayer];
+    while (!remote.empty() && remote.front().tick < _confirmedTick)
+    {
+        remote.pop_front();
+    }
+}
+
+} // namespace tripeaks
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "configs/models/LevelConfig.h"
+#include "controllers/TableController.h"
+#include "services/RaceProtocol.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace tripeaks
+{
+
+// 从本方视角看的竞速结果
+enum class RaceOutcome
+{
+    Racing,
+    Won,
+    Lost,
+    Draw
+};
+
+struct RaceResult
+{
+    RaceOutcome outcome = RaceOutcome::Racing;
+    std::uint32_t tick = 0;         // 结果产生的 tick
+};
+
+/**
+ * 双人竞速的确定性同步：两名玩家用同一关卡与种子开局，在共同的 tick 时间线上各自走牌，先清空桌面者获胜
+ * （同一 tick 同时清空为平局；双方都无路可走时剩余桌面牌少者获胜）。比赛结束后双方的输入都不再生效。
+ * 输入延迟锁步：本方输入排在当前 tick + inputDelay 执行，延迟不小于单程网络延迟时对方总能按时收到，无需回滚。
+ * 预测与回滚：对方尚未确认的 tick 预测为"无输入"，时间线照常前进；迟到的输入落在已模拟的 tick 上时，
+ * 从已确认局面的快照（TableController::save，即 GameModel 快照）恢复预测局面，再重放到当前 tick。
+ * 已确认局面只在双方输入都已知的 tick 上推进，两端结果一致；预测局面用于显示。
+ * 同一实例只能由一个线程使用；收发由调用方负责（见 RaceProtocol）。
+ */
+class RaceController
+{
+public:
+    struct Options
+    {
+        std::uint32_t inputDelay = 4;           // 本方输入延后执行的 tick 数
+        std::uint32_t maxPredictionTicks = 180; // 领先对方已确认的 tick 超过此数时暂停前进，限制回滚深度
+    };
+
+    RaceController() = default;
+
+    RaceController(const RaceController&) = delete;
+    RaceController& operator=(const RaceController&) = delete;
+
+    // 双方用相同的关卡配置与种子开局；localPlayer 为 0 或 1，决定同一 tick 内两方输入的执行顺序
+    void start(const LevelConfig& config, unsigned int seed, int localPlayer, Options options);
+
+    // 握手：收到对方匹配的 Hello 之前不前进，调用方应定期发送 Hello
+    void writeHello(std::vector<unsigned char>& outBytes) const;
+    bool isConnected() const { return _connected; }
+
+    // 本方一条已在自己牌桌上生效的输入，排到 tick + inputDelay
+    void queueLocalInput(const InputCommand& command);
+
+    // 前进一个 tick；未连接或领先过多时返回false
+    bool advanceTick();
+
+    // 对方尚未确认的本方输入（每帧重发），以及本方已确认到的对方 tick
+    void writeInputs(std::vector<unsigned char>& outBytes);
+
+    /**
+     * 处理对方的一帧（Hello 或 Inputs）；重复、过期、乱序的帧直接忽略
+     * @return 帧无法解析或 Hello 与本局不匹配时返回false
+     */
+    bool receiveFrame(const unsigned char* data, std::size_t size, std::string* errorMessage = nullptr);
+
+    std::uint32_t getTick() const { return _tick; }
+    // 双方输入都已确定的 tick 数，之前的局面两端一致
+    std::uint32_t getConfirmedTick() const { return _confirmedTick; }
+    // 对方已收到本方输入的 tick 数
+    std::uint32_t getPeerAckTick() const { return _peerAck; }
+    std::uint32_t getRollbackCount() const { return _rollbackCount; }
+
+    // 预测结果即时可见，但可能被迟到的输入推翻；确认结果之后不再改变
+    const RaceResult& getPredictedResult() const { return _predicted.result; }
+    const RaceResult& getConfirmedResult() const { return _confirmed.result; }
+
+    // 预测局面，用于显示（对手的小棋盘）
+    const TableController& getLocalTable() const { return _predicted.tables[_localPlayer]; }
+    const TableController& getOpponentTable() const { return _predicted.tables[1 - _localPlayer]; }
+    const TableController& getConfirmedTable(int player) const { return _confirmed.tables[player]; }
+
+private:
+    struct Simulation
+    {
+        TableController tables[2];
+        RaceResult result;          // 本方视角
+    };
+
+    using TimedInput = RaceProtocol::TimedInput;
+
+    void simulateTick(Simulation& simulation, std::uint32_t tick);
+    void updateResult(Simulation& simulation, std::uint32_t tick) const;
+    // 对方确认的范围扩大后推进已确认局面；预测有误时从已确认局面回滚并重放到当前 tick
+    void advanceConfirmed(bool mispredicted);
+    void pruneInputs();
+
+    LevelConfig _config;
+    std::uint64_t _levelHash = 0;
+    unsigned int _seed = 0;
+    int _localPlayer = 0;
+    Options _options;
+    bool _connected = false;
+
+    Simulation _confirmed;
+    Simulation _predicted;
+    std::deque<TimedInput> _inputs[2];      // 按 tick 排列；本方保留到对方确认，对方保留到本方确认
+    std::uint32_t _tick = 0;                // 预测局面已模拟的 tick 数
+    std::uint32_t _confirmedTick = 0;       // 已确认局面已模拟的 tick 数
+    std::uint32_t _remoteEnd = 0;           // 对方输入已完整收到的 tick 数
+    std::uint32_t _peerAck = 0;
+    std::uint32_t _rollbackCount = 0;
+
+    RaceProtocol::Inputs _frame;            // 解码复用
+    std::vector<TimedInput> _sendBuffer;    // 编码复用
+    std::vector<unsigned char> _snapshot;   // 回滚复用
+};
+
+} // namespace tripeaks
@@ -3,22 +3,27 @@
 namespace tripeaks
 {
 
-void StackController::initialize(GameModel* model, GameView* view)
+void StackController::initialize(GameModel* model, BoardEventBus* events)
 {
     _model = model;
-    _view = view;
+    _events = events;
 }
 
-bool StackController::handleStockTap(UndoMove& outMove)
+bool StackController::handleStockTap(UndoMove& outMove, bool animated)
 {
-    if (!_model || !_view)
+    if (!_model || !_events)
     {
         return false;
     }
 
     if (_model->getStockCardIds().empty())
     {
-        _view->showStatusMessage("Stock is empty");
+        // 允许翻回时，点击空的备用牌堆把弃牌堆翻回
+        if (_model->canRecycleWaste())
+        {
+            return recycleWaste(outMove);
+        }
+        _events->publish(BoardEvent::statusMessage("Stock is empty"));
         return false;
     }
 
@@ -36,50 +41,84 @@ bool StackController::handleStockTap(UndoMove& outMove)
     outMove.previousTrayCardId = previousTrayCardId;
     outMove.previousStockIndex = stockIndex;
 
-    // 替换手牌区顶部牌
+    // 替换手牌区顶部牌，旧的tray card压入弃牌堆
     _model->setCardFaceUp(cardId, true);
     _model->replaceTrayCard(cardId);
 
-    // 执行动画：stock牌平移到手牌区替换顶部牌
-    _view->replaceTrayCardWithStockCard(cardId, previousTrayCardId, true);
-
-    _view->layoutStock();
-    _view->refreshCardStates();
+    // 执行动画：stock牌平移到手牌区，盖住旧的顶部牌
+    _events->publish(BoardEvent::trayChanged(BoardEvent::TraySource::Draw, cardId, previousTrayCardId, -1, animated));
+    _events->publish(BoardEvent::stockChanged());
 
     return true;
 }
 
-void StackController::undoDraw(const UndoMove& move)
+bool StackController::undoDraw(const UndoMove& move, bool animated)
 {
-    if (!_model || !_view)
+    if (!_model || !_events)
     {
-        return;
+        return false;
     }
 
     if (move.type != UndoMove::Type::ReplaceTrayFromStock)
     {
-        return;
+        return false;
     }
 
     const int cardId = move.movedCardId;
     
-    // 恢复手牌区顶部牌
-    _model->setTrayCard(move.previousTrayCardId);
+    // 弃牌堆顶部牌回到手牌区
+    if (!_model->restorePreviousTrayCard(move.previousTrayCardId))
+    {
+        return false;
+    }
     
     // 恢复stock牌
     _model->setCardFaceUp(cardId, false);
     _model->returnCardToStock(cardId);
 
     // 执行回退动画：手牌区牌平移回stock
-    _view->undoReplaceTrayCardFromStock(cardId, move.previousTrayCardId, move.previousStockIndex, true);
+    _events->publish(BoardEvent::trayChanged(BoardEvent::TraySource::UndoDraw, cardId, move.previousTrayCardId,
+                                             move.previousStockIndex, animated));
+    _events->publish(BoardEvent::stockChanged());
+    return true;
+}
+
+void StackController::undoRecycle(const UndoMove& move)
+{
+    if (!_model || !_events)
+    {
+        return;
+    }
+
+    if (move.type != UndoMove::Type::RecycleWaste)
+    {
+        return;
+    }
+
+    _model->restoreWasteFromStock();
+    _events->publish(BoardEvent::wasteRestored());
+    _events->publish(BoardEvent::stockChanged());
+}
 
-    _view->layoutStock();
-    _view->refreshCardStates();
+bool StackController::recycleWaste(UndoMove& outMove)
+{
+    // 翻回只改变备用牌堆与弃牌堆，手牌区顶部牌保持不变
+    outMove = UndoMove{};
+    outMove.type = UndoMove::Type::RecycleWaste;
+    outMove.previousTrayCardId = _model->getTrayCardId();
+
+    if (_model->recycleWasteToStock() == 0)
+    {
+        return false;
+    }
+    _events->publish(BoardEvent::wasteRecycled());
+    _events->publish(BoardEvent::stockChanged());
+    return true;
 }
 
 bool StackController::drawInitialCard()
 {
-    if (!_model || !_view)
+    if (!_model || !_events)
     {
         return false;
     }
@@ -93,9 +132,8 @@ bool StackController::drawInitialCard()
     _model->setCardFaceUp(cardId, true);
     _model->setTrayCard(cardId);
 
-    _view->layoutStock();
-    _view->placeInitialTrayCard(cardId);
-    _view->refreshCardStates();
+    _events->publish(BoardEvent::stockChanged());
+    _events->publish(BoardEvent::trayChanged(BoardEvent::TraySource::Initial, cardId, -1, -1, false));
 
     return true;
 }
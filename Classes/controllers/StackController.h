@@ -1,8 +1,8 @@
 #pragma once
 
+#include "managers/BoardEventBus.h"
 #include "managers/UndoManager.h"
 #include "models/GameModel.h"
-#include "views/GameView.h"
 
 namespace tripeaks
 {
@@ -10,16 +10,21 @@ namespace tripeaks
 class StackController
 {
 public:
-    void initialize(GameModel* model, GameView* view);
+    void initialize(GameModel* model, BoardEventBus* events);
 
-    bool handleStockTap(UndoMove& outMove);
-    void undoDraw(const UndoMove& move);
+    bool handleStockTap(UndoMove& outMove, bool animated = true);
+    // 回退记录与牌桌不一致时不做修改并返回false
+    bool undoDraw(const UndoMove& move, bool animated = true);
+    // 翻回整堆在画面上直接落到结果状态，没有逐张动画
+    void undoRecycle(const UndoMove& move);
 
     bool drawInitialCard();
 
 private:
+    bool recycleWaste(UndoMove& outMove);
+
     GameModel* _model = nullptr;
-    GameView* _view = nullptr;
+    BoardEventBus* _events = nullptr;
 };
 
 } // namespace tripeaks
@@ -0,0 +1,134 @@
+#include "controllers/TableController.h"
+
+#include "controllers/InputRules.h"
+#include "services/GameModelFromLevelGenerator.h"
+#include "services/SessionSerializer.h"
+
+#include <utility>
+
+namespace tripeaks
+{
+
+TableController::TableController()
+{
+    _playfieldController.initialize(&_model, &_events);
+    _stackController.initialize(&_model, &_events);
+    _outcomeOptions.outcomeMaxNodes = 0;
+}
+
+void TableController::start(const LevelConfig& config, unsigned int seed)
+{
+    GameModelFromLevelGenerator::generateFromConfig(config, seed, _model);
+    _undoManager.clear();
+    _stackController.drawInitialCard();
+    _undoManager.clear();
+
+    _model.takeChanges(_boardChanges);
+    _events.clear();
+    _deadEndDetector.rebuild(_model);
+    _gameState = GameState::Playing;
+    _outcomeChecked = false;
+    _provenUnwinnable = false;
+    commitChanges();
+}
+
+bool TableController::restore(const std::vector<unsigned char>& snapshot, std::uint64_t levelHash)
+{
+    std::vector<UndoMove> undoMoves;
+    std::uint64_t sequence = 0;
+    if (!SessionSerializer::readSnapshot(snapshot, levelHash, _model, undoMoves, sequence))
+    {
+        return false;
+    }
+
+    _undoManager.assign(std::move(undoMoves));
+    _model.takeChanges(_boardChanges);
+    _events.clear();
+    _deadEndDetector.rebuild(_model);
+    _gameState = GameState::Playing;
+    _outcomeChecked = false;
+    _provenUnwinnable = false;
+    commitChanges();
+    return true;
+}
+
+void TableController::save(std::uint64_t levelHash, std::vector<unsigned char>& outBytes) const
+{
+    SessionSerializer::writeSnapshot(_model, _undoManager.getMoves(), levelHash, 0, outBytes);
+}
+
+bool TableController::applyInput(const InputCommand& command)
+{
+    const bool applied = InputRules::apply(command, _gameState, false, _playfieldController, _stackController,
+                                           _undoManager, _events);
+    if (applied && command.type == InputCommand::Type::Undo)
+    {
+        // 回退后的局面可能重新有胜算，下次 checkOutcome 重新判定
+        _provenUnwinnable = false;
+    }
+    commitChanges();
+    return applied;
+}
+
+std::size_t TableController::applyInputs(const InputCommand* commands, std::size_t count)
+{
+    std::size_t applied = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (applyInput(commands[index]))
+        {
+            ++applied;
+        }
+    }
+    return applied;
+}
+
+GameState TableController::checkOutcome()
+{
+    if (_outcomeOptions.outcomeMaxNodes == 0 || _gameState != GameState::Playing)
+    {
+        return _gameState;
+    }
+
+    const std::uint64_t stateHash = computeStateHash();
+    if (_outcomeChecked && stateHash == _outcomeHash)
+    {
+        return _gameState;
+    }
+    _outcomeChecked = true;
+    _outcomeHash = stateHash;
+
+    if (HintSearchService::analyzeOutcome(_model, _outcomeOptions, nullptr) == HintSearchService::Outcome::Unwinnable)
+    {
+        _provenUnwinnable = true;
+        _gameState = GameState::Lost;
+    }
+    return _gameState;
+}
+
+std::uint64_t TableController::computeStateHash() const
+{
+    return HintSearchService::computeStateHash(_model);
+}
+
+void TableController::commitChanges()
+{
+    _model.takeChanges(_boardChanges);
+    _deadEndDetector.applyChanges(_model, _boardChanges);
+
+    if (_model.isVictory())
+    {
+        _gameState = GameState::Won;
+    }
+    else if (_deadEndDetector.isDeadEnd(_model) || _provenUnwinnable)
+    {
+        _gameState = GameState::Lost;
+    }
+    else
+    {
+        _gameState = GameState::Playing;
+    }
+    _events.dispatch();
+}
+
+} // namespace tripeaks
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "controllers/PlayFieldController.h"
+#include "controllers/StackController.h"
+#include "managers/BoardEventBus.h"
+#include "managers/DeadEndDetector.h"
+#include "managers/UndoManager.h"
+#include "models/InputCommand.h"
+#include "services/HintSearchService.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 无界面的一桌游戏：模型、回退栈、桌面/手牌两个子控制器与死局判定，可选有预算的胜负判定。
+ * 与 GameController 共用同一套输入规则（InputRules），但没有视图、提示线程、动画与存档，
+ * 供会话管理器、服务端与对战同步在任意线程上批量驱动；同一实例只能由一个线程使用。
+ * 牌桌事件照常发布，没有订阅者时每步结束即清空。
+ */
+class TableController
+{
+public:
+    TableController();
+
+    TableController(const TableController&) = delete;
+    TableController& operator=(const TableController&) = delete;
+
+    // 以关卡配置和种子开局，配置中未指定点数花色的牌由种子决定；模型与各缓冲区的容量在多局之间复用
+    void start(const LevelConfig& config, unsigned int seed);
+
+    // 在同一关卡配置 start 之后套用快照；快照属于其他关卡或已损坏时返回false
+    bool restore(const std::vector<unsigned char>& snapshot, std::uint64_t levelHash);
+    void save(std::uint64_t levelHash, std::vector<unsigned char>& outBytes) const;
+
+    // 应用一条输入，返回是否生效；一局结束后只接受回退
+    bool applyInput(const InputCommand& command);
+    // 依次应用一批输入，返回生效的条数
+    std::size_t applyInputs(const InputCommand* commands, std::size_t count);
+
+    // checkOutcome 的节点预算，0（默认）表示只做死局判定
+    void setOutcomeBudget(std::size_t maxNodes) { _outcomeOptions.outcomeMaxNodes = maxNodes; }
+    /**
+     * 在本线程上对当前局面做有预算的胜负判定（HintSearchService::analyzeOutcome），
+     * 证明无法取胜时判负并保持到回退或重新开局；局面与上次判定相同时不再重复搜索。
+     * 开销远大于 applyInput，应在一批输入之后调用一次
+     * @return 判定后的状态
+     */
+    GameState checkOutcome();
+
+    GameState getGameState() const { return _gameState; }
+    std::uint64_t computeStateHash() const;
+    std::size_t getMoveCount() const { return _undoManager.getMoves().size(); }
+
+    const GameModel& getModel() const { return _model; }
+    BoardEventBus& getEvents() { return _events; }
+
+private:
+    void commitChanges();
+
+    GameModel _model;
+    BoardChangeSet _boardChanges;
+    BoardEventBus _events;
+    UndoManager _undoManager;
+    PlayFieldController _playfieldController;
+    StackController _stackController;
+    DeadEndDetector _deadEndDetector;
+    HintSearchService::Options _outcomeOptions;
+    std::uint64_t _outcomeHash = 0;     // 上次胜负判定的局面
+    bool _outcomeChecked = false;
+    bool _provenUnwinnable = false;
+    GameState _gameState = GameState::Playing;
+};
+
+} // namespace tripeaks
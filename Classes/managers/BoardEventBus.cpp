@@ -0,0 +1,66 @@
+#include "managers/BoardEventBus.h"
+
+#include <algorithm>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+// 一次输入最多产生十余个事件，一帧内积压的输入也很少超过这个数量
+constexpr std::size_t kInitialCapacity = 128;
+
+} // namespace
+
+BoardEventBus::BoardEventBus()
+{
+    _pending.reserve(kInitialCapacity);
+    _dispatching.reserve(kInitialCapacity);
+}
+
+void BoardEventBus::subscribe(BoardEventListener* listener)
+{
+    if (listener && std::find(_listeners.begin(), _listeners.end(), listener) == _listeners.end())
+    {
+        _listeners.emplace_back(listener);
+    }
+}
+
+void BoardEventBus::unsubscribe(BoardEventListener* listener)
+{
+    _listeners.erase(std::remove(_listeners.begin(), _listeners.end(), listener), _listeners.end());
+}
+
+void BoardEventBus::publish(const BoardEvent& event)
+{
+    _pending.emplace_back(event);
+}
+
+void BoardEventBus::dispatch()
+{
+    // 派发中再次调用时直接返回，新发布的事件留到下一批
+    if (_pending.empty() || !_dispatching.empty())
+    {
+        return;
+    }
+
+    _dispatching.swap(_pending);
+    for (std::size_t index = 0; index < _listeners.size(); ++index)
+    {
+        _listeners[index]->onBoardEvents(_dispatching.data(), _dispatching.size());
+    }
+    _dispatching.clear();
+}
+
+void BoardEventBus::clear()
+{
+    _pending.clear();
+}
+
+void BoardEventRecorder::onBoardEvents(const BoardEvent* events, std::size_t count)
+{
+    _events.insert(_events.end(), events, events + count);
+}
+
+} // namespace tripeaks
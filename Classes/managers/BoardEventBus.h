@@ -0,0 +1,74 @@
+#pragma once
+
+#include "models/BoardEvent.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 牌桌事件的订阅者，每次派发收到一整批按发布顺序排列的事件
+ */
+class BoardEventListener
+{
+public:
+    virtual ~BoardEventListener() = default;
+    virtual void onBoardEvents(const BoardEvent* events, std::size_t count) = 0;
+};
+
+/**
+ * 牌桌事件通道。
+ * 控制器发布事件只追加到预留容量的缓冲区；dispatch 时把本轮累积的事件整批交给所有订阅者。
+ * 两个缓冲区交替使用并保留容量，稳态下发布与派发都不分配内存；
+ * 订阅者在派发过程中发布的事件进入下一批。没有订阅者时（无界面模拟）dispatch 只清空缓冲区。
+ * 由 GameController 持有，非单例。
+ */
+class BoardEventBus
+{
+public:
+    BoardEventBus();
+
+    void subscribe(BoardEventListener* listener);
+    void unsubscribe(BoardEventListener* listener);
+
+    void publish(const BoardEvent& event);
+    void dispatch();
+
+    // 丢弃尚未派发的事件（如重新开局）
+    void clear();
+
+    std::size_t getPendingCount() const { return _pending.size(); }
+
+private:
+    std::vector<BoardEvent> _pending;
+    std::vector<BoardEvent> _dispatching;
+    std::vector<BoardEventListener*> _listeners;
+};
+
+/**
+ * 不做任何处理的订阅者，用于只需要事件计数或占位的场合
+ */
+class NullBoardEventListener : public BoardEventListener
+{
+public:
+    void onBoardEvents(const BoardEvent* /*events*/, std::size_t /*count*/) override {}
+};
+
+/**
+ * 把收到的事件追加到列表中，供回放、分析统计或无界面模拟检查结果使用
+ */
+class BoardEventRecorder : public BoardEventListener
+{
+public:
+    void onBoardEvents(const BoardEvent* events, std::size_t count) override;
+
+    const std::vector<BoardEvent>& getEvents() const { return _events; }
+    void clear() { _events.clear(); }
+
+private:
+    std::vector<BoardEvent> _events;
+};
+
+} // namespace tripeaks
@@ -0,0 +1,80 @@
+#include "managers/DeadEndDetector.h"
+
+namespace tripeaks
+{
+
+namespace
+{
+
+bool isPlayable(const GameModel& model, const Card& card)
+{
+    return card.isInPlayfield && !card.removed && card.faceUp && model.isCardExposed(card.id);
+}
+
+} // namespace
+
+void DeadEndDetector::rebuild(const GameModel& model)
+{
+    const std::vector<Card>& cards = model.getCards();
+    _playable.assign(cards.size(), 0);
+    _playableByKind.fill(0);
+    _playableKinds = 0;
+    _playableCount = 0;
+    for (const Card& card : cards)
+    {
+        updateCard(model, card.id);
+    }
+}
+
+void DeadEndDetector::applyChanges(const GameModel& model, const BoardChangeSet& changes)
+{
+    for (int cardId : changes.cardIds)
+    {
+        updateCard(model, cardId);
+    }
+}
+
+bool DeadEndDetector::hasMatchFor(const MatchTable& table, const Card& trayCard) const
+{
+    return (table.matchMask(toCardKind(trayCard.face, trayCard.suit)) & _playableKinds) != 0;
+}
+
+bool DeadEndDetector::isDeadEnd(const GameModel& model) const
+{
+    if (!model.getStockCardIds().empty() || model.canRecycleWaste() || model.isVictory())
+    {
+        return false;
+    }
+    const Card* trayCard = model.getCardById(model.getTrayCardId());
+    return !trayCard || !hasMatchFor(model.getMatchTable(), *trayCard);
+}
+
+void DeadEndDetector::updateCard(const GameModel& model, int cardId)
+{
+    const Card* card = model.getCardById(cardId);
+    if (!card || cardId < 0 || cardId >= static_cast<int>(_playable.size()))
+    {
+        return;
+    }
+
+    const unsigned char playable = isPlayable(model, *card) ? 1 : 0;
+    if (playable == _playable[cardId])
+    {
+        return;
+    }
+    _playable[cardId] = playable;
+    const int delta = playable ? 1 : -1;
+    const int kind = toCardKind(card->face, card->suit);
+    _playableByKind[kind] += delta;
+    if (_playableByKind[kind] > 0)
+    {
+        _playableKinds |= std::uint64_t(1) << kind;
+    }
+    else
+    {
+        _playableKinds &= ~(std::uint64_t(1) << kind);
+    }
+    _playableCount += delta;
+}
+
+} // namespace tripeaks
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "models/BoardChangeSet.h"
+#include "models/GameModel.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 增量判定死局：备用牌堆已空且弃牌堆不能再翻回，且没有可与手牌区顶部牌配对的桌面牌。
+ * 按牌种（点数+花色）统计当前可点击（已翻开且未被覆盖）的桌面牌数量，每步只根据模型给出的 BoardChangeSet
+ * 更新其中列出的卡牌；判定时用配对规则表中手牌所在行与可点击牌种的位掩码求与，不随桌面牌数量增长。
+ */
+class DeadEndDetector
+{
+public:
+    // 全量重建统计，开局时调用
+    void rebuild(const GameModel& model);
+    // 根据一步或一批操作的增量变化更新统计
+    void applyChanges(const GameModel& model, const BoardChangeSet& changes);
+
+    bool hasMatchFor(const MatchTable& table, const Card& trayCard) const;
+    bool isDeadEnd(const GameModel& model) const;
+
+    int getPlayableCount() const { return _playableCount; }
+
+private:
+    void updateCard(const GameModel& model, int cardId);
+
+    std::vector<unsigned char> _playable;     // 按cardId索引
+    std::array<int, kCardKindCount> _playableByKind{};
+    std::uint64_t _playableKinds = 0;         // 可点击数量大于0的牌种位掩码
+    int _playableCount = 0;
+};
+
+} // namespace tripeaks
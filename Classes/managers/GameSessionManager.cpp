@@ -0,0 +1,325 @@
+#include "managers/GameSessionManager.h"
+
+#include "services/SessionSerializer.h"
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tripeaks
+{
+
+GameSessionManager::GameSessionManager() : GameSessionManager(Options())
+{
+}
+
+GameSessionManager::GameSessionManager(Options options) : _options(options)
+{
+    std::size_t shardCount = _options.shardCount;
+    if (shardCount == 0)
+    {
+        shardCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    _options.activeTablesPerShard = std::max<std::size_t>(1, _options.activeTablesPerShard);
+
+    _shards.reserve(shardCount);
+    for (std::size_t index = 0; index < shardCount; ++index)
+    {
+        _shards.emplace_back(new Shard());
+        Shard& shard = *_shards.back();
+        shard.tables.reserve(_options.activeTablesPerShard);
+        shard.freeTables.reserve(_options.activeTablesPerShard);
+        shard.activeSessions.reserve(_options.activeTablesPerShard);
+        shard.worker = std::thread([this, &shard]() { workerLoop(shard); });
+    }
+}
+
+GameSessionManager::~GameSessionManager()
+{
+    for (auto& shard : _shards)
+    {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->quit = true;
+        }
+        shard->condition.notify_one();
+    }
+    for (auto& shard : _shards)
+    {
+        if (shard->worker.joinable())
+        {
+            shard->worker.join();
+        }
+    }
+}
+
+GameSessionManager::LevelId GameSessionManager::addLevel(const LevelConfig& config)
+{
+    auto level = std::make_shared<Level>();
+    level->config = config;
+    level->hash = SessionSerializer::computeLevelHash(config);
+
+    std::lock_guard<std::mutex> lock(_levelMutex);
+    _levels.emplace_back(std::move(level));
+    return static_cast<LevelId>(_levels.size() - 1);
+}
+
+GameSessionManager::SessionId GameSessionManager::createSession(LevelId level, unsigned int seed,
+                                                                const Completion& completion)
+{
+    Operation operation;
+    {
+        std::lock_guard<std::mutex> lock(_levelMutex);
+        if (level >= _levels.size())
+        {
+            return kInvalidSession;
+        }
+        operation.level = _levels[level];
+    }
+
+    SessionId session = _nextSession.fetch_add(1);
+    if (session == kInvalidSession)
+    {
+        session = _nextSession.fetch_add(1);
+    }
+    operation.kind = Operation::Kind::Create;
+    operation.seed = seed;
+    operation.completion = completion;
+    post(session, std::move(operation));
+    return session;
+}
+
+void GameSessionManager::destroySession(SessionId session, const Completion& completion)
+{
+    Operation operation;
+    operation.kind = Operation::Kind::Destroy;
+    operation.completion = completion;
+    post(session, std::move(operation));
+}
+
+void GameSessionManager::submit(SessionId session, std::vector<InputCommand> commands, const Completion& completion)
+{
+    Operation operation;
+    operation.kind = Operation::Kind::Apply;
+    operation.commands = std::move(commands);
+    operation.completion = completion;
+    post(session, std::move(operation));
+}
+
+GameSessionManager::SessionState GameSessionManager::query(SessionId session)
+{
+    // 不能在分片的工作线程中调用，否则会等待自己
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool done = false;
+    SessionState result;
+    submit(session, std::vector<InputCommand>(), [&](const SessionState& state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = state;
+        done = true;
+        condition.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&done]() { return done; });
+    return result;
+}
+
+void GameSessionManager::waitIdle()
+{
+    for (auto& shard : _shards)
+    {
+        std::unique_lock<std::mutex> lock(shard->mutex);
+        shard->idleCondition.wait(lock, [&shard]() { return shard->operations.empty() && !shard->processing; });
+    }
+}
+
+void GameSessionManager::post(SessionId session, Operation operation)
+{
+    operation.session = session;
+    Shard& shard = getShard(session);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.operations.emplace_back(std::move(operation));
+    }
+    shard.condition.notify_one();
+}
+
+void GameSessionManager::workerLoop(Shard& shard)
+{
+    std::vector<Operation> batch;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.processing = false;
+            if (shard.operations.empty())
+            {
+                shard.idleCondition.notify_all();
+            }
+            shard.condition.wait(lock, [&shard]() { return shard.quit || !shard.operations.empty(); });
+            if (shard.operations.empty())
+            {
+                return;
+            }
+            // 一次取走全部待处理的操作，处理期间提交的操作进入下一轮
+            batch.swap(shard.operations);
+            shard.processing = true;
+        }
+
+        TRIPEAKS_TRACE_SCOPE_ARG("sessions", "shardBatch", "operations", batch.size());
+        for (Operation& operation : batch)
+        {
+            execute(shard, operation);
+        }
+        batch.clear();
+    }
+}
+
+void GameSessionManager::execute(Shard& shard, Operation& operation)
+{
+    SessionState state;
+    state.session = operation.session;
+
+    switch (operation.kind)
+    {
+    case Operation::Kind::Create:
+    {
+        Session& session = shard.sessions[operation.session];
+        session.level = std::move(operation.level);
+        session.seed = operation.seed;
+        activate(shard, operation.session, session);
+        fillState(operation.session, session, state);
+        break;
+    }
+    case Operation::Kind::Apply:
+    {
+        const auto iter = shard.sessions.find(operation.session);
+        if (iter == shard.sessions.end())
+        {
+            break;
+        }
+        TableController* table = activate(shard, operation.session, iter->second);
+        if (table)
+        {
+            state.applied = table->applyInputs(operation.commands.data(), operation.commands.size());
+            table->checkOutcome();
+        }
+        fillState(operation.session, iter->second, state);
+        break;
+    }
+    case Operation::Kind::Destroy:
+    {
+        const auto iter = shard.sessions.find(operation.session);
+        if (iter == shard.sessions.end())
+        {
+            break;
+        }
+        if (iter->second.table)
+        {
+            shard.freeTables.emplace_back(iter->second.table);
+            shard.activeSessions.erase(
+                std::remove(shard.activeSessions.begin(), shard.activeSessions.end(), operation.session),
+                shard.activeSessions.end());
+        }
+        shard.sessions.erase(iter);
+        state.found = true;
+        break;
+    }
+    }
+
+    if (operation.completion)
+    {
+        operation.completion(state);
+    }
+}
+
+TableController* GameSessionManager::activate(Shard& shard, SessionId id, Session& session)
+{
+    session.lastUse = ++shard.clock;
+    if (session.table)
+    {
+        return session.table;
+    }
+
+    if (shard.freeTables.empty())
+    {
+        if (shard.tables.size() < _options.activeTablesPerShard)
+        {
+            shard.tables.emplace_back(new TableController());
+            shard.tables.back()->setOutcomeBudget(_options.outcomeMaxNodes);
+            shard.freeTables.emplace_back(shard.tables.back().get());
+        }
+        else
+        {
+            // 牌桌全部在用：休眠最久未使用的会话，活跃会话数量有上限，线性查找即可
+            SessionId oldest = kInvalidSession;
+            std::uint64_t oldestUse = 0;
+            for (SessionId candidate : shard.activeSessions)
+            {
+                const std::uint64_t lastUse = shard.sessions.at(candidate).lastUse;
+                if (oldest == kInvalidSession || lastUse < oldestUse)
+                {
+                    oldest = candidate;
+                    oldestUse = lastUse;
+                }
+            }
+            if (oldest == kInvalidSession)
+            {
+                return nullptr;
+            }
+            hibernate(shard, oldest);
+        }
+    }
+
+    TableController* table = shard.freeTables.back();
+    shard.freeTables.pop_back();
+
+    table->start(session.level->config, session.seed);
+    if (!session.snapshot.empty() && !table->restore(session.snapshot, session.level->hash))
+    {
+        // 快照与共享布局不一致（不应发生），从开局状态继续
+        table->start(session.level->config, session.seed);
+    }
+    std::vector<unsigned char>().swap(session.snapshot);
+
+    session.table = table;
+    shard.activeSessions.emplace_back(id);
+    return table;
+}
+
+void GameSessionManager::hibernate(Shard& shard, SessionId id)
+{
+    Session& session = shard.sessions.at(id);
+    TableController* table = session.table;
+    if (!table)
+    {
+        return;
+    }
+
+    // 没有走过（或已全部回退）的会话与开局状态相同，只需关卡与种子即可重建
+    if (table->getMoveCount() > 0)
+    {
+        table->save(session.level->hash, session.snapshot);
+        session.snapshot.shrink_to_fit();
+    }
+
+    session.table = nullptr;
+    shard.freeTables.emplace_back(table);
+    shard.activeSessions.erase(std::remove(shard.activeSessions.begin(), shard.activeSessions.end(), id),
+                               shard.activeSessions.end());
+}
+
+void GameSessionManager::fillState(SessionId id, const Session& session, SessionState& outState)
+{
+    outState.session = id;
+    outState.found = true;
+    if (session.table)
+    {
+        outState.moveCount = session.table->getMoveCount();
+        outState.gameState = session.table->getGameState();
+        outState.stateHash = session.table->computeStateHash();
+    }
+}
+
+} // namespace tripeaks
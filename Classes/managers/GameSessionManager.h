@@ -0,0 +1,152 @@
+#pragma once
+
+#include "configs/models/LevelConfig.h"
+#include "controllers/TableController.h"
+#include "models/InputCommand.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 在同一进程中同时运行多桌互相独立的游戏（锦标赛、无界面服务端）。
+ * 关卡配置注册一次后只读，所有会话共享同一份布局；每个会话只有自己的种子、快照与回退栈。
+ * 会话按编号分到固定的分片，每个分片一个工作线程，独占自己的会话表与一组可复用的 TableController，
+ * 分片之间不共享可写状态，吞吐随分片数（核数）线性增长。
+ * 分片内同时活跃的牌桌数量有上限；最久未使用的会话休眠为一份快照（几百字节）并归还牌桌，
+ * 从未走过的会话只记录关卡与种子，再次使用时从共享布局重新生成并套用快照。
+ * 同一会话的操作按提交顺序执行；完成回调在分片的工作线程中调用。
+ * 设置了 outcomeMaxNodes 时，每批输入之后由分片线程在预算内判定胜负，证明无法取胜的会话报告为 Lost；
+ * 结论不写入快照，休眠后再次使用时重新判定。
+ */
+class GameSessionManager
+{
+public:
+    using LevelId = std::uint32_t;
+    using SessionId = std::uint32_t;
+
+    static constexpr SessionId kInvalidSession = 0;
+
+    struct Options
+    {
+        std::size_t shardCount = 0;             // 0 表示按硬件线程数
+        std::size_t activeTablesPerShard = 32;  // 每个分片同时驻留的牌桌数，超出时休眠最久未用的会话
+        std::size_t outcomeMaxNodes = 0;        // 每批输入后胜负判定的节点预算，0 表示只做死局判定
+    };
+
+    struct SessionState
+    {
+        SessionId session = kInvalidSession;
+        bool found = false;
+        std::size_t applied = 0;                // 本批中生效的输入条数
+        std::size_t moveCount = 0;              // 回退栈深度
+        GameState gameState = GameState::Playing;
+        std::uint64_t stateHash = 0;
+    };
+
+    using Completion = std::function<void(const SessionState&)>;
+
+    GameSessionManager();
+    explicit GameSessionManager(Options options);
+    // 执行完已提交的操作后停止工作线程
+    ~GameSessionManager();
+
+    GameSessionManager(const GameSessionManager&) = delete;
+    GameSessionManager& operator=(const GameSessionManager&) = delete;
+
+    // 注册共享的关卡配置；可在任意线程调用
+    LevelId addLevel(const LevelConfig& config);
+
+    // 创建会话并在所属分片上开局；关卡编号无效时返回 kInvalidSession
+    SessionId createSession(LevelId level, unsigned int seed, const Completion& completion = nullptr);
+    // 销毁会话；回调中 found 表示会话在销毁前存在
+    void destroySession(SessionId session, const Completion& completion = nullptr);
+
+    // 把一批输入交给会话所在的分片，按顺序应用后回调
+    void submit(SessionId session, std::vector<InputCommand> commands, const Completion& completion = nullptr);
+    // 等待该会话之前提交的操作完成后返回其状态
+    SessionState query(SessionId session);
+
+    // 等待所有分片处理完已提交的操作
+    void waitIdle();
+
+    std::size_t getShardCount() const { return _shards.size(); }
+
+private:
+    struct Level
+    {
+        LevelConfig config;
+        std::uint64_t hash = 0;
+    };
+
+    struct Session
+    {
+        std::shared_ptr<const Level> level;
+        unsigned int seed = 0;
+        std::vector<unsigned char> snapshot;    // 休眠时的状态，空表示仍是开局状态
+        TableController* table = nullptr;       // 活跃时借用的牌桌
+        std::uint64_t lastUse = 0;
+    };
+
+    struct Operation
+    {
+        enum class Kind
+        {
+            Create,
+            Apply,
+            Destroy
+        };
+
+        Kind kind = Kind::Apply;
+        SessionId session = kInvalidSession;
+        std::shared_ptr<const Level> level;     // Create
+        unsigned int seed = 0;                  // Create
+        std::vector<InputCommand> commands;     // Apply
+        Completion completion;
+    };
+
+    struct Shard
+    {
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::condition_variable idleCondition;
+        std::vector<Operation> operations;      // 受 mutex 保护
+        bool processing = false;                // 受 mutex 保护
+        bool quit = false;                      // 受 mutex 保护
+
+        // 以下只由工作线程访问
+        std::unordered_map<SessionId, Session> sessions;
+        std::vector<std::unique_ptr<TableController>> tables;   // 分片的牌桌池，容量在会话之间复用
+        std::vector<TableController*> freeTables;
+        std::vector<SessionId> activeSessions;  // 当前借用着牌桌的会话，数量不超过 activeTablesPerShard
+        std::uint64_t clock = 0;
+    };
+
+    void post(SessionId session, Operation operation);
+    void workerLoop(Shard& shard);
+    void execute(Shard& shard, Operation& operation);
+    TableController* activate(Shard& shard, SessionId id, Session& session);
+    void hibernate(Shard& shard, SessionId id);
+    static void fillState(SessionId id, const Session& session, SessionState& outState);
+
+    Shard& getShard(SessionId session) { return *_shards[session % _shards.size()]; }
+
+    Options _options;
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::atomic<SessionId> _nextSession{1};
+
+    std::mutex _levelMutex;
+    std::vector<std::shared_ptr<const Level>> _levels;  // 受 _levelMutex 保护
+};
+
+} // namespace tripeaks
@@ -0,0 +1,198 @@
+#include "managers/HintManager.h"
+
+#include "cocos2d.h"
+
+#include <utility>
+
+namespace tripeaks
+{
+
+HintManager::HintManager()
+    : _delivery(std::make_shared<Delivery>())
+{
+}
+
+HintManager::~HintManager()
+{
+    stop();
+}
+
+void HintManager::start(const HintSearchService::Options& options)
+{
+    if (_worker.joinable())
+    {
+        return;
+    }
+
+    _options = options;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = false;
+    }
+    _worker = std::thread(&HintManager::workerLoop, this);
+}
+
+void HintManager::stop()
+{
+    if (!_worker.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+        _pendingSnapshot.reset();
+    }
+    _cancel.store(true, std::memory_order_relaxed);
+    _condition.notify_one();
+    _worker.join();
+    _hasBoard = false;
+}
+
+void HintManager::setHintCallback(const HintCallback& callback)
+{
+    _delivery->callback = callback;
+}
+
+void HintManager::setOutcomeCallback(const OutcomeCallback& callback)
+{
+    _delivery->outcomeCallback = callback;
+}
+
+void HintManager::reset()
+{
+    _hasBoard = false;
+    _delivery->resultReady = false;
+    _delivery->requested = false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pendingSnapshot.reset();
+    _resetCache = true;
+    _cancel.store(true, std::memory_order_relaxed);
+}
+
+void HintManager::onBoardChanged(const GameModel& model)
+{
+    if (!_worker.joinable())
+    {
+        return;
+    }
+
+    const std::uint64_t hash = HintSearchService::computeStateHash(model);
+    if (_hasBoard && hash == _delivery->currentHash)
+    {
+        return;
+    }
+    _hasBoard = true;
+    _delivery->currentHash = hash;
+    _delivery->resultReady = false;
+
+    // 快照在主线程复制，工作线程只读自己的副本
+    std::unique_ptr<GameModel> snapshot(new GameModel(model));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingSnapshot = std::move(snapshot);
+        _cancel.store(true, std::memory_order_relaxed);
+    }
+    _condition.notify_one();
+}
+
+void HintManager::requestHint()
+{
+    if (!_worker.joinable() || !_hasBoard)
+    {
+        return;
+    }
+
+    if (_delivery->resultReady)
+    {
+        _delivery->requested = false;
+        if (_delivery->callback)
+        {
+            _delivery->callback(_delivery->result);
+        }
+        return;
+    }
+    _delivery->requested = true;
+}
+
+void HintManager::cancelRequest()
+{
+    _delivery->requested = false;
+}
+
+void HintManager::workerLoop()
+{
+    HintSearchService::Cache cache;
+    for (;;)
+    {
+        std::unique_ptr<GameModel> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _quit || _pendingSnapshot; });
+            if (_quit)
+            {
+                return;
+            }
+            snapshot = std::move(_pendingSnapshot);
+            if (_resetCache)
+            {
+                cache.clear();
+                _resetCache = false;
+            }
+            // 在锁内清除取消标记：之后到来的新快照会重新置位
+            _cancel.store(false, std::memory_order_relaxed);
+        }
+
+        HintSearchService::Result result;
+        if (!HintSearchService::findBestMove(*snapshot, _options, cache, &_cancel, result))
+        {
+            continue;
+        }
+
+        post([result](Delivery& delivery) {
+            if (result.stateHash != delivery.currentHash)
+            {
+                return;
+            }
+            delivery.result = result;
+            delivery.resultReady = true;
+            if (delivery.requested)
+            {
+                delivery.requested = false;
+                if (delivery.callback)
+                {
+                    delivery.callback(result);
+                }
+            }
+        });
+
+        // 提示先行送达，胜负判定耗时更长，随后单独送达
+        const HintSearchService::Outcome outcome = HintSearchService::analyzeOutcome(*snapshot, _options, &_cancel);
+        if (outcome == HintSearchService::Outcome::Unknown)
+        {
+            continue;
+        }
+        const std::uint64_t stateHash = result.stateHash;
+        post([stateHash, outcome](Delivery& delivery) {
+            if (stateHash == delivery.currentHash && delivery.outcomeCallback)
+            {
+                delivery.outcomeCallback(outcome);
+            }
+        });
+    }
+}
+
+void HintManager::post(const std::function<void(Delivery&)>& task)
+{
+    std::weak_ptr<Delivery> weakDelivery = _delivery;
+    cocos2d::Director::getInstance()->getScheduler()->performFunctionInCocosThread([weakDelivery, task]() {
+        if (std::shared_ptr<Delivery> delivery = weakDelivery.lock())
+        {
+            task(*delivery);
+        }
+    });
+}
+
+} // namespace tripeaks
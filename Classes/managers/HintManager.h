@@ -0,0 +1,87 @@
+#pragma once
+
+#include "models/GameModel.h"
+#include "services/HintSearchService.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace tripeaks
+{
+
+/**
+ * 后台提示。
+ * 每走一步后由 GameController 交给一份模型快照，工作线程在快照上预先搜索最佳的下一步，
+ * 玩家点击提示时通常已有结果、可立即显示。新快照到来时取消正在进行的搜索并重新开始，
+ * 搜索缓存跨步保留，重新搜索只需补算新局面多出的部分。
+ * 提示结果之后，工作线程继续在同一快照上做有预算的胜负判定（HintSearchService::analyzeOutcome），
+ * 证明无法取胜时通知 GameController 提前结束本局。
+ * 结果通过 Scheduler::performFunctionInCocosThread 回到主线程，局面哈希与当前局面不符的结果直接丢弃。
+ * 除工作线程外，所有接口都只在主线程调用。
+ */
+class HintManager
+{
+public:
+    using HintCallback = std::function<void(const HintSearchService::Result&)>;
+    using OutcomeCallback = std::function<void(HintSearchService::Outcome)>;
+
+    HintManager();
+    ~HintManager();
+
+    HintManager(const HintManager&) = delete;
+    HintManager& operator=(const HintManager&) = delete;
+
+    // 启动工作线程；未启动时（无界面运行）其余接口不做任何事
+    void start(const HintSearchService::Options& options = HintSearchService::Options());
+    void stop();
+
+    // 玩家请求提示后，结果就绪时在主线程调用
+    void setHintCallback(const HintCallback& callback);
+    // 当前局面的胜负判定得出结论（Winnable 或 Unwinnable）时在主线程调用
+    void setOutcomeCallback(const OutcomeCallback& callback);
+
+    // 开局或重新开局：丢弃搜索缓存与已有结果
+    void reset();
+
+    // 每批输入处理完后调用；局面未变化时直接返回，否则复制快照并重新搜索
+    void onBoardChanged(const GameModel& model);
+
+    // 请求提示：结果已就绪时立即回调，否则在本局面的搜索完成后回调
+    void requestHint();
+
+    // 取消尚未回调的提示请求（如玩家已自行走了一步）
+    void cancelRequest();
+
+private:
+    // 主线程侧的状态，工作线程投递的回调通过弱引用访问，管理器销毁后的回调自动失效
+    struct Delivery
+    {
+        std::uint64_t currentHash = 0;
+        bool resultReady = false;
+        bool requested = false;
+        HintSearchService::Result result;
+        HintCallback callback;
+        OutcomeCallback outcomeCallback;
+    };
+
+    void workerLoop();
+    void post(const std::function<void(Delivery&)>& task);
+
+    std::shared_ptr<Delivery> _delivery;
+    bool _hasBoard = false;
+
+    HintSearchService::Options _options;
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::unique_ptr<GameModel> _pendingSnapshot;    // 受 _mutex 保护
+    bool _resetCache = false;                       // 受 _mutex 保护
+    bool _quit = false;                             // 受 _mutex 保护
+    std::atomic<bool> _cancel{false};
+};
+
+} // namespace tripeaks
@@ -0,0 +1,87 @@
+#include "managers/MoveScheduler.h"
+
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tripeaks
+{
+
+void MoveScheduler::schedule(std::uint32_t move, const Condition& condition, const Action& action)
+{
+    Task task;
+    task.move = move;
+    task.condition = condition;
+    task.action = action;
+    _tasks.emplace_back(std::move(task));
+}
+
+void MoveScheduler::cancelFrom(std::uint32_t move)
+{
+    const auto isCancelled = [move](const Task& task) { return task.move >= move; };
+    _tasks.erase(std::remove_if(_tasks.begin(), _tasks.end(), isCancelled), _tasks.end());
+    if (_runIndex < _ready.size())
+    {
+        _ready.erase(std::remove_if(_ready.begin() + static_cast<std::ptrdiff_t>(_runIndex) + 1, _ready.end(),
+                                    isCancelled),
+                     _ready.end());
+    }
+}
+
+void MoveScheduler::clear()
+{
+    _tasks.clear();
+    if (_runIndex < _ready.size())
+    {
+        _ready.resize(_runIndex + 1);
+    }
+}
+
+void MoveScheduler::update()
+{
+    // 由后续动作间接触发的 update 直接返回，剩余任务留给外层循环
+    if (!_ready.empty() || _tasks.empty())
+    {
+        return;
+    }
+
+    // 先按挂起顺序摘出所有就绪任务再执行，执行中新挂的任务留到下一次 update
+    std::size_t kept = 0;
+    for (std::size_t index = 0; index < _tasks.size(); ++index)
+    {
+        Task& task = _tasks[index];
+        if (!task.condition || task.condition())
+        {
+            _ready.emplace_back(std::move(task));
+        }
+        else
+        {
+            if (kept != index)
+            {
+                _tasks[kept] = std::move(task);
+            }
+            ++kept;
+        }
+    }
+    _tasks.resize(kept);
+    if (_ready.empty())
+    {
+        return;
+    }
+
+    TRIPEAKS_TRACE_SCOPE_ARG("controller", "runMoveTasks", "tasks", _ready.size());
+    for (_runIndex = 0; _runIndex < _ready.size(); ++_runIndex)
+    {
+        // 动作可能取消其后的任务并缩短 _ready，先移出再执行
+        const Action action = std::move(_ready[_runIndex].action);
+        if (action)
+        {
+            action();
+        }
+    }
+    _ready.clear();
+    _runIndex = 0;
+}
+
+} // namespace tripeaks
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 走法的后续步骤调度（帧驱动的协作式任务）。
+ * 一步走法的模型修改在处理输入时同步完成，下一步不必等待上一步的动画；
+ * 依赖画面或后台结果的收尾工作（结算界面、提示高亮、存档快照等）以“等待条件 + 后续动作”的形式挂在产生它的走法下，
+ * 由 GameController 每帧以及每批输入处理完后调用 update 检查，条件满足的任务按挂起顺序在主线程执行。
+ * 后续动作中可以再挂新的任务，形成不阻塞输入的步骤链；回退某一步时，该步及之后挂起的任务一并取消。
+ * 只在主线程使用。
+ */
+class MoveScheduler
+{
+public:
+    using Condition = std::function<bool()>;
+    using Action = std::function<void()>;
+
+    /**
+     * 挂起一个任务
+     * @param move 所属走法（回退栈深度），cancelFrom 按它取消
+     * @param condition 每次 update 时检查，返回true后执行 action；为空表示下一次 update 即执行
+     */
+    void schedule(std::uint32_t move, const Condition& condition, const Action& action);
+
+    // 取消 move 及之后的走法挂起的任务（回退时调用）
+    void cancelFrom(std::uint32_t move);
+    // 取消全部任务（开局、恢复存档时调用）
+    void clear();
+
+    void update();
+
+    std::size_t getPendingCount() const { return _tasks.size(); }
+
+private:
+    struct Task
+    {
+        std::uint32_t move = 0;
+        Condition condition;
+        Action action;
+    };
+
+    std::vector<Task> _tasks;
+    std::vector<Task> _ready;       // 本次 update 中条件已满足、等待执行的任务，复用容量
+    std::size_t _runIndex = 0;      // 正在执行的 _ready 下标，执行期间的取消只影响其后的任务
+};
+
+} // namespace tripeaks
@@ -0,0 +1,245 @@
+#include "managers/RaceLink.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace tripeaks
+{
+
+namespace
+{
+
+// 一帧最多携带一段预测窗口内的输入，远小于此
+constexpr std::size_t kMaxDatagramSize = 64 * 1024;
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+// Windows 上在 open 时把套接字设为非阻塞
+constexpr int kNoWaitFlags = 0;
+
+bool startupSockets()
+{
+    static const bool started = []() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+bool makeNonBlocking(SocketHandle socket)
+{
+    u_long enabled = 1;
+    return ioctlsocket(socket, FIONBIO, &enabled) == 0;
+}
+
+void closeSocket(SocketHandle socket)
+{
+    ::closesocket(socket);
+}
+
+std::string getSocketError()
+{
+    return "socket error " + std::to_string(WSAGetLastError());
+}
+
+// 对端尚未启动时 UDP 套接字会因 ICMP 端口不可达报 WSAECONNRESET，忽略后继续
+bool isTransientReceiveError()
+{
+    return WSAGetLastError() == WSAECONNRESET;
+}
+#else
+using SocketHandle = int;
+constexpr int kNoWaitFlags = MSG_DONTWAIT;
+
+bool startupSockets()
+{
+    return true;
+}
+
+bool makeNonBlocking(SocketHandle)
+{
+    return true;
+}
+
+void closeSocket(SocketHandle socket)
+{
+    ::close(socket);
+}
+
+std::string getSocketError()
+{
+    return std::strerror(errno);
+}
+
+// 对端尚未启动时 connect 过的 UDP 套接字会报 ECONNREFUSED，忽略后继续
+bool isTransientReceiveError()
+{
+    return errno == EINTR || errno == ECONNREFUSED;
+}
+#endif
+
+sockaddr_in makeLoopbackAddress(std::uint16_t port)
+{
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+} // namespace
+
+RaceLink::~RaceLink()
+{
+    close();
+}
+
+bool RaceLink::open(std::uint16_t localPort, std::uint16_t peerPort, const Options& options, std::string* errorMessage)
+{
+    close();
+    _options = options;
+    _random.seed(options.seed);
+
+    if (!startupSockets())
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Race link: sockets are unavailable";
+        }
+        return false;
+    }
+
+    const SocketHandle socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    _socket = static_cast<std::intptr_t>(socket);
+    const sockaddr_in local = makeLoopbackAddress(localPort);
+    const sockaddr_in peer = makeLoopbackAddress(peerPort);
+    // connect 之后只收对端的数据报，send 不必再带地址
+    if (_socket < 0 || ::bind(socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::connect(socket, reinterpret_cast<const sockaddr*>(&peer), sizeof(peer)) != 0 || !makeNonBlocking(socket))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Race link: " + getSocketError();
+        }
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RaceLink::close()
+{
+    if (_socket >= 0)
+    {
+        closeSocket(static_cast<SocketHandle>(_socket));
+        _socket = -1;
+    }
+    _delayed.clear();
+}
+
+void RaceLink::send(const std::vector<unsigned char>& bytes)
+{
+    if (_socket < 0)
+    {
+        return;
+    }
+    if (_options.lossRate > 0.0F && std::uniform_real_distribution<float>(0.0F, 1.0F)(_random) < _options.lossRate)
+    {
+        return;
+    }
+    if (_options.latencyMs == 0 && _options.jitterMs == 0)
+    {
+        transmit(bytes);
+        return;
+    }
+
+    std::uint32_t delayMs = _options.latencyMs;
+    if (_options.jitterMs > 0)
+    {
+        delayMs += std::uniform_int_distribution<std::uint32_t>(0, _options.jitterMs)(_random);
+    }
+    Delayed delayed;
+    delayed.due = Clock::now() + std::chrono::milliseconds(delayMs);
+    if (!_freeBuffers.empty())
+    {
+        delayed.bytes = std::move(_freeBuffers.back());
+        _freeBuffers.pop_back();
+    }
+    delayed.bytes.assign(bytes.begin(), bytes.end());
+    _delayed.emplace_back(std::move(delayed));
+}
+
+bool RaceLink::receive(std::vector<unsigned char>& outBytes)
+{
+    if (_socket < 0)
+    {
+        return false;
+    }
+    flushDue();
+
+    outBytes.resize(kMaxDatagramSize);
+    for (;;)
+    {
+        const auto received = ::recv(static_cast<SocketHandle>(_socket), reinterpret_cast<char*>(outBytes.data()),
+                                     static_cast<int>(outBytes.size()), kNoWaitFlags);
+        if (received >= 0)
+        {
+            outBytes.resize(static_cast<std::size_t>(received));
+            return true;
+        }
+        if (isTransientReceiveError())
+        {
+            continue;
+        }
+        outBytes.clear();
+        return false;
+    }
+}
+
+void RaceLink::flushDue()
+{
+    const Clock::time_point now = Clock::now();
+    std::size_t kept = 0;
+    for (std::size_t index = 0; index < _delayed.size(); ++index)
+    {
+        if (_delayed[index].due <= now)
+        {
+            transmit(_delayed[index].bytes);
+            _freeBuffers.emplace_back(std::move(_delayed[index].bytes));
+        }
+        else
+        {
+            if (kept != index)
+            {
+                _delayed[kept] = std::move(_delayed[index]);
+            }
+            ++kept;
+        }
+    }
+    _delayed.resize(kept);
+}
+
+void RaceLink::transmit(const std::vector<unsigned char>& bytes)
+{
+    const auto sent = ::send(static_cast<SocketHandle>(_socket), reinterpret_cast<const char*>(bytes.data()),
+                             static_cast<int>(bytes.size()), kNoWaitFlags);
+    if (sent > 0)
+    {
+        ++_sentDatagrams;
+        _sentBytes += static_cast<std::size_t>(sent);
+    }
+}
+
+} // namespace tripeaks
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 竞速同步用的本机数据报链路（127.0.0.1 上的 UDP，POSIX 套接字或 Winsock），两个本地进程各开一端即可对战与测试。
+ * 可注入单向延迟、抖动与丢包：发出的数据报先按随机延迟排队，到期后才真正发送，抖动会造成乱序。
+ * 套接字为非阻塞，由调用方在自己的循环中定期 receive。
+ */
+class RaceLink
+{
+public:
+    struct Options
+    {
+        std::uint32_t latencyMs = 0;    // 单向延迟
+        std::uint32_t jitterMs = 0;     // 在延迟上叠加 [0, jitterMs] 的随机值
+        float lossRate = 0.0F;          // 丢弃发出数据报的概率
+        unsigned int seed = 1;          // 抖动与丢包的随机种子
+    };
+
+    RaceLink() = default;
+    ~RaceLink();
+
+    RaceLink(const RaceLink&) = delete;
+    RaceLink& operator=(const RaceLink&) = delete;
+
+    bool open(std::uint16_t localPort, std::uint16_t peerPort, const Options& options,
+              std::string* errorMessage = nullptr);
+    void close();
+
+    void send(const std::vector<unsigned char>& bytes);
+
+    // 先发出已到期的数据报，再取出一个收到的数据报；没有时返回false
+    bool receive(std::vector<unsigned char>& outBytes);
+
+    // 实际交给套接字的数据报数与字节数（不含被丢弃的）
+    std::size_t getSentDatagrams() const { return _sentDatagrams; }
+    std::size_t getSentBytes() const { return _sentBytes; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Delayed
+    {
+        Clock::time_point due;
+        std::vector<unsigned char> bytes;
+    };
+
+    void flushDue();
+    void transmit(const std::vector<unsigned char>& bytes);
+
+    std::intptr_t _socket = -1;     // 平台套接字句柄（Winsock 的 SOCKET 为指针宽度），-1 表示未打开
+    Options _options;
+    std::mt19937 _random;
+    std::vector<Delayed> _delayed;
+    std::vector<std::vector<unsigned char>> _freeBuffers;   // 已发出的数据报缓冲区，复用容量
+    std::size_t _sentDatagrams = 0;
+    std::size_t _sentBytes = 0;
+};
+
+} // namespace tripeaks
@@ -0,0 +1,328 @@
+#include "managers/SessionPersistence.h"
+
+#include "services/SessionSerializer.h"
+#include "utils/TraceRecorder.h"
+
+#include "cocos2d.h"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace tripeaks
+{
+
+namespace
+{
+
+const char kSnapshotFileName[] = "session.snapshot";
+const char kJournalFileName[] = "session.journal";
+
+bool readFile(const std::string& path, std::vector<unsigned char>& outBytes)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    outBytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 把 stdio 缓冲写入内核并落盘
+bool syncFile(std::FILE* file)
+{
+    if (std::fflush(file) != 0)
+    {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+} // namespace
+
+SessionPersistence::SessionPersistence(std::string directory)
+    : SessionPersistence(std::move(directory), Options())
+{
+}
+
+SessionPersistence::SessionPersistence(std::string directory, Options options)
+    : _directory(std::move(directory))
+    , _options(options)
+{
+    if (!_directory.empty() && _directory.back() != '/')
+    {
+        _directory += '/';
+    }
+    _snapshotPath = _directory + kSnapshotFileName;
+    _journalPath = _directory + kJournalFileName;
+    // 工作线程只负责写文件，目录在启动它之前创建
+    cocos2d::FileUtils::getInstance()->createDirectory(_directory);
+
+    _worker = std::thread(&SessionPersistence::workerLoop, this);
+}
+
+SessionPersistence::~SessionPersistence()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _condition.notify_one();
+    _worker.join();
+}
+
+std::string SessionPersistence::getDefaultDirectory()
+{
+    return cocos2d::FileUtils::getInstance()->getWritablePath() + "session/";
+}
+
+bool SessionPersistence::load(std::uint64_t levelHash, GameModel& model, std::vector<UndoMove>& outUndoMoves,
+                              std::vector<InputCommand>& outTail, std::string* errorMessage)
+{
+    TRIPEAKS_TRACE_SCOPE("session", "load");
+    outTail.clear();
+
+    std::vector<unsigned char> bytes;
+    if (!readFile(_snapshotPath, bytes))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "No saved session";
+        }
+        return false;
+    }
+
+    std::uint64_t sequence = 0;
+    if (!SessionSerializer::readSnapshot(bytes, levelHash, model, outUndoMoves, sequence, errorMessage))
+    {
+        return false;
+    }
+
+    // 日志缺失或无效时只恢复到快照
+    std::string journalError;
+    if (readFile(_journalPath, bytes)
+        && !SessionSerializer::readJournal(bytes, levelHash, sequence, outTail, &journalError))
+    {
+        CCLOG("SessionPersistence: %s", journalError.c_str());
+    }
+
+    _levelHash = levelHash;
+    _sequence = sequence + outTail.size();
+    _recordsSinceSnapshot = outTail.size();
+    return true;
+}
+
+void SessionPersistence::beginLevel(std::uint64_t levelHash)
+{
+    _levelHash = levelHash;
+    _sequence = 0;
+    _recordsSinceSnapshot = 0;
+}
+
+void SessionPersistence::writeSnapshot(const GameModel& model, const std::vector<UndoMove>& undoMoves)
+{
+    TRIPEAKS_TRACE_SCOPE("session", "encodeSnapshot");
+    WriteOp op;
+    op.kind = WriteOp::Kind::Snapshot;
+    op.levelHash = _levelHash;
+    op.sequence = _sequence;
+    SessionSerializer::writeSnapshot(model, undoMoves, _levelHash, _sequence, op.bytes);
+    _recordsSinceSnapshot = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ops.emplace_back(std::move(op));
+    }
+    _condition.notify_one();
+}
+
+void SessionPersistence::recordInput(const InputCommand& command)
+{
+    ++_sequence;
+    ++_recordsSinceSnapshot;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // 与尚未写出的日志操作合并，一批输入只唤醒一次写线程
+        if (_ops.empty() || _ops.back().kind != WriteOp::Kind::Journal)
+        {
+            _ops.emplace_back();
+        }
+        WriteOp& op = _ops.back();
+        SessionSerializer::appendJournalRecord(_sequence, command, op.bytes);
+        ++op.recordCount;
+    }
+    _condition.notify_one();
+}
+
+void SessionPersistence::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _syncRequested = true;
+    }
+    _condition.notify_one();
+}
+
+void SessionPersistence::workerLoop()
+{
+    const auto hasWork = [this]() { return _quit || _syncRequested || !_ops.empty(); };
+    std::vector<WriteOp> ops;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;)
+    {
+        if (!hasWork())
+        {
+            if (_unsyncedRecords == 0)
+            {
+                _condition.wait(lock, hasWork);
+            }
+            else if (!_condition.wait_until(lock, _firstUnsyncedTime + std::chrono::milliseconds(_options.syncDelayMs),
+                                            hasWork))
+            {
+                lock.unlock();
+                syncJournal();
+                lock.lock();
+            }
+            continue;
+        }
+
+        if (_ops.empty() && _quit)
+        {
+            break;
+        }
+
+        ops.swap(_ops);
+        const bool syncRequested = _syncRequested;
+        _syncRequested = false;
+        lock.unlock();
+
+        for (const WriteOp& op : ops)
+        {
+            if (op.kind == WriteOp::Kind::Snapshot)
+            {
+                writeSnapshotFile(op);
+            }
+            else
+            {
+                writeJournal(op.bytes, op.recordCount);
+            }
+        }
+        ops.clear();
+        if (syncRequested || _unsyncedRecords >= _options.syncBatchSize)
+        {
+            syncJournal();
+        }
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    syncJournal();
+    if (_journalFile)
+    {
+        std::fclose(_journalFile);
+        _journalFile = nullptr;
+    }
+}
+
+void SessionPersistence::writeSnapshotFile(const WriteOp& op)
+{
+    TRIPEAKS_TRACE_SCOPE("session", "writeSnapshot");
+
+    // 先写临时文件并落盘再改名，改名前崩溃时旧快照与旧日志仍然完整
+    const std::string tempPath = _snapshotPath + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file)
+    {
+        CCLOG("SessionPersistence: failed to open %s", tempPath.c_str());
+        return;
+    }
+    const bool written = std::fwrite(op.bytes.data(), 1, op.bytes.size(), file) == op.bytes.size() && syncFile(file);
+    std::fclose(file);
+    if (!written)
+    {
+        CCLOG("SessionPersistence: failed to write %s", tempPath.c_str());
+        std::remove(tempPath.c_str());
+        return;
+    }
+#ifdef _WIN32
+    std::remove(_snapshotPath.c_str());
+#endif
+    if (std::rename(tempPath.c_str(), _snapshotPath.c_str()) != 0)
+    {
+        CCLOG("SessionPersistence: failed to replace %s", _snapshotPath.c_str());
+        std::remove(tempPath.c_str());
+        return;
+    }
+
+    // 快照已覆盖之前的所有记录，日志从新快照的序号重新开始
+    if (_journalFile)
+    {
+        std::fclose(_journalFile);
+    }
+    _journalFile = std::fopen(_journalPath.c_str(), "wb");
+    _unsyncedRecords = 0;
+    if (!_journalFile)
+    {
+        CCLOG("SessionPersistence: failed to open %s", _journalPath.c_str());
+        return;
+    }
+    std::vector<unsigned char> header;
+    SessionSerializer::writeJournalHeader(op.levelHash, op.sequence, header);
+    if (std::fwrite(header.data(), 1, header.size(), _journalFile) != header.size() || !syncFile(_journalFile))
+    {
+        CCLOG("SessionPersistence: failed to write %s", _journalPath.c_str());
+    }
+}
+
+void SessionPersistence::writeJournal(const std::vector<unsigned char>& bytes, std::size_t recordCount)
+{
+    if (!_journalFile)
+    {
+        _journalFile = std::fopen(_journalPath.c_str(), "ab");
+        if (!_journalFile)
+        {
+            CCLOG("SessionPersistence: failed to open %s", _journalPath.c_str());
+            return;
+        }
+    }
+    if (std::fwrite(bytes.data(), 1, bytes.size(), _journalFile) != bytes.size())
+    {
+        CCLOG("SessionPersistence: failed to append to %s", _journalPath.c_str());
+        return;
+    }
+    if (_unsyncedRecords == 0)
+    {
+        _firstUnsyncedTime = std::chrono::steady_clock::now();
+    }
+    _unsyncedRecords += recordCount;
+}
+
+void SessionPersistence::syncJournal()
+{
+    if (!_journalFile || _unsyncedRecords == 0)
+    {
+        return;
+    }
+    TRIPEAKS_TRACE_SCOPE_ARG("session", "syncJournal", "records", _unsyncedRecords);
+    if (!syncFile(_journalFile))
+    {
+        CCLOG("SessionPersistence: failed to sync %s", _journalPath.c_str());
+    }
+    _unsyncedRecords = 0;
+}
+
+} // namespace tripeaks
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "models/GameModel.h"
+#include "models/InputCommand.h"
+#include "models/UndoMove.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 会话存档：定期写入的模型快照 + 只追加的输入日志。
+ * 每条成功的输入追加一条日志记录，累积一定数量后写一次新快照并截断日志；
+ * 日志按批次 fsync（条数或等待时间先到者为准），切到后台时立即同步。
+ * 编码在主线程完成（几十字节到几KB），文件写入与同步都在专用写线程中进行，点击不会等待磁盘。
+ * 快照先写临时文件再改名，日志记录带校验和，进程在任意时刻被杀都能恢复到最后一条完整记录。
+ * 除写线程外，所有接口都只在主线程调用。
+ */
+class SessionPersistence
+{
+public:
+    struct Options
+    {
+        std::size_t snapshotInterval = 32;  // 每记录多少条输入写一次快照并截断日志
+        std::size_t syncBatchSize = 8;      // 累积多少条未同步的记录后立即同步
+        int syncDelayMs = 250;              // 未同步的记录最多等待多久
+    };
+
+    explicit SessionPersistence(std::string directory);
+    SessionPersistence(std::string directory, Options options);
+    // 写完队列中的数据并同步后返回
+    ~SessionPersistence();
+
+    SessionPersistence(const SessionPersistence&) = delete;
+    SessionPersistence& operator=(const SessionPersistence&) = delete;
+
+    // 默认存档目录：可写路径下的 session/
+    static std::string getDefaultDirectory();
+
+    /**
+     * 读取存档（启动时在主线程同步调用）
+     * @param model 已由同一关卡配置生成的模型，成功时套用快照
+     * @param outTail 快照之后的日志记录，由调用方按顺序重放
+     * @return 没有存档、存档属于其他关卡或快照损坏时返回false，模型的卡牌状态保持不变
+     */
+    bool load(std::uint64_t levelHash, GameModel& model, std::vector<UndoMove>& outUndoMoves,
+              std::vector<InputCommand>& outTail, std::string* errorMessage = nullptr);
+
+    // 开始新的一局，序号从0开始；随后应调用 writeSnapshot 写入开局状态
+    void beginLevel(std::uint64_t levelHash);
+
+    // 写入当前状态的快照，写入完成后日志从该快照重新开始
+    void writeSnapshot(const GameModel& model, const std::vector<UndoMove>& undoMoves);
+
+    void recordInput(const InputCommand& command);
+    bool isSnapshotDue() const { return _recordsSinceSnapshot >= _options.snapshotInterval; }
+
+    // 要求写线程立即同步已写入的记录（如切到后台），不等待完成
+    void flush();
+
+private:
+    struct WriteOp
+    {
+        enum class Kind
+        {
+            Journal,
+            Snapshot
+        };
+
+        Kind kind = Kind::Journal;
+        std::vector<unsigned char> bytes;
+        std::size_t recordCount = 0;        // Journal：bytes 中的记录条数
+        std::uint64_t levelHash = 0;        // Snapshot：新日志的关卡哈希
+        std::uint64_t sequence = 0;         // Snapshot：新日志的起始序号
+    };
+
+    void workerLoop();
+    void writeSnapshotFile(const WriteOp& op);
+    void writeJournal(const std::vector<unsigned char>& bytes, std::size_t recordCount);
+    void syncJournal();
+
+    std::string _directory;
+    std::string _snapshotPath;
+    std::string _journalPath;
+    Options _options;
+
+    // 主线程状态
+    std::uint64_t _levelHash = 0;
+    std::uint64_t _sequence = 0;            // 最后一条已记录输入的序号
+    std::size_t _recordsSinceSnapshot = 0;
+
+    // 写线程状态
+    std::FILE* _journalFile = nullptr;
+    std::size_t _unsyncedRecords = 0;
+    std::chrono::steady_clock::time_point _firstUnsyncedTime;
+
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<WriteOp> _ops;              // 受 _mutex 保护
+    bool _syncRequested = false;            // 受 _mutex 保护
+    bool _quit = false;                     // 受 _mutex 保护
+};
+
+} // namespace tripeaks
@@ -0,0 +1,551 @@
+#include "managers/SessionSocketServer.h"
+
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+// epoll 事件的用户数据：监听套接字与唤醒用的 eventfd 占用前两个编号，连接从 kFirstConnectionId 开始
+constexpr std::uint64_t kListenId = 0;
+constexpr std::uint64_t kWakeId = 1;
+constexpr std::uint64_t kFirstConnectionId = 2;
+
+constexpr int kMaxEventsPerWait = 256;
+
+void setError(std::string* errorMessage, const std::string& what)
+{
+    if (errorMessage)
+    {
+        *errorMessage = what + ": " + std::strerror(errno);
+    }
+}
+
+bool addToEpoll(int epollFd, int fd, std::uint32_t events, std::uint64_t id)
+{
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.u64 = id;
+    return ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+SessionProtocol::State toProtocolState(const GameSessionManager::SessionState& state)
+{
+    SessionProtocol::State result;
+    result.session = state.session;
+    result.found = state.found;
+    result.applied = static_cast<std::uint16_t>(std::min<std::size_t>(state.applied, 0xFFFF));
+    result.moveCount = static_cast<std::uint32_t>(state.moveCount);
+    result.gameState = state.gameState;
+    result.stateHash = state.stateHash;
+    return result;
+}
+
+} // namespace
+
+SessionSocketServer::SessionSocketServer(GameSessionManager& sessions) : SessionSocketServer(sessions, Options())
+{
+}
+
+SessionSocketServer::SessionSocketServer(GameSessionManager& sessions, Options options)
+    : _sessions(sessions)
+    , _options(options)
+    , _nextConnection(kFirstConnectionId)
+{
+    _options.maxPendingPerConnection = std::max<std::size_t>(1, _options.maxPendingPerConnection);
+    _options.readChunkSize = std::max<std::size_t>(SessionProtocol::kFrameHeaderSize, _options.readChunkSize);
+}
+
+SessionSocketServer::~SessionSocketServer()
+{
+    // 完成回调引用本对象，等分片处理完已提交的操作后再释放
+    _sessions.waitIdle();
+    closeAll();
+}
+
+bool SessionSocketServer::start(const std::string& socketPath, std::string* errorMessage)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Invalid socket path: " + socketPath;
+        }
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    closeAll();
+    _listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0)
+    {
+        setError(errorMessage, "socket");
+        return false;
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        setError(errorMessage, "bind " + socketPath);
+        closeAll();
+        return false;
+    }
+    _socketPath = socketPath;
+    if (::listen(_listenFd, SOMAXCONN) != 0)
+    {
+        setError(errorMessage, "listen");
+        closeAll();
+        return false;
+    }
+
+    _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_epollFd < 0 || _wakeFd < 0)
+    {
+        setError(errorMessage, "epoll/eventfd");
+        closeAll();
+        return false;
+    }
+    if (!addToEpoll(_epollFd, _listenFd, EPOLLIN, kListenId) || !addToEpoll(_epollFd, _wakeFd, EPOLLIN, kWakeId))
+    {
+        setError(errorMessage, "epoll_ctl");
+        closeAll();
+        return false;
+    }
+    _stopping = false;
+    return true;
+}
+
+void SessionSocketServer::run()
+{
+    epoll_event events[kMaxEventsPerWait];
+    while (!_stopping && _epollFd >= 0)
+    {
+        const int count = ::epoll_wait(_epollFd, events, kMaxEventsPerWait, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        TRIPEAKS_TRACE_SCOPE_ARG("sessions", "socketEvents", "events", count);
+        for (int index = 0; index < count; ++index)
+        {
+            const std::uint64_t id = events[index].data.u64;
+            const std::uint32_t flags = events[index].events;
+            if (id == kListenId)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (id == kWakeId)
+            {
+                drainCompletions();
+                continue;
+            }
+
+            const auto iter = _connections.find(id);
+            if (iter == _connections.end())
+            {
+                continue;
+            }
+            Connection& connection = *iter->second;
+            bool alive = (flags & EPOLLERR) == 0;
+            if (alive && (flags & EPOLLIN) != 0 && (connection.events & EPOLLIN) != 0)
+            {
+                alive = readInput(connection);
+            }
+            // 对端已完全关闭：已读到的请求照常提交，但应答无处可发
+            if (alive && (flags & EPOLLHUP) != 0)
+            {
+                alive = false;
+            }
+            if (alive)
+            {
+                alive = service(connection);
+            }
+            if (!alive)
+            {
+                closeConnection(id);
+            }
+        }
+    }
+    closeListener();
+}
+
+void SessionSocketServer::stop()
+{
+    _stopping = true;
+    wake();
+}
+
+void SessionSocketServer::acceptConnections()
+{
+    for (;;)
+    {
+        const int fd = ::accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // EAGAIN 表示已取完；文件描述符耗尽等错误等下一次可读事件再试
+            return;
+        }
+        if (_connections.size() >= _options.maxConnections)
+        {
+            ::close(fd);
+            continue;
+        }
+
+        const std::uint64_t id = _nextConnection++;
+        if (!addToEpoll(_epollFd, fd, EPOLLIN, id))
+        {
+            ::close(fd);
+            continue;
+        }
+        std::unique_ptr<Connection> connection(new Connection());
+        connection->fd = fd;
+        connection->id = id;
+        connection->events = EPOLLIN;
+        _connections.emplace(id, std::move(connection));
+    }
+}
+
+bool SessionSocketServer::readInput(Connection& connection)
+{
+    // 未解析的部分移到缓冲区开头，再保证至少 readChunkSize 的空闲空间；缓冲区容量在连接内复用
+    if (connection.inputStart == connection.inputEnd)
+    {
+        connection.inputStart = 0;
+        connection.inputEnd = 0;
+    }
+    else if (connection.inputStart > 0 && connection.input.size() - connection.inputEnd < _options.readChunkSize)
+    {
+        std::memmove(connection.input.data(), connection.input.data() + connection.inputStart,
+                     connection.inputEnd - connection.inputStart);
+        connection.inputEnd -= connection.inputStart;
+        connection.inputStart = 0;
+    }
+    if (connection.input.size() - connection.inputEnd < _options.readChunkSize)
+    {
+        connection.input.resize(connection.inputEnd + _options.readChunkSize);
+    }
+
+    // 水平触发：每个事件只读一次，缓冲区里剩下的数据在下一轮继续读，各连接之间轮流处理
+    for (;;)
+    {
+        const ssize_t received = ::read(connection.fd, connection.input.data() + connection.inputEnd,
+                                        connection.input.size() - connection.inputEnd);
+        if (received > 0)
+        {
+            connection.inputEnd += static_cast<std::size_t>(received);
+            return true;
+        }
+        if (received == 0)
+        {
+            connection.peerClosed = true;
+            return true;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+void SessionSocketServer::parseRequests(Connection& connection)
+{
+    while (!connection.malformed && connection.pending.size() < _options.maxPendingPerConnection)
+    {
+        std::size_t consumed = 0;
+        SessionProtocol::ErrorCode error = SessionProtocol::ErrorCode::MalformedPayload;
+        const SessionProtocol::DecodeStatus status =
+            SessionProtocol::decodeRequest(connection.input.data() + connection.inputStart,
+                                           connection.inputEnd - connection.inputStart, connection.request, consumed,
+                                           &error);
+        if (status == SessionProtocol::DecodeStatus::NeedMore)
+        {
+            return;
+        }
+
+        const std::uint64_t sequence = connection.firstSequence + connection.pending.size();
+        connection.pending.emplace_back();
+        if (status == SessionProtocol::DecodeStatus::Malformed)
+        {
+            // 无法确定后续帧的边界：应答错误并丢弃剩余输入，发完后关闭
+            PendingResponse& response = connection.pending.back();
+            response.opcode = SessionProtocol::Opcode::Error;
+            response.error = error;
+            response.ready = true;
+            connection.malformed = true;
+            connection.inputStart = connection.inputEnd;
+            return;
+        }
+        connection.inputStart += consumed;
+        dispatchRequest(connection, sequence);
+    }
+}
+
+void SessionSocketServer::dispatchRequest(Connection& connection, std::uint64_t sequence)
+{
+    SessionProtocol::Request& request = connection.request;
+    PendingResponse& response = connection.pending.back();
+    response.opcode = request.opcode;
+
+    const std::uint64_t id = connection.id;
+    const GameSessionManager::Completion completion = [this, id, sequence](
+                                                          const GameSessionManager::SessionState& state) {
+        postCompletion(id, sequence, state);
+    };
+
+    switch (request.opcode)
+    {
+    case SessionProtocol::Opcode::Create:
+        if (_sessions.createSession(request.level, request.seed, completion) == GameSessionManager::kInvalidSession)
+        {
+            // 关卡编号无效，不经过分片直接应答
+            response.ready = true;
+        }
+        break;
+    case SessionProtocol::Opcode::Apply:
+        // 整批走法移交给分片，作为一个操作在会话所在线程中连续应用
+        _sessions.submit(request.session, std::move(request.moves), completion);
+        request.moves.clear();
+        break;
+    case SessionProtocol::Opcode::Query:
+        _sessions.submit(request.session, std::vector<InputCommand>(), completion);
+        break;
+    case SessionProtocol::Opcode::Destroy:
+        _sessions.destroySession(request.session, completion);
+        break;
+    default:
+        response.ready = true;
+        break;
+    }
+}
+
+void SessionSocketServer::drainCompletions()
+{
+    std::uint64_t counter = 0;
+    while (::read(_wakeFd, &counter, sizeof(counter)) < 0 && errno == EINTR)
+    {
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_completionMutex);
+        _completionBatch.swap(_completions);
+    }
+
+    _touchedConnections.clear();
+    for (const Completion& completion : _completionBatch)
+    {
+        const auto iter = _connections.find(completion.connection);
+        if (iter == _connections.end())
+        {
+            continue;
+        }
+        Connection& connection = *iter->second;
+        PendingResponse& response = connection.pending[completion.sequence - connection.firstSequence];
+        response.state = toProtocolState(completion.state);
+        response.ready = true;
+        _touchedConnections.emplace_back(completion.connection);
+    }
+    _completionBatch.clear();
+
+    std::sort(_touchedConnections.begin(), _touchedConnections.end());
+    _touchedConnections.erase(std::unique(_touchedConnections.begin(), _touchedConnections.end()),
+                              _touchedConnections.end());
+    for (std::uint64_t id : _touchedConnections)
+    {
+        if (!service(*_connections.at(id)))
+        {
+            closeConnection(id);
+        }
+    }
+}
+
+bool SessionSocketServer::service(Connection& connection)
+{
+    flushReady(connection);
+    // 背压解除后先解析已缓存的请求，再决定是否继续读取
+    parseRequests(connection);
+    flushReady(connection);
+    if (!writeOutput(connection))
+    {
+        return false;
+    }
+
+    const bool outputDrained = connection.outputStart == connection.output.size();
+    if ((connection.malformed || connection.peerClosed) && connection.pending.empty() && outputDrained)
+    {
+        return false;
+    }
+
+    std::uint32_t events = 0;
+    if (!connection.malformed && !connection.peerClosed &&
+        connection.pending.size() < _options.maxPendingPerConnection &&
+        connection.output.size() - connection.outputStart < _options.readChunkSize)
+    {
+        events |= EPOLLIN;
+    }
+    if (!outputDrained)
+    {
+        events |= EPOLLOUT;
+    }
+    if (events != connection.events)
+    {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = events;
+        event.data.u64 = connection.id;
+        if (::epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0)
+        {
+            return false;
+        }
+        connection.events = events;
+    }
+    return true;
+}
+
+void SessionSocketServer::flushReady(Connection& connection)
+{
+    while (!connection.pending.empty() && connection.pending.front().ready)
+    {
+        const PendingResponse& response = connection.pending.front();
+        if (response.opcode == SessionProtocol::Opcode::Error)
+        {
+            SessionProtocol::appendErrorResponse(response.error, connection.output);
+        }
+        else
+        {
+            SessionProtocol::appendStateResponse(response.opcode, response.state, connection.output);
+        }
+        connection.pending.pop_front();
+        ++connection.firstSequence;
+    }
+}
+
+bool SessionSocketServer::writeOutput(Connection& connection)
+{
+    while (connection.outputStart < connection.output.size())
+    {
+        const ssize_t sent = ::send(connection.fd, connection.output.data() + connection.outputStart,
+                                    connection.output.size() - connection.outputStart, MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            connection.outputStart += static_cast<std::size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+        return false;
+    }
+    connection.output.clear();
+    connection.outputStart = 0;
+    return true;
+}
+
+void SessionSocketServer::closeConnection(std::uint64_t id)
+{
+    const auto iter = _connections.find(id);
+    if (iter == _connections.end())
+    {
+        return;
+    }
+    // 仍在分片中执行的请求照常完成，应答在 drainCompletions 中因找不到连接而丢弃
+    ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, iter->second->fd, nullptr);
+    ::close(iter->second->fd);
+    _connections.erase(iter);
+}
+
+void SessionSocketServer::postCompletion(std::uint64_t connection, std::uint64_t sequence,
+                                         const GameSessionManager::SessionState& state)
+{
+    bool wasEmpty = false;
+    {
+        std::lock_guard<std::mutex> lock(_completionMutex);
+        wasEmpty = _completions.empty();
+        Completion completion;
+        completion.connection = connection;
+        completion.sequence = sequence;
+        completion.state = state;
+        _completions.emplace_back(completion);
+    }
+    // 队列非空时事件循环必然已被唤醒，只在由空变为非空时写 eventfd
+    if (wasEmpty)
+    {
+        wake();
+    }
+}
+
+void SessionSocketServer::wake()
+{
+    if (_wakeFd >= 0)
+    {
+        const std::uint64_t one = 1;
+        while (::write(_wakeFd, &one, sizeof(one)) < 0 && errno == EINTR)
+        {
+        }
+    }
+}
+
+void SessionSocketServer::closeListener()
+{
+    for (auto& entry : _connections)
+    {
+        ::close(entry.second->fd);
+    }
+    _connections.clear();
+
+    if (_listenFd >= 0)
+    {
+        ::close(_listenFd);
+        _listenFd = -1;
+        ::unlink(_socketPath.c_str());
+    }
+}
+
+void SessionSocketServer::closeAll()
+{
+    closeListener();
+    if (_epollFd >= 0)
+    {
+        ::close(_epollFd);
+        _epollFd = -1;
+    }
+    if (_wakeFd >= 0)
+    {
+        ::close(_wakeFd);
+        _wakeFd = -1;
+    }
+}
+
+} // namespace tripeaks
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "managers/GameSessionManager.h"
+#include "services/SessionProtocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 以 Unix 域套接字对外提供 GameSessionManager 的无界面会话服务（仅 Linux，协议见 SessionProtocol）。
+ * 单线程 epoll 事件循环负责收发：一次可读事件解析缓冲区中全部完整的帧，每个 Apply 帧的整批走法
+ * 作为一个操作交给会话所在的分片；分片线程完成后把结果放入完成队列并通过 eventfd 唤醒事件循环。
+ * 每个连接一块接收缓冲区与一块发送缓冲区，帧直接在接收缓冲区上解码，应答直接编码进发送缓冲区，
+ * 不做逐帧的复制与分配。同一连接的应答按请求顺序发出；未完成的请求达到上限时暂停读取该连接（背压）。
+ * 会话不属于连接，断开后仍保留，需显式 Destroy。
+ */
+class SessionSocketServer
+{
+public:
+    struct Options
+    {
+        std::size_t maxConnections = 1024;
+        std::size_t maxPendingPerConnection = 1024;   // 每个连接未应答的请求数上限
+        std::size_t readChunkSize = 64 * 1024;        // 每次 read 至少预留的接收空间
+    };
+
+    SessionSocketServer(GameSessionManager& sessions, Options options);
+    explicit SessionSocketServer(GameSessionManager& sessions);
+    ~SessionSocketServer();
+
+    SessionSocketServer(const SessionSocketServer&) = delete;
+    SessionSocketServer& operator=(const SessionSocketServer&) = delete;
+
+    /**
+     * 监听指定路径（已存在的套接字文件会被替换）
+     * @param socketPath 套接字路径，长度受 sockaddr_un 限制
+     * @param errorMessage 失败时输出错误信息，可为空
+     */
+    bool start(const std::string& socketPath, std::string* errorMessage = nullptr);
+
+    // 在调用线程中运行事件循环，直到 stop()；返回前关闭所有连接并删除套接字文件
+    void run();
+    // 可在任意线程调用（start() 之后）
+    void stop();
+
+private:
+    struct PendingResponse
+    {
+        SessionProtocol::Opcode opcode = SessionProtocol::Opcode::Query;
+        SessionProtocol::ErrorCode error = SessionProtocol::ErrorCode::MalformedPayload;   // 仅 Error
+        bool ready = false;
+        SessionProtocol::State state;
+    };
+
+    struct Connection
+    {
+        int fd = -1;
+        std::uint64_t id = 0;
+        std::vector<unsigned char> input;
+        std::size_t inputStart = 0;                 // 已解析的字节数
+        std::size_t inputEnd = 0;                   // 已接收的字节数
+        std::vector<unsigned char> output;
+        std::size_t outputStart = 0;                // 已发送的字节数
+        std::deque<PendingResponse> pending;        // 按请求顺序排列，队首完成后才能发出
+        std::uint64_t firstSequence = 0;            // pending 队首的请求序号
+        std::uint32_t events = 0;                   // 当前注册的 epoll 事件
+        bool peerClosed = false;                    // 对端关闭了写端：处理完已收到的请求后关闭
+        bool malformed = false;                     // 请求无法解析：发完错误应答后关闭
+        SessionProtocol::Request request;
+    };
+
+    struct Completion
+    {
+        std::uint64_t connection = 0;
+        std::uint64_t sequence = 0;
+        GameSessionManager::SessionState state;
+    };
+
+    void acceptConnections();
+    // 以下返回 false 表示应关闭该连接
+    bool readInput(Connection& connection);
+    bool service(Connection& connection);
+    bool writeOutput(Connection& connection);
+    void parseRequests(Connection& connection);
+    void dispatchRequest(Connection& connection, std::uint64_t sequence);
+    void flushReady(Connection& connection);
+    void drainCompletions();
+    void closeConnection(std::uint64_t id);
+    void postCompletion(std::uint64_t connection, std::uint64_t sequence,
+                        const GameSessionManager::SessionState& state);
+    void wake();
+    // 关闭监听与全部连接；epoll 与 eventfd 保留到析构，stop() 与完成回调可随时唤醒
+    void closeListener();
+    void closeAll();
+
+    GameSessionManager& _sessions;
+    Options _options;
+    std::string _socketPath;
+    int _listenFd = -1;
+    int _epollFd = -1;
+    int _wakeFd = -1;
+    std::atomic<bool> _stopping{false};
+
+    std::unordered_map<std::uint64_t, std::unique_ptr<Connection>> _connections;
+    std::uint64_t _nextConnection = 0;
+    std::vector<std::uint64_t> _touchedConnections; // 本轮完成涉及的连接
+
+    std::mutex _completionMutex;
+    std::vector<Completion> _completions;           // 受 _completionMutex 保护
+    std::vector<Completion> _completionBatch;       // 事件循环取走后在锁外处理
+};
+
+} // namespace tripeaks
@@ -42,6 +42,16 @@ const UndoMove* UndoManager::peek() const
     return &_moves.back();
 }
 
+const std::vector<UndoMove>& UndoManager::getMoves() const
+{
+    return _moves;
+}
+
+void UndoManager::assign(std::vector<UndoMove> moves)
+{
+    _moves = std::move(moves);
+}
+
 } // namespace tripeaks
 
 
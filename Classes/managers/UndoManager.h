@@ -16,6 +16,10 @@ public:
     bool pop(UndoMove& outMove);
     const UndoMove* peek() const;
 
+    // 整个回退栈（栈底在前），供会话存档读写
+    const std::vector<UndoMove>& getMoves() const;
+    void assign(std::vector<UndoMove> moves);
+
 private:
     std::vector<UndoMove> _moves;
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 一次或多次操作后牌桌的增量变化。
+ * 由 GameModel 在状态修改时累积，控制器每次操作后取出交给视图，视图只刷新其中列出的卡牌。
+ */
+struct BoardChangeSet
+{
+    std::vector<int> cardIds;   // 可操作状态可能变化的卡牌（被移除/恢复/翻面的牌及其覆盖的牌），不重复
+    bool trayChanged = false;
+    bool stockChanged = false;
+
+    bool empty() const
+    {
+        return cardIds.empty() && !trayChanged && !stockChanged;
+    }
+
+    void clear()
+    {
+        cardIds.clear();
+        trayChanged = false;
+        stockChanged = false;
+    }
+};
+
+} // namespace tripeaks
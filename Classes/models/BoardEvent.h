@@ -0,0 +1,133 @@
+#pragma once
+
+namespace tripeaks
+{
+
+enum class GameState
+{
+    Playing,
+    Won,
+    Lost
+};
+
+/**
+ * 控制器在修改模型后发布的牌桌事件。
+ * 事件自带表现所需的全部参数（如旧手牌回到备用牌堆的位置），订阅者在批量派发时无需再读取模型的中间状态。
+ * 普通值类型，不持有堆内存；message 只能指向字符串字面量。
+ */
+struct BoardEvent
+{
+    enum class Type
+    {
+        CardRemoved,    // 桌面牌匹配后移到手牌区，旧手牌压入弃牌堆
+        CardRestored,   // 回退：手牌区的牌回到桌面
+        CardFlipped,
+        TrayChanged,    // 从备用牌堆抽牌、回退抽牌或开局放置首张手牌
+        StockChanged,   // 备用牌堆的牌数或顺序变化
+        WasteRecycled,  // 弃牌堆整体翻回空的备用牌堆
+        WasteRestored,  // 回退翻回：备用牌堆整体回到弃牌堆
+        StatusMessage,  // 操作被拒绝时的提示
+        GameStateChanged    // 胜负状态变化（回退可使已结束的一局回到进行中）
+    };
+
+    // TrayChanged 的来源
+    enum class TraySource
+    {
+        Draw,
+        UndoDraw,
+        Initial
+    };
+
+    Type type = Type::StockChanged;
+    int cardId = -1;
+    int previousTrayCardId = -1;    // CardRemoved/CardRestored/TrayChanged：操作前（或回退后恢复）的手牌，位于弃牌堆顶部
+    int stockIndex = -1;            // UndoDraw：抽出的牌回到备用牌堆的位置
+    TraySource traySource = TraySource::Draw;
+    bool faceUp = false;            // CardFlipped
+    bool animated = true;
+    GameState gameState = GameState::Playing;   // GameStateChanged
+    const char* message = nullptr;  // StatusMessage；GameStateChanged 为 Lost 时的原因
+
+    static BoardEvent cardRemoved(int cardId, int previousTrayCardId, bool animated)
+    {
+        BoardEvent event;
+        event.type = Type::CardRemoved;
+        event.cardId = cardId;
+        event.previousTrayCardId = previousTrayCardId;
+        event.animated = animated;
+        return event;
+    }
+
+    static BoardEvent cardRestored(int cardId, int previousTrayCardId, bool animated)
+    {
+        BoardEvent event;
+        event.type = Type::CardRestored;
+        event.cardId = cardId;
+        event.previousTrayCardId = previousTrayCardId;
+        event.animated = animated;
+        return event;
+    }
+
+    static BoardEvent cardFlipped(int cardId, bool faceUp, bool animated)
+    {
+        BoardEvent event;
+        event.type = Type::CardFlipped;
+        event.cardId = cardId;
+        event.faceUp = faceUp;
+        event.animated = animated;
+        return event;
+    }
+
+    static BoardEvent trayChanged(TraySource source, int cardId, int previousTrayCardId, int stockIndex,
+                                  bool animated)
+    {
+        BoardEvent event;
+        event.type = Type::TrayChanged;
+        event.traySource = source;
+        event.cardId = cardId;
+        event.previousTrayCardId = previousTrayCardId;
+        event.stockIndex = stockIndex;
+        event.animated = animated;
+        return event;
+    }
+
+    static BoardEvent stockChanged()
+    {
+        BoardEvent event;
+        event.type = Type::StockChanged;
+        return event;
+    }
+
+    static BoardEvent wasteRecycled()
+    {
+        BoardEvent event;
+        event.type = Type::WasteRecycled;
+        return event;
+    }
+
+    static BoardEvent wasteRestored()
+    {
+        BoardEvent event;
+        event.type = Type::WasteRestored;
+        return event;
+    }
+
+    static BoardEvent statusMessage(const char* message)
+    {
+        BoardEvent event;
+        event.type = Type::StatusMessage;
+        event.message = message;
+        return event;
+    }
+
+    static BoardEvent gameStateChanged(GameState state, const char* reason = nullptr)
+    {
+        BoardEvent event;
+        event.type = Type::GameStateChanged;
+        event.gameState = state;
+        event.message = reason;
+        return event;
+    }
+};
+
+} // namespace tripeaks
@@ -1,6 +1,9 @@
 #include "models/GameModel.h"
 
+#include "utils/Profiler.h"
+
 #include <algorithm>
+#include <utility>
 
 namespace tripeaks
 {
@@ -20,8 +23,26 @@ void GameModel::reset()
     _cards.clear();
     _cardIndexById.clear();
     _playfieldCardIds.clear();
+    _playfieldPositions.clear();
     _stockCardIds.clear();
+    _wastePileIds.clear();
     _trayCardId = -1;
+    _stockRecycleLimit = 0;
+    _stockRecycleCount = 0;
+    setMatchRule(MatchRule::TriPeaks);
+    _pendingChanges.clear();
+    _changeMarks.clear();
+}
+
+void GameModel::reserveCards(std::size_t cardCount)
+{
+    _cards.reserve(cardCount);
+    _cardIndexById.reserve(cardCount);
+    _changeMarks.reserve(cardCount);
+    _playfieldPositions.reserve(cardCount);
+    // 弃牌堆最多容纳全部卡牌，一次预留后入堆出堆都不再分配
+    _wastePileIds.reserve(cardCount);
+    _stockCardIds.reserve(cardCount);
 }
 
 Card* GameModel::getCardById(int cardId)
@@ -44,9 +65,9 @@ const Card* GameModel::getCardById(int cardId) const
     return &_cards[iter->second];
 }
 
-std::vector<int>& GameModel::getPlayfieldCardIds()
+const std::vector<Card>& GameModel::getCards() const
 {
-    return _playfieldCardIds;
+    return _cards;
 }
 
 const std::vector<int>& GameModel::getPlayfieldCardIds() const
@@ -54,6 +75,20 @@ const std::vector<int>& GameModel::getPlayfieldCardIds() const
     return _playfieldCardIds;
 }
 
+void GameModel::setPlayfieldCardIds(std::vector<int> cardIds)
+{
+    _playfieldCardIds = std::move(cardIds);
+    std::fill(_playfieldPositions.begin(), _playfieldPositions.end(), -1);
+    for (std::size_t position = 0; position < _playfieldCardIds.size(); ++position)
+    {
+        const int index = findCardIndex(_playfieldCardIds[position]);
+        if (index >= 0)
+        {
+            _playfieldPositions[index] = static_cast<int>(position);
+        }
+    }
+}
+
 std::vector<int>& GameModel::getStockCardIds()
 {
     return _stockCardIds;
@@ -93,13 +128,16 @@ Card* GameModel::addCard(const LevelCardConfig& config, bool isPlayfieldCard)
     const std::size_t index = _cards.size();
     _cards.emplace_back(std::move(card));
     _cardIndexById.emplace(newId, index);
+    _changeMarks.emplace_back(0);
 
     if (isPlayfieldCard)
     {
+        _playfieldPositions.emplace_back(static_cast<int>(_playfieldCardIds.size()));
         _playfieldCardIds.emplace_back(newId);
     }
     else
     {
+        _playfieldPositions.emplace_back(-1);
         _stockCardIds.emplace_back(newId);
     }
 
@@ -108,12 +146,8 @@ Card* GameModel::addCard(const LevelCardConfig& config, bool isPlayfieldCard)
 
 int GameModel::getPlayfieldIndex(int cardId) const
 {
-    const auto iter = std::find(_playfieldCardIds.begin(), _playfieldCardIds.end(), cardId);
-    if (iter == _playfieldCardIds.end())
-    {
-        return -1;
-    }
-    return static_cast<int>(std::distance(_playfieldCardIds.begin(), iter));
+    const int index = findCardIndex(cardId);
+    return index >= 0 ? _playfieldPositions[index] : -1;
 }
 
 bool GameModel::isCardExposed(int cardId) const
@@ -149,7 +183,11 @@ void GameModel::setCardFaceUp(int cardId, bool faceUp)
     {
         return;
     }
-    card->faceUp = faceUp;
+    if (card->faceUp != faceUp)
+    {
+        card->faceUp = faceUp;
+        markCardChanged(cardId);
+    }
 }
 
 void GameModel::setCardRemoved(int cardId, bool removed)
@@ -164,30 +202,71 @@ void GameModel::setCardRemoved(int cardId, bool removed)
 
 void GameModel::removeCardFromPlayfield(int cardId)
 {
+    TRIPEAKS_PROFILE_SCOPE(Model);
     setCardRemoved(cardId, true);
 
-    auto iter = std::find(_playfieldCardIds.begin(), _playfieldCardIds.end(), cardId);
-    if (iter != _playfieldCardIds.end())
+    // 移除后被它覆盖的牌可能露出
+    if (const Card* card = getCardById(cardId))
+    {
+        markCardChanged(cardId);
+        markCoveredCardsChanged(*card);
+    }
+
+    const int index = findCardIndex(cardId);
+    if (index < 0 || _playfieldPositions[index] < 0)
     {
-        _playfieldCardIds.erase(iter);
+        return;
     }
+    // 末尾的牌填到空位
+    const int position = _playfieldPositions[index];
+    const int lastCardId = _playfieldCardIds.back();
+    _playfieldCardIds[position] = lastCardId;
+    _playfieldPositions[findCardIndex(lastCardId)] = position;
+    _playfieldCardIds.pop_back();
+    _playfieldPositions[index] = -1;
 }
 
 void GameModel::restoreCardToPlayfield(int cardId, int insertIndex)
 {
+    TRIPEAKS_PROFILE_SCOPE(Model);
     setCardRemoved(cardId, false);
 
-    if (insertIndex < 0 || insertIndex > static_cast<int>(_playfieldCardIds.size()))
+    if (const Card* card = getCardById(cardId))
     {
-        insertIndex = static_cast<int>(_playfieldCardIds.size());
+        markCardChanged(cardId);
+        markCoveredCardsChanged(*card);
     }
 
-    _playfieldCardIds.insert(_playfieldCardIds.begin() + insertIndex, cardId);
+    const int index = findCardIndex(cardId);
+    if (index < 0 || _playfieldPositions[index] >= 0)
+    {
+        return;
+    }
+    const int size = static_cast<int>(_playfieldCardIds.size());
+    if (insertIndex < 0 || insertIndex > size)
+    {
+        insertIndex = size;
+    }
+
+    // removeCardFromPlayfield 的逆操作：占据该位置的牌回到末尾
+    if (insertIndex < size)
+    {
+        const int movedCardId = _playfieldCardIds[insertIndex];
+        _playfieldCardIds.emplace_back(movedCardId);
+        _playfieldPositions[findCardIndex(movedCardId)] = size;
+        _playfieldCardIds[insertIndex] = cardId;
+    }
+    else
+    {
+        _playfieldCardIds.emplace_back(cardId);
+    }
+    _playfieldPositions[index] = insertIndex;
 }
 
 void GameModel::setTrayCard(int cardId)
 {
     _trayCardId = cardId;
+    _pendingChanges.trayChanged = true;
 }
 
 int GameModel::getTrayCardId() const
@@ -198,10 +277,30 @@ int GameModel::getTrayCardId() const
 int GameModel::replaceTrayCard(int newCardId)
 {
     const int oldCardId = _trayCardId;
+    if (oldCardId >= 0)
+    {
+        _wastePileIds.emplace_back(oldCardId);
+    }
     _trayCardId = newCardId;
+    _pendingChanges.trayChanged = true;
     return oldCardId;
 }
 
+bool GameModel::restorePreviousTrayCard(int previousTrayCardId)
+{
+    if (previousTrayCardId >= 0)
+    {
+        if (_wastePileIds.empty() || _wastePileIds.back() != previousTrayCardId)
+        {
+            return false;
+        }
+        _wastePileIds.pop_back();
+    }
+    _trayCardId = previousTrayCardId;
+    _pendingChanges.trayChanged = true;
+    return true;
+}
+
 int GameModel::drawCardFromStock()
 {
     if (_stockCardIds.empty())
@@ -211,12 +310,84 @@ int GameModel::drawCardFromStock()
 
     const int cardId = _stockCardIds.back();
     _stockCardIds.pop_back();
+    _pendingChanges.stockChanged = true;
     return cardId;
 }
 
 void GameModel::returnCardToStock(int cardId)
 {
     _stockCardIds.emplace_back(cardId);
+    _pendingChanges.stockChanged = true;
+}
+
+void GameModel::setStockRecycleLimit(int limit)
+{
+    _stockRecycleLimit = limit;
+}
+
+int GameModel::getStockRecycleLimit() const
+{
+    return _stockRecycleLimit;
+}
+
+int GameModel::getStockRecycleCount() const
+{
+    return _stockRecycleCount;
+}
+
+void GameModel::setStockRecycleCount(int count)
+{
+    _stockRecycleCount = count;
+}
+
+bool GameModel::canRecycleWaste() const
+{
+    return _stockCardIds.empty() && !_wastePileIds.empty()
+        && (_stockRecycleLimit < 0 || _stockRecycleCount < _stockRecycleLimit);
+}
+
+int GameModel::recycleWasteToStock()
+{
+    if (!canRecycleWaste())
+    {
+        return 0;
+    }
+
+    TRIPEAKS_PROFILE_SCOPE(Model);
+    // 整堆翻面：弃牌堆底部（最早弃掉的牌）成为备用牌堆顶部
+    _stockCardIds.assign(_wastePileIds.rbegin(), _wastePileIds.rend());
+    _wastePileIds.clear();
+    for (int cardId : _stockCardIds)
+    {
+        setCardFaceUp(cardId, false);
+    }
+    ++_stockRecycleCount;
+    _pendingChanges.stockChanged = true;
+    _pendingChanges.trayChanged = true;
+    return static_cast<int>(_stockCardIds.size());
+}
+
+void GameModel::restoreWasteFromStock()
+{
+    TRIPEAKS_PROFILE_SCOPE(Model);
+    _wastePileIds.assign(_stockCardIds.rbegin(), _stockCardIds.rend());
+    _stockCardIds.clear();
+    for (int cardId : _wastePileIds)
+    {
+        setCardFaceUp(cardId, true);
+    }
+    if (_stockRecycleCount > 0)
+    {
+        --_stockRecycleCount;
+    }
+    _pendingChanges.stockChanged = true;
+    _pendingChanges.trayChanged = true;
+}
+
+void GameModel::setMatchRule(MatchRule rule)
+{
+    _matchRule = rule;
+    _matchTable = &tripeaks::getMatchTable(rule);
 }
 
 void GameModel::setCardFaceAndSuit(int cardId, CardFaceType face, CardSuit suit)
@@ -255,6 +426,41 @@ bool GameModel::isVictory() const
     return _playfieldCardIds.empty();
 }
 
+void GameModel::takeChanges(BoardChangeSet& outChanges)
+{
+    for (int cardId : _pendingChanges.cardIds)
+    {
+        _changeMarks[_cardIndexById[cardId]] = 0;
+    }
+    std::swap(outChanges, _pendingChanges);
+    _pendingChanges.clear();
+}
+
+int GameModel::findCardIndex(int cardId) const
+{
+    const auto iter = _cardIndexById.find(cardId);
+    return iter != _cardIndexById.end() ? static_cast<int>(iter->second) : -1;
+}
+
+void GameModel::markCardChanged(int cardId)
+{
+    auto iter = _cardIndexById.find(cardId);
+    if (iter == _cardIndexById.end() || _changeMarks[iter->second])
+    {
+        return;
+    }
+    _changeMarks[iter->second] = 1;
+    _pendingChanges.cardIds.emplace_back(cardId);
+}
+
+void GameModel::markCoveredCardsChanged(const Card& card)
+{
+    for (int coveredId : card.coveringCardIds)
+    {
+        markCardChanged(coveredId);
+    }
+}
+
 } // namespace tripeaks
 
 
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "configs/models/LevelConfig.h"
-
-#include "cocos2d.h"
+#include "models/BoardChangeSet.h"
+#include "models/MatchRule.h"
 
 #include <unordered_map>
 #include <vector>
@@ -15,7 +15,7 @@ struct Card
     int id = -1;
     CardFaceType face = CardFaceType::Ace;
     CardSuit suit = CardSuit::Clubs;
-    cocos2d::Vec2 position;
+    CardPosition position;
     bool faceUp = false;
     bool removed = false;
     bool isInPlayfield = true;
@@ -28,18 +28,29 @@ class GameModel
 {
 public:
     void reset();
+    void reserveCards(std::size_t cardCount);
 
     Card* getCardById(int cardId);
     const Card* getCardById(int cardId) const;
 
-    std::vector<int>& getPlayfieldCardIds();
+    // 全部卡牌（含已移除的），按添加顺序排列
+    const std::vector<Card>& getCards() const;
+
+    // 桌面上剩余的牌；移除时与末尾的牌交换位置，顺序不代表添加顺序
     const std::vector<int>& getPlayfieldCardIds() const;
+    // 整体替换桌面牌列表（恢复存档），同时重建位置索引
+    void setPlayfieldCardIds(std::vector<int> cardIds);
 
     std::vector<int>& getStockCardIds();
     const std::vector<int>& getStockCardIds() const;
 
+    // 弃牌堆：手牌区顶部牌之下、已被替换下的牌，底部在前；容量在 reserveCards 时按总牌数预留，之后不再分配
+    std::vector<int>& getWastePileIds();
+    const std::vector<int>& getWastePileIds() const;
+
     Card* addCard(const LevelCardConfig& config, bool isPlayfieldCard);
 
+    // 在 getPlayfieldCardIds 中的位置，不在桌面时返回-1；O(1)
     int getPlayfieldIndex(int cardId) const;
 
     bool isCardExposed(int cardId) const;
@@ -48,29 +59,70 @@ public:
     void setCardFaceUp(int cardId, bool faceUp);
     void setCardRemoved(int cardId, bool removed);
 
+    // 移除与恢复都是 O(1)：移除时末尾的牌填到空位；按后进先出的回退顺序以移除前的位置恢复时，列表与移除前完全一致
     void removeCardFromPlayfield(int cardId);
     void restoreCardToPlayfield(int cardId, int insertIndex);
 
     // Tray (手牌区) - 只有一张顶部牌
     void setTrayCard(int cardId);
     int getTrayCardId() const;
-    int replaceTrayCard(int newCardId);  // 返回旧的tray card ID，如果没有则返回-1
+    int replaceTrayCard(int newCardId);  // 旧的tray card压入弃牌堆并返回其ID，如果没有则返回-1
+    // 回退 replaceTrayCard：弃牌堆顶部牌（即 previousTrayCardId）回到手牌区，-1 表示清空手牌区；
+    // 弃牌堆顶部不是该牌时说明回退记录与牌桌不一致，不做修改并返回false
+    bool restorePreviousTrayCard(int previousTrayCardId);
 
     int drawCardFromStock();
     void returnCardToStock(int cardId);
 
+    // 备用牌堆翻回规则：备用牌堆用完后可把弃牌堆整体翻面放回，limit 为可翻回次数，-1 表示不限
+    void setStockRecycleLimit(int limit);
+    int getStockRecycleLimit() const;
+    int getStockRecycleCount() const;
+    void setStockRecycleCount(int count);
+    bool canRecycleWaste() const;
+    // 弃牌堆翻面成为备用牌堆（最早弃掉的牌最先抽出），返回翻回的牌数
+    int recycleWasteToStock();
+    // 回退 recycleWasteToStock
+    void restoreWasteFromStock();
+
+    // 配对规则：只保存指向编译期规则表的指针，判定为一次查表
+    void setMatchRule(MatchRule rule);
+    MatchRule getMatchRule() const { return _matchRule; }
+    const MatchTable& getMatchTable() const { return *_matchTable; }
+    bool canMatch(const Card& cardA, const Card& cardB) const
+    {
+        return _matchTable->canMatch(toCardKind(cardA.face, cardA.suit), toCardKind(cardB.face, cardB.suit));
+    }
+
     void setCardFaceAndSuit(int cardId, CardFaceType face, CardSuit suit);
 
     void rebuildCoveringRelations();
 
     bool isVictory() const;
 
+    // 取出自上次取出以来累积的牌桌变化（交换缓冲区，不分配内存）
+    void takeChanges(BoardChangeSet& outChanges);
+
 private:
+    // 卡牌在 _cards 中的索引，不存在时返回-1
+    int findCardIndex(int cardId) const;
+    void markCardChanged(int cardId);
+    void markCoveredCardsChanged(const Card& card);
+
     std::vector<Card> _cards;
     std::unordered_map<int, std::size_t> _cardIndexById;
     std::vector<int> _playfieldCardIds;
+    std::vector<int> _playfieldPositions;     // 按卡牌索引记录在 _playfieldCardIds 中的位置，-1 表示不在桌面
     std::vector<int> _stockCardIds;
+    std::vector<int> _wastePileIds;
     int _trayCardId = -1;  // 手牌区顶部牌ID，-1表示无牌
+    int _stockRecycleLimit = 0;
+    int _stockRecycleCount = 0;
+    MatchRule _matchRule = MatchRule::TriPeaks;
+    const MatchTable* _matchTable = &tripeaks::getMatchTable(MatchRule::TriPeaks);
+
+    BoardChangeSet _pendingChanges;
+    std::vector<unsigned char> _changeMarks;  // 按卡牌索引标记是否已在 _pendingChanges 中
 };
 
 } // namespace tripeaks
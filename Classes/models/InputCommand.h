@@ -0,0 +1,20 @@
+#pragma once
+
+namespace tripeaks
+{
+
+// 玩家或自动游玩产生的一次输入；也是会话日志中记录的单位
+struct InputCommand
+{
+    enum class Type
+    {
+        CardTap,
+        StockTap,
+        Undo
+    };
+
+    Type type = Type::CardTap;
+    int cardId = -1;   // 仅CardTap有效
+};
+
+} // namespace tripeaks
@@ -0,0 +1,67 @@
+#include "models/MatchRule.h"
+
+namespace tripeaks
+{
+
+namespace
+{
+
+struct MatchRuleName
+{
+    MatchRule rule;
+    const char* name;
+};
+
+const MatchRuleName kMatchRuleNames[] = {
+    {MatchRule::TriPeaks, "tripeaks"},
+    {MatchRule::Golf, "golf"},
+    {MatchRule::SameSuit, "sameSuit"},
+    {MatchRule::AlternatingColor, "alternatingColor"},
+    {MatchRule::KingsWild, "kingsWild"},
+};
+
+} // namespace
+
+const MatchTable& getMatchTable(MatchRule rule)
+{
+    switch (rule)
+    {
+    case MatchRule::Golf:
+        return MatchTableFor<GolfMatchPolicy>::value;
+    case MatchRule::SameSuit:
+        return MatchTableFor<SameSuitMatchPolicy>::value;
+    case MatchRule::AlternatingColor:
+        return MatchTableFor<AlternatingColorMatchPolicy>::value;
+    case MatchRule::KingsWild:
+        return MatchTableFor<KingsWildMatchPolicy>::value;
+    default:
+        return MatchTableFor<TriPeaksMatchPolicy>::value;
+    }
+}
+
+const char* getMatchRuleName(MatchRule rule)
+{
+    for (const MatchRuleName& entry : kMatchRuleNames)
+    {
+        if (entry.rule == rule)
+        {
+            return entry.name;
+        }
+    }
+    return kMatchRuleNames[0].name;
+}
+
+bool parseMatchRuleName(const std::string& name, MatchRule& outRule)
+{
+    for (const MatchRuleName& entry : kMatchRuleNames)
+    {
+        if (name == entry.name)
+        {
+            outRule = entry.rule;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace tripeaks
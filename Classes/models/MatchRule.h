@@ -0,0 +1,148 @@
+#pragma once
+
+#include "configs/models/LevelConfig.h"
+
+#include <cstdint>
+#include <string>
+
+namespace tripeaks
+{
+
+// 一副牌的牌种数：编号为 suit * 13 + face，与 CardBatchNode 的牌面索引一致
+constexpr int kCardKindCount = 52;
+
+constexpr int toCardKind(CardFaceType face, CardSuit suit)
+{
+    return static_cast<int>(suit) * 13 + static_cast<int>(face);
+}
+
+/**
+ * 52x52 配对邻接位表：rows[a] 的第 b 位表示牌种 b 能否放到牌种 a 上（规则对称）。
+ * 每种玩法在编译期生成一张表，运行时判定只需一次查表，不再按规则开关分支。
+ */
+struct MatchTable
+{
+    std::uint64_t rows[kCardKindCount];
+
+    constexpr bool canMatch(int kindA, int kindB) const
+    {
+        return ((rows[kindA] >> kindB) & 1U) != 0;
+    }
+
+    // 与 kindA 可配对的所有牌种，与按牌种统计的位掩码求与即可判断是否存在可配对的牌
+    constexpr std::uint64_t matchMask(int kindA) const
+    {
+        return rows[kindA];
+    }
+};
+
+enum class SuitConstraint
+{
+    Any,
+    SameSuit,
+    AlternatingColor
+};
+
+/**
+ * 配对规则策略
+ * @tparam Wrap K与A是否相邻
+ * @tparam Suits 花色约束
+ * @tparam WildFace 万能牌点数，-1 表示没有万能牌；万能牌可与任意牌配对且不受花色约束
+ */
+template <bool Wrap, SuitConstraint Suits, int WildFace = -1>
+struct MatchPolicy
+{
+    static constexpr bool isRed(int suit)
+    {
+        return suit == static_cast<int>(CardSuit::Diamonds) || suit == static_cast<int>(CardSuit::Hearts);
+    }
+
+    static constexpr bool matches(int kindA, int kindB)
+    {
+        const int faceA = kindA % 13;
+        const int faceB = kindB % 13;
+        const int suitA = kindA / 13;
+        const int suitB = kindB / 13;
+        if (faceA == WildFace || faceB == WildFace)
+        {
+            return true;
+        }
+
+        const int diff = faceA > faceB ? faceA - faceB : faceB - faceA;
+        if (diff != 1 && !(Wrap && diff == 12))
+        {
+            return false;
+        }
+
+        switch (Suits)
+        {
+        case SuitConstraint::SameSuit:
+            return suitA == suitB;
+        case SuitConstraint::AlternatingColor:
+            return isRed(suitA) != isRed(suitB);
+        default:
+            return true;
+        }
+    }
+};
+
+template <typename Policy>
+constexpr MatchTable buildMatchTable()
+{
+    MatchTable table{};
+    for (int kindA = 0; kindA < kCardKindCount; ++kindA)
+    {
+        for (int kindB = 0; kindB < kCardKindCount; ++kindB)
+        {
+            if (Policy::matches(kindA, kindB))
+            {
+                table.rows[kindA] |= std::uint64_t(1) << kindB;
+            }
+        }
+    }
+    return table;
+}
+
+template <typename Policy>
+struct MatchTableFor
+{
+    static constexpr MatchTable value = buildMatchTable<Policy>();
+};
+
+template <typename Policy>
+constexpr MatchTable MatchTableFor<Policy>::value;
+
+using TriPeaksMatchPolicy = MatchPolicy<true, SuitConstraint::Any>;
+using GolfMatchPolicy = MatchPolicy<false, SuitConstraint::Any>;
+using SameSuitMatchPolicy = MatchPolicy<true, SuitConstraint::SameSuit>;
+using AlternatingColorMatchPolicy = MatchPolicy<true, SuitConstraint::AlternatingColor>;
+using KingsWildMatchPolicy = MatchPolicy<true, SuitConstraint::Any, static_cast<int>(CardFaceType::King)>;
+
+// 规则表在编译期自检
+static_assert(MatchTableFor<TriPeaksMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Ace, CardSuit::Clubs),
+                                                                 toCardKind(CardFaceType::King, CardSuit::Hearts)),
+              "TriPeaks wraps K-A");
+static_assert(!MatchTableFor<GolfMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Ace, CardSuit::Clubs),
+                                                              toCardKind(CardFaceType::King, CardSuit::Clubs)),
+              "Golf does not wrap K-A");
+static_assert(!MatchTableFor<SameSuitMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Two, CardSuit::Clubs),
+                                                                  toCardKind(CardFaceType::Three, CardSuit::Spades)),
+              "SameSuit rejects different suits");
+static_assert(!MatchTableFor<AlternatingColorMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Two, CardSuit::Clubs),
+                                                                          toCardKind(CardFaceType::Three, CardSuit::Spades)),
+              "AlternatingColor rejects same color");
+static_assert(MatchTableFor<KingsWildMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Seven, CardSuit::Clubs),
+                                                                  toCardKind(CardFaceType::King, CardSuit::Hearts)),
+              "KingsWild matches any card with a king");
+static_assert(!MatchTableFor<TriPeaksMatchPolicy>::value.canMatch(toCardKind(CardFaceType::Five, CardSuit::Clubs),
+                                                                  toCardKind(CardFaceType::Five, CardSuit::Hearts)),
+              "equal ranks never match");
+
+// 关卡选择的规则对应的编译期表
+const MatchTable& getMatchTable(MatchRule rule);
+
+// 关卡JSON中的规则名：tripeaks / golf / sameSuit / alternatingColor / kingsWild
+const char* getMatchRuleName(MatchRule rule);
+bool parseMatchRuleName(const std::string& name, MatchRule& outRule);
+
+} // namespace tripeaks
@@ -1,10 +1,10 @@
 #include "services/GameModelFromLevelGenerator.h"
 
-#include "services/CardMatchService.h"
-
-#include "cocos2d.h"
+#include "utils/Profiler.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <random>
 
 namespace tripeaks
 {
@@ -38,7 +38,32 @@ CardSuit toSuitType(int value)
     return static_cast<CardSuit>(value);
 }
 
-void assignFaceAndSuit(GameModel& model, int cardId, const LevelCardConfig& config)
+// 不指定种子时每局不同（界面中的单局游戏）：每个线程一个以 random_device 播种的引擎
+struct GlobalRandom
+{
+    int operator()(int minValue, int maxValue) const
+    {
+        thread_local std::mt19937 engine{std::random_device{}()};
+        return std::uniform_int_distribution<int>(minValue, maxValue)(engine);
+    }
+};
+
+// 每局独立的随机数：mt19937 的输出序列由标准规定，取模映射也不依赖标准库实现，不同平台同一种子发出同一副牌
+struct SeededRandom
+{
+    explicit SeededRandom(unsigned int seed) : engine(seed) {}
+
+    int operator()(int minValue, int maxValue)
+    {
+        const std::uint32_t range = static_cast<std::uint32_t>(maxValue - minValue + 1);
+        return minValue + static_cast<int>(static_cast<std::uint32_t>(engine()) % range);
+    }
+
+    std::mt19937 engine;
+};
+
+template <typename Random>
+void assignFaceAndSuit(GameModel& model, int cardId, const LevelCardConfig& config, Random& random)
 {
     if (config.cardFace >= 0 && config.cardSuit >= 0)
     {
@@ -48,41 +73,38 @@ void assignFaceAndSuit(GameModel& model, int cardId, const LevelCardConfig& conf
 
     if (config.cardFace >= 0 && config.cardSuit < 0)
     {
-        const int suit = cocos2d::random(0, 3);
+        const int suit = random(0, 3);
         model.setCardFaceAndSuit(cardId, toFaceType(config.cardFace), toSuitType(suit));
         return;
     }
 
     if (config.cardFace < 0 && config.cardSuit >= 0)
     {
-        const int face = cocos2d::random(0, 12);
+        const int face = random(0, 12);
         model.setCardFaceAndSuit(cardId, toFaceType(face), toSuitType(config.cardSuit));
         return;
     }
 
-    CardMatchService::randomizeCard(model, cardId);
+    const int face = random(0, 12);
+    const int suit = random(0, 3);
+    model.setCardFaceAndSuit(cardId, toFaceType(face), toSuitType(suit));
 }
 
-} // namespace
-
-bool GameModelFromLevelGenerator::generateFromLevel(const std::string& configPath,
-                                                    GameModel& outModel,
-                                                    std::string* errorMessage)
+template <typename Random>
+void generate(const LevelConfig& levelConfig, GameModel& outModel, Random& random)
 {
-    LevelConfig levelConfig;
-    if (!LevelConfigLoader::loadFromFile(configPath, levelConfig, errorMessage))
-    {
-        return false;
-    }
-
+    TRIPEAKS_PROFILE_SCOPE(Model);
     outModel.reset();
+    outModel.reserveCards(levelConfig.playfieldCards.size() + levelConfig.stackCards.size());
+    outModel.setStockRecycleLimit(levelConfig.stockRecycles);
+    outModel.setMatchRule(levelConfig.matchRule);
 
     for (const LevelCardConfig& cardConfig : levelConfig.playfieldCards)
     {
         Card* card = outModel.addCard(cardConfig, true);
         if (card)
         {
-            assignFaceAndSuit(outModel, card->id, cardConfig);
+            assignFaceAndSuit(outModel, card->id, cardConfig, random);
         }
     }
 
@@ -91,13 +113,26 @@ bool GameModelFromLevelGenerator::generateFromLevel(const std::string& configPat
         Card* card = outModel.addCard(cardConfig, false);
         if (card)
         {
-            assignFaceAndSuit(outModel, card->id, cardConfig);
+            assignFaceAndSuit(outModel, card->id, cardConfig, random);
         }
     }
 
     outModel.rebuildCoveringRelations();
+}
 
-    return true;
+} // namespace
+
+void GameModelFromLevelGenerator::generateFromConfig(const LevelConfig& levelConfig, GameModel& outModel)
+{
+    GlobalRandom random;
+    generate(levelConfig, outModel, random);
+}
+
+void GameModelFromLevelGenerator::generateFromConfig(const LevelConfig& levelConfig, unsigned int seed,
+                                                     GameModel& outModel)
+{
+    SeededRandom random(seed);
+    generate(levelConfig, outModel, random);
 }
 
 } // namespace tripeaks
@@ -1,19 +1,19 @@
 #pragma once
 
-#include "configs/loaders/LevelConfigLoader.h"
+#include "configs/models/LevelConfig.h"
 #include "models/GameModel.h"
 
-#include <string>
-
 namespace tripeaks
 {
 
+// 关卡文件由界面侧的 LevelConfigLoader 读取，这里只依赖内存中的配置，无界面的工具不必链接 cocos2d
 class GameModelFromLevelGenerator
 {
 public:
-    static bool generateFromLevel(const std::string& configPath,
-                                  GameModel& outModel,
-                                  std::string* errorMessage = nullptr);
+    // 从内存中的关卡配置生成（LevelConfigLoader 或 TriPeaksLayoutGenerator 的输出）
+    static void generateFromConfig(const LevelConfig& levelConfig, GameModel& outModel);
+    // 未指定点数花色的牌由 seed 决定而不使用全局随机数：同一配置+种子在任何线程、任何平台都得到同一副牌
+    static void generateFromConfig(const LevelConfig& levelConfig, unsigned int seed, GameModel& outModel);
 };
 
 } // namespace tripeaks
@@ -0,0 +1,685 @@
+#include "services/HintSearchService.h"
+
+#include "utils/HashUtils.h"
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr int kRemovedCardScore = 100;
+constexpr int kPlayableCardScore = 8;
+constexpr int kStockCardScore = 3;
+constexpr int kDeadEndPenalty = 500;
+constexpr int kVictoryScore = 100000;
+
+// 缓存超过该条目数时在下一次搜索前清空，限制内存占用（约十余MB）
+constexpr std::size_t kMaxCacheEntries = 1U << 18;
+constexpr std::size_t kCancelCheckInterval = 1024;
+// 判定胜负时递归深度的上限（工作线程栈较小），超出的局面按未得出结论处理
+constexpr int kMaxOutcomeDepth = 256;
+// applyStockTap 把弃牌堆翻回时的返回值；抽牌时返回旧手牌（>= -1）
+constexpr int kRecycledToken = -2;
+
+using CacheEntries = std::unordered_map<std::uint64_t, HintSearchService::Cache::Entry>;
+
+std::uint64_t mixKey(std::uint64_t value)
+{
+    // splitmix64，对同一输入总得到相同的键，缓存才能跨多次搜索复用
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+std::uint64_t removedKey(int card)
+{
+    return mixKey((1ULL << 48) | static_cast<std::uint64_t>(card));
+}
+
+std::uint64_t trayKey(int card)
+{
+    return card < 0 ? 0 : mixKey((2ULL << 48) | static_cast<std::uint64_t>(card));
+}
+
+std::uint64_t stockKey(std::size_t position, int card)
+{
+    return mixKey((3ULL << 48) | (static_cast<std::uint64_t>(position) << 16) | static_cast<std::uint64_t>(card));
+}
+
+std::uint64_t wasteKey(std::size_t position, int card)
+{
+    return mixKey((4ULL << 48) | (static_cast<std::uint64_t>(position) << 16) | static_cast<std::uint64_t>(card));
+}
+
+std::uint64_t recycleKey(int count)
+{
+    return mixKey((5ULL << 48) | static_cast<std::uint64_t>(count));
+}
+
+/**
+ * 在紧凑的局面表示上做深度优先搜索。
+ * 卡牌按 GameModel::getCards 的顺序编号，走一步与回退都是原地修改，局面哈希随之增量更新。
+ * 走法与控制器一致：配对与抽牌时旧手牌压入弃牌堆；备用牌堆用完且规则允许时，点击备用牌堆把弃牌堆翻回。
+ */
+class HintSearcher
+{
+public:
+    HintSearcher(const GameModel& snapshot, const HintSearchService::Options& options, CacheEntries& entries,
+                 const std::atomic<bool>* cancelFlag)
+        : _options(options)
+        , _entries(entries)
+        , _cancelFlag(cancelFlag)
+    {
+        buildBoard(snapshot);
+    }
+
+    bool run(HintSearchService::Result& outResult)
+    {
+        for (int depth = 1; depth <= _options.maxDepth; ++depth)
+        {
+            HintSearchService::Move move;
+            int score = 0;
+            searchRoot(depth, move, score);
+            if (_cancelled)
+            {
+                return false;
+            }
+            // 节点数用尽的一轮只在还没有完整结果时采用
+            if (!_exhausted || outResult.depth == 0)
+            {
+                outResult.move = move;
+                outResult.score = score;
+                outResult.depth = _exhausted ? depth - 1 : depth;
+            }
+            if (_exhausted || move.type == HintSearchService::Move::Type::None)
+            {
+                break;
+            }
+        }
+        outResult.nodes = _nodes;
+        return true;
+    }
+
+    HintSearchService::Outcome analyzeOutcome()
+    {
+        std::unordered_set<std::uint64_t> explored;
+        switch (prove(0, explored))
+        {
+        case ProofResult::Win:
+            return HintSearchService::Outcome::Winnable;
+        case ProofResult::NoWin:
+            return HintSearchService::Outcome::Unwinnable;
+        default:
+            return HintSearchService::Outcome::Unknown;
+        }
+    }
+
+private:
+    void buildBoard(const GameModel& snapshot)
+    {
+        const std::vector<Card>& cards = snapshot.getCards();
+        const int cardCount = static_cast<int>(cards.size());
+        std::unordered_map<int, int> localById;
+        localById.reserve(cards.size());
+        for (int index = 0; index < cardCount; ++index)
+        {
+            localById.emplace(cards[index].id, index);
+        }
+
+        _cardIds.resize(cards.size());
+        _kinds.resize(cards.size());
+        _matchTable = &snapshot.getMatchTable();
+        _playfield.assign(cards.size(), 0);
+        _removed.assign(cards.size(), 0);
+        _faceUp.assign(cards.size(), 0);
+        _coveredByOffsets.assign(cards.size() + 1, 0);
+        _coveringOffsets.assign(cards.size() + 1, 0);
+
+        for (int index = 0; index < cardCount; ++index)
+        {
+            const Card& card = cards[index];
+            _cardIds[index] = card.id;
+            _kinds[index] = static_cast<unsigned char>(toCardKind(card.face, card.suit));
+            _playfield[index] = card.isInPlayfield ? 1 : 0;
+            _removed[index] = card.removed ? 1 : 0;
+            _faceUp[index] = card.faceUp ? 1 : 0;
+            if (card.isInPlayfield)
+            {
+                ++_playfieldCount;
+                if (card.removed)
+                {
+                    ++_removedCount;
+                    _hash ^= removedKey(index);
+                }
+            }
+
+            for (int coveringId : card.coveredByCardIds)
+            {
+                const auto iter = localById.find(coveringId);
+                if (iter != localById.end())
+                {
+                    _coveredBy.emplace_back(iter->second);
+                }
+            }
+            _coveredByOffsets[index + 1] = static_cast<int>(_coveredBy.size());
+
+            for (int coveredId : card.coveringCardIds)
+            {
+                const auto iter = localById.find(coveredId);
+                if (iter != localById.end())
+                {
+                    _covering.emplace_back(iter->second);
+                }
+            }
+            _coveringOffsets[index + 1] = static_cast<int>(_covering.size());
+        }
+
+        _stock.reserve(cards.size());
+        for (int stockId : snapshot.getStockCardIds())
+        {
+            const auto iter = localById.find(stockId);
+            if (iter != localById.end())
+            {
+                _hash ^= stockKey(_stock.size(), iter->second);
+                _stock.emplace_back(iter->second);
+            }
+        }
+
+        _waste.reserve(cards.size());
+        for (int wasteId : snapshot.getWastePileIds())
+        {
+            const auto iter = localById.find(wasteId);
+            if (iter != localById.end())
+            {
+                pushWaste(iter->second);
+            }
+        }
+        _recycleLimit = snapshot.getStockRecycleLimit();
+        _recycleCount = snapshot.getStockRecycleCount();
+        _hash ^= recycleKey(_recycleCount);
+
+        const auto trayIter = localById.find(snapshot.getTrayCardId());
+        _tray = trayIter != localById.end() ? trayIter->second : -1;
+        _hash ^= trayKey(_tray);
+
+        // 每层的候选走法与翻牌记录共用两个栈，搜索过程中不再分配
+        _moveStack.reserve(cards.size() * static_cast<std::size_t>(_options.maxDepth + 1));
+        _flipStack.reserve(cards.size());
+        _flipMarks.reserve(static_cast<std::size_t>(_options.maxDepth + 1));
+    }
+
+    bool isExposed(int card) const
+    {
+        for (int offset = _coveredByOffsets[card]; offset < _coveredByOffsets[card + 1]; ++offset)
+        {
+            if (!_removed[_coveredBy[offset]])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isPlayable(int card) const
+    {
+        return _playfield[card] && !_removed[card] && _faceUp[card] && isExposed(card);
+    }
+
+    bool isVictory() const
+    {
+        return _removedCount == _playfieldCount;
+    }
+
+    int evaluate() const
+    {
+        int playable = 0;
+        for (std::size_t card = 0; card < _playfield.size(); ++card)
+        {
+            if (isPlayable(static_cast<int>(card)))
+            {
+                ++playable;
+            }
+        }
+        return _removedCount * kRemovedCardScore + playable * kPlayableCardScore
+            + static_cast<int>(_stock.size()) * kStockCardScore;
+    }
+
+    // 把当前局面可走的桌面牌压入走法栈，返回压入的数量；抽牌不入栈
+    std::size_t pushPlayfieldMoves()
+    {
+        if (_tray < 0)
+        {
+            return 0;
+        }
+        // 手牌所在行的配对位掩码，循环内每张牌只需一次移位
+        const std::uint64_t matchMask = _matchTable->matchMask(_kinds[_tray]);
+        std::size_t count = 0;
+        for (std::size_t card = 0; card < _playfield.size(); ++card)
+        {
+            const int local = static_cast<int>(card);
+            if (((matchMask >> _kinds[local]) & 1U) != 0 && isPlayable(local))
+            {
+                _moveStack.emplace_back(local);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    int applyMatch(int card)
+    {
+        _removed[card] = 1;
+        ++_removedCount;
+        _hash ^= removedKey(card);
+
+        const int previousTray = _tray;
+        if (previousTray >= 0)
+        {
+            pushWaste(previousTray);
+        }
+        _hash ^= trayKey(previousTray) ^ trayKey(card);
+        _tray = card;
+
+        const std::size_t flipBegin = _flipStack.size();
+        for (int offset = _coveringOffsets[card]; offset < _coveringOffsets[card + 1]; ++offset)
+        {
+            const int covered = _covering[offset];
+            if (!_removed[covered] && !_faceUp[covered] && isExposed(covered))
+            {
+                _faceUp[covered] = 1;
+                _flipStack.emplace_back(covered);
+            }
+        }
+        _flipMarks.emplace_back(flipBegin);
+        return previousTray;
+    }
+
+    void undoMatch(int card, int previousTray)
+    {
+        const std::size_t flipBegin = _flipMarks.back();
+        _flipMarks.pop_back();
+        while (_flipStack.size() > flipBegin)
+        {
+            _faceUp[_flipStack.back()] = 0;
+            _flipStack.pop_back();
+        }
+
+        _hash ^= trayKey(card) ^ trayKey(previousTray);
+        _tray = previousTray;
+        if (previousTray >= 0)
+        {
+            popWaste();
+        }
+
+        _removed[card] = 0;
+        --_removedCount;
+        _hash ^= removedKey(card);
+    }
+
+    void pushWaste(int card)
+    {
+        _hash ^= wasteKey(_waste.size(), card);
+        _waste.emplace_back(card);
+    }
+
+    int popWaste()
+    {
+        const int card = _waste.back();
+        _waste.pop_back();
+        _hash ^= wasteKey(_waste.size(), card);
+        return card;
+    }
+
+    bool canRecycle() const
+    {
+        return _stock.empty() && !_waste.empty() && (_recycleLimit < 0 || _recycleCount < _recycleLimit);
+    }
+
+    bool canTapStock() const
+    {
+        return !_stock.empty() || canRecycle();
+    }
+
+    // 点击备用牌堆：有牌时抽牌并返回旧手牌，否则把弃牌堆翻回并返回 kRecycledToken
+    int applyStockTap()
+    {
+        if (_stock.empty())
+        {
+            applyRecycle();
+            return kRecycledToken;
+        }
+
+        const int card = _stock.back();
+        _stock.pop_back();
+        _hash ^= stockKey(_stock.size(), card);
+
+        const int previousTray = _tray;
+        if (previousTray >= 0)
+        {
+            pushWaste(previousTray);
+        }
+        _hash ^= trayKey(previousTray) ^ trayKey(card);
+        _tray = card;
+        return previousTray;
+    }
+
+    void undoStockTap(int token)
+    {
+        if (token == kRecycledToken)
+        {
+            undoRecycle();
+            return;
+        }
+
+        const int card = _tray;
+        _hash ^= trayKey(card) ^ trayKey(token);
+        _tray = token;
+        if (token >= 0)
+        {
+            popWaste();
+        }
+
+        _hash ^= stockKey(_stock.size(), card);
+        _stock.emplace_back(card);
+    }
+
+    // 与 GameModel::recycleWasteToStock 一致：弃牌堆底部成为备用牌堆顶部
+    void applyRecycle()
+    {
+        while (!_waste.empty())
+        {
+            const int card = popWaste();
+            _hash ^= stockKey(_stock.size(), card);
+            _stock.emplace_back(card);
+        }
+        _hash ^= recycleKey(_recycleCount) ^ recycleKey(_recycleCount + 1);
+        ++_recycleCount;
+    }
+
+    void undoRecycle()
+    {
+        while (!_stock.empty())
+        {
+            const int card = _stock.back();
+            _stock.pop_back();
+            _hash ^= stockKey(_stock.size(), card);
+            pushWaste(card);
+        }
+        _hash ^= recycleKey(_recycleCount) ^ recycleKey(_recycleCount - 1);
+        --_recycleCount;
+    }
+
+    bool shouldStop()
+    {
+        if (_cancelled)
+        {
+            return true;
+        }
+        if (_nodes % kCancelCheckInterval == 0 && _cancelFlag && _cancelFlag->load(std::memory_order_relaxed))
+        {
+            _cancelled = true;
+        }
+        return _cancelled;
+    }
+
+    int search(int depth)
+    {
+        ++_nodes;
+        if (shouldStop())
+        {
+            return 0;
+        }
+        if (isVictory())
+        {
+            return kVictoryScore;
+        }
+        if (_nodes >= _options.maxNodes)
+        {
+            _exhausted = true;
+        }
+        if (depth == 0 || _exhausted)
+        {
+            return evaluate();
+        }
+
+        const auto cached = _entries.find(_hash);
+        if (cached != _entries.end() && cached->second.depth >= depth)
+        {
+            return cached->second.score;
+        }
+
+        int best = std::numeric_limits<int>::min();
+        const std::size_t moveBegin = _moveStack.size();
+        const std::size_t moveCount = pushPlayfieldMoves();
+        for (std::size_t index = 0; index < moveCount; ++index)
+        {
+            const int card = _moveStack[moveBegin + index];
+            const int previousTray = applyMatch(card);
+            const int score = search(depth - 1);
+            undoMatch(card, previousTray);
+            best = std::max(best, score);
+        }
+        _moveStack.resize(moveBegin);
+
+        const bool stockTappable = canTapStock();
+        if (stockTappable)
+        {
+            const int token = applyStockTap();
+            best = std::max(best, search(depth - 1));
+            undoStockTap(token);
+        }
+
+        if (moveCount == 0 && !stockTappable)
+        {
+            best = evaluate() - kDeadEndPenalty;
+        }
+
+        // 被取消或节点数用尽时子树评分不完整，不写入缓存
+        if (!_cancelled && !_exhausted)
+        {
+            HintSearchService::Cache::Entry& entry = _entries[_hash];
+            entry.depth = depth;
+            entry.score = best;
+        }
+        return best;
+    }
+
+    enum class ProofResult
+    {
+        Win,
+        NoWin,
+        Aborted
+    };
+
+    // 深度优先寻找任意一条取胜路线。配对只增不减地移除桌面牌、抽牌只减少备用牌、翻回次数计入哈希，
+    // 局面不会成环；已完整搜索过且未取胜的局面记录在 explored 中，再次到达时直接跳过
+    ProofResult prove(int depth, std::unordered_set<std::uint64_t>& explored)
+    {
+        ++_nodes;
+        if (shouldStop())
+        {
+            return ProofResult::Aborted;
+        }
+        if (isVictory())
+        {
+            return ProofResult::Win;
+        }
+        if (_nodes >= _options.outcomeMaxNodes || depth >= kMaxOutcomeDepth)
+        {
+            _exhausted = true;
+            return ProofResult::Aborted;
+        }
+        if (explored.count(_hash) > 0)
+        {
+            return ProofResult::NoWin;
+        }
+
+        ProofResult result = ProofResult::NoWin;
+        const std::size_t moveBegin = _moveStack.size();
+        const std::size_t moveCount = pushPlayfieldMoves();
+        for (std::size_t index = 0; index < moveCount && result == ProofResult::NoWin; ++index)
+        {
+            const int card = _moveStack[moveBegin + index];
+            const int previousTray = applyMatch(card);
+            result = prove(depth + 1, explored);
+            undoMatch(card, previousTray);
+        }
+        _moveStack.resize(moveBegin);
+
+        if (result == ProofResult::NoWin && canTapStock())
+        {
+            const int token = applyStockTap();
+            result = prove(depth + 1, explored);
+            undoStockTap(token);
+        }
+
+        if (result == ProofResult::NoWin)
+        {
+            explored.emplace(_hash);
+        }
+        return result;
+    }
+
+    void searchRoot(int depth, HintSearchService::Move& outMove, int& outScore)
+    {
+        outMove = HintSearchService::Move();
+        outScore = std::numeric_limits<int>::min();
+
+        // 桌面牌排在抽牌之前，评分相同时优先提示桌面牌
+        const std::size_t moveBegin = _moveStack.size();
+        const std::size_t moveCount = pushPlayfieldMoves();
+        for (std::size_t index = 0; index < moveCount && !_cancelled; ++index)
+        {
+            const int card = _moveStack[moveBegin + index];
+            const int previousTray = applyMatch(card);
+            const int score = search(depth - 1);
+            undoMatch(card, previousTray);
+            if (score > outScore)
+            {
+                outScore = score;
+                outMove.type = HintSearchService::Move::Type::PlayfieldCard;
+                outMove.cardId = _cardIds[card];
+            }
+        }
+        _moveStack.resize(moveBegin);
+
+        if (canTapStock() && !_cancelled)
+        {
+            const int token = applyStockTap();
+            const int score = search(depth - 1);
+            undoStockTap(token);
+            if (score > outScore)
+            {
+                outScore = score;
+                outMove.type = HintSearchService::Move::Type::DrawStock;
+                outMove.cardId = -1;
+            }
+        }
+
+        if (outMove.type == HintSearchService::Move::Type::None)
+        {
+            outScore = evaluate() - kDeadEndPenalty;
+        }
+    }
+
+    const HintSearchService::Options& _options;
+    CacheEntries& _entries;
+    const std::atomic<bool>* _cancelFlag = nullptr;
+
+    std::vector<int> _cardIds;              // 局部编号 -> cardId
+    std::vector<unsigned char> _kinds;      // 牌种编号 suit * 13 + face
+    const MatchTable* _matchTable = nullptr;
+    std::vector<unsigned char> _playfield;
+    std::vector<unsigned char> _removed;
+    std::vector<unsigned char> _faceUp;
+    std::vector<int> _coveredBy;            // 按卡牌展开的覆盖关系，_coveredByOffsets[i]..[i+1] 为第i张牌的区间
+    std::vector<int> _coveredByOffsets;
+    std::vector<int> _covering;
+    std::vector<int> _coveringOffsets;
+    std::vector<int> _stock;
+    std::vector<int> _waste;
+    int _recycleLimit = 0;
+    int _recycleCount = 0;
+    int _tray = -1;
+    int _playfieldCount = 0;
+    int _removedCount = 0;
+    std::uint64_t _hash = 0;
+
+    std::vector<int> _moveStack;
+    std::vector<int> _flipStack;
+    std::vector<std::size_t> _flipMarks;
+
+    std::size_t _nodes = 0;
+    bool _exhausted = false;
+    bool _cancelled = false;
+};
+
+} // namespace
+
+std::uint64_t HintSearchService::computeStateHash(const GameModel& model)
+{
+    std::uint64_t hash = HashUtils::kFnv1a64Basis;
+    for (const Card& card : model.getCards())
+    {
+        const unsigned char flags = static_cast<unsigned char>((card.removed ? 1 : 0) | (card.faceUp ? 2 : 0));
+        HashUtils::mixFnv1a64(hash, &flags, sizeof(flags));
+    }
+    const int trayCardId = model.getTrayCardId();
+    HashUtils::mixFnv1a64(hash, &trayCardId, sizeof(trayCardId));
+    const std::vector<int>& stockIds = model.getStockCardIds();
+    if (!stockIds.empty())
+    {
+        HashUtils::mixFnv1a64(hash, stockIds.data(), stockIds.size() * sizeof(int));
+    }
+    // 备用牌堆与弃牌堆之间加入分隔，牌在两者之间移动时哈希必然变化
+    const std::uint32_t wasteCount = static_cast<std::uint32_t>(model.getWastePileIds().size());
+    HashUtils::mixFnv1a64(hash, &wasteCount, sizeof(wasteCount));
+    const std::vector<int>& wasteIds = model.getWastePileIds();
+    if (!wasteIds.empty())
+    {
+        HashUtils::mixFnv1a64(hash, wasteIds.data(), wasteIds.size() * sizeof(int));
+    }
+    const int recycleCount = model.getStockRecycleCount();
+    HashUtils::mixFnv1a64(hash, &recycleCount, sizeof(recycleCount));
+    return hash;
+}
+
+bool HintSearchService::findBestMove(const GameModel& snapshot, const Options& options, Cache& cache,
+                                     const std::atomic<bool>* cancelFlag, Result& outResult)
+{
+    TRIPEAKS_TRACE_SCOPE("hint", "findBestMove");
+    outResult = Result();
+    outResult.stateHash = computeStateHash(snapshot);
+
+    if (cache._entries.size() > kMaxCacheEntries)
+    {
+        cache.clear();
+    }
+
+    HintSearcher searcher(snapshot, options, cache._entries, cancelFlag);
+    return searcher.run(outResult);
+}
+
+HintSearchService::Outcome HintSearchService::analyzeOutcome(const GameModel& snapshot, const Options& options,
+                                                             const std::atomic<bool>* cancelFlag)
+{
+    TRIPEAKS_TRACE_SCOPE("hint", "analyzeOutcome");
+    if (options.outcomeMaxNodes == 0)
+    {
+        return Outcome::Unknown;
+    }
+
+    CacheEntries unusedEntries;
+    HintSearcher searcher(snapshot, options, unusedEntries, cancelFlag);
+    return searcher.analyzeOutcome();
+}
+
+} // namespace tripeaks
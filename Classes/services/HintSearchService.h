@@ -0,0 +1,100 @@
+#pragma once
+
+#include "models/GameModel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace tripeaks
+{
+
+/**
+ * 提示搜索：在模型快照上做多步前瞻，给出当前局面下最好的一步（点击桌面牌或从备用牌堆抽牌）。
+ * 只读取传入的快照，不修改模型，可在工作线程调用。
+ */
+class HintSearchService
+{
+public:
+    struct Move
+    {
+        enum class Type
+        {
+            None,           // 无牌可走
+            PlayfieldCard,
+            DrawStock       // 点击备用牌堆：抽牌，备用牌堆已空时把弃牌堆翻回
+        };
+
+        Type type = Type::None;
+        int cardId = -1;    // 仅PlayfieldCard有效
+    };
+
+    // 当前局面能否取胜
+    enum class Outcome
+    {
+        Unknown,        // 节点数用尽或被取消，未能得出结论
+        Winnable,
+        Unwinnable      // 已穷尽所有走法，无论怎么走都无法清空桌面
+    };
+
+    struct Options
+    {
+        int maxDepth = 16;                  // 前瞻步数
+        std::size_t maxNodes = 400000;      // 单次搜索最多展开的局面数，超出后按已搜索的结果返回
+        std::size_t outcomeMaxNodes = 200000;   // analyzeOutcome 最多展开的局面数，0 表示不做判定
+    };
+
+    struct Result
+    {
+        Move move;
+        int score = 0;
+        int depth = 0;                      // 完整搜索过的前瞻步数
+        std::size_t nodes = 0;
+        std::uint64_t stateHash = 0;        // 快照的 computeStateHash，用于丢弃过期结果
+    };
+
+    /**
+     * 局面缓存，以局面哈希为键记录各剩余步数下的最好评分。
+     * 由调用方跨多次搜索持有：玩家每走一步后新局面的大部分子树已在上一次搜索中评估过，
+     * 重新搜索时直接命中。只适用于同一局（发牌不变），开局或重新开局时需要 clear。
+     */
+    class Cache
+    {
+    public:
+        struct Entry
+        {
+            int depth = 0;      // 评分对应的剩余步数
+            int score = 0;
+        };
+
+        void clear() { _entries.clear(); }
+        std::size_t size() const { return _entries.size(); }
+
+    private:
+        friend class HintSearchService;
+
+        std::unordered_map<std::uint64_t, Entry> _entries;
+    };
+
+    // 牌桌状态的哈希（桌面牌是否移除、手牌区顶部牌、备用牌堆与弃牌堆顺序、已翻回次数），在主线程每步后计算
+    static std::uint64_t computeStateHash(const GameModel& model);
+
+    /**
+     * 搜索最佳的下一步
+     * @param cancelFlag 可选，被置位时尽快返回 false（结果作废）
+     * @return 被取消时返回 false
+     */
+    static bool findBestMove(const GameModel& snapshot, const Options& options, Cache& cache,
+                             const std::atomic<bool>* cancelFlag, Result& outResult);
+
+    /**
+     * 穷举判定当前局面能否取胜。找到任意一条取胜路线即返回 Winnable；
+     * 只有在节点预算内遍历完所有可达局面才返回 Unwinnable，否则返回 Unknown。
+     * 开销远大于 findBestMove，应在后台线程调用
+     */
+    static Outcome analyzeOutcome(const GameModel& snapshot, const Options& options,
+                                  const std::atomic<bool>* cancelFlag);
+};
+
+} // namespace tripeaks
@@ -0,0 +1,281 @@
+#include "services/RaceProtocol.h"
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr std::uint8_t kMoveStock = 0;
+constexpr std::uint8_t kMoveUndo = 1;
+constexpr std::uint8_t kMoveCardBase = 2;
+constexpr std::uint8_t kMoveCardEscape = 0xFF;
+constexpr int kMaxInlineCardId = kMoveCardEscape - 1 - kMoveCardBase;
+
+void putVarint(std::vector<unsigned char>& bytes, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.emplace_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.emplace_back(static_cast<unsigned char>(value));
+}
+
+std::uint64_t zigzagEncode(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t zigzagDecode(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * 顺序读取，越界或变长整数过长后所有读取都失败
+ */
+class FrameReader
+{
+public:
+    FrameReader(const unsigned char* data, std::size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    bool readU8(std::uint8_t& outValue)
+    {
+        if (_failed || _offset >= _size)
+        {
+            _failed = true;
+            return false;
+        }
+        outValue = _data[_offset++];
+        return true;
+    }
+
+    bool readU64(std::uint64_t& outValue)
+    {
+        outValue = 0;
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            outValue |= static_cast<std::uint64_t>(byte) << shift;
+        }
+        return true;
+    }
+
+    bool readVarint(std::uint64_t& outValue)
+    {
+        outValue = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            std::uint8_t byte = 0;
+            if (!readU8(byte))
+            {
+                return false;
+            }
+            outValue |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        _failed = true;
+        return false;
+    }
+
+    bool readVarint32(std::uint32_t& outValue)
+    {
+        std::uint64_t value = 0;
+        if (!readVarint(value) || value > 0xFFFFFFFFULL)
+        {
+            _failed = true;
+            return false;
+        }
+        outValue = static_cast<std::uint32_t>(value);
+        return true;
+    }
+
+    bool atEnd() const { return !_failed && _offset == _size; }
+
+private:
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _offset = 0;
+    bool _failed = false;
+};
+
+void putMove(std::vector<unsigned char>& bytes, const InputCommand& command)
+{
+    switch (command.type)
+    {
+    case InputCommand::Type::StockTap:
+        bytes.emplace_back(kMoveStock);
+        break;
+    case InputCommand::Type::Undo:
+        bytes.emplace_back(kMoveUndo);
+        break;
+    default:
+        if (command.cardId >= 0 && command.cardId <= kMaxInlineCardId)
+        {
+            bytes.emplace_back(static_cast<unsigned char>(kMoveCardBase + command.cardId));
+        }
+        else
+        {
+            bytes.emplace_back(kMoveCardEscape);
+            putVarint(bytes, zigzagEncode(command.cardId));
+        }
+        break;
+    }
+}
+
+bool readMove(FrameReader& reader, InputCommand& outCommand)
+{
+    std::uint8_t code = 0;
+    if (!reader.readU8(code))
+    {
+        return false;
+    }
+    outCommand.cardId = -1;
+    if (code == kMoveStock)
+    {
+        outCommand.type = InputCommand::Type::StockTap;
+        return true;
+    }
+    if (code == kMoveUndo)
+    {
+        outCommand.type = InputCommand::Type::Undo;
+        return true;
+    }
+    outCommand.type = InputCommand::Type::CardTap;
+    if (code != kMoveCardEscape)
+    {
+        outCommand.cardId = code - kMoveCardBase;
+        return true;
+    }
+    std::uint64_t value = 0;
+    if (!reader.readVarint(value))
+    {
+        return false;
+    }
+    const std::int64_t cardId = zigzagDecode(value);
+    if (cardId < -1 || cardId > 0x7FFFFFFF)
+    {
+        return false;
+    }
+    outCommand.cardId = static_cast<int>(cardId);
+    return true;
+}
+
+} // namespace
+
+constexpr std::uint8_t RaceProtocol::kVersion;
+
+void RaceProtocol::appendHello(const Hello& hello, std::vector<unsigned char>& outBytes)
+{
+    outBytes.emplace_back(static_cast<unsigned char>(FrameType::Hello));
+    outBytes.emplace_back(kVersion);
+    outBytes.emplace_back(hello.player);
+    outBytes.emplace_back(hello.inputDelay);
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        outBytes.emplace_back(static_cast<unsigned char>(hello.levelHash >> shift));
+    }
+    putVarint(outBytes, hello.seed);
+}
+
+void RaceProtocol::appendInputs(std::uint32_t ack, std::uint32_t firstTick, std::uint32_t endTick,
+                                const TimedInput* inputs, std::size_t count, std::vector<unsigned char>& outBytes)
+{
+    std::size_t begin = 0;
+    while (begin < count && inputs[begin].tick < firstTick)
+    {
+        ++begin;
+    }
+    std::size_t end = begin;
+    while (end < count && inputs[end].tick < endTick)
+    {
+        ++end;
+    }
+
+    // 两条时间线前进速度相同，ack 与 endTick 相差很小，按差值编码通常只占一字节
+    outBytes.emplace_back(static_cast<unsigned char>(FrameType::Inputs));
+    putVarint(outBytes, endTick);
+    putVarint(outBytes, endTick - firstTick);
+    putVarint(outBytes, zigzagEncode(static_cast<std::int64_t>(ack) - static_cast<std::int64_t>(endTick)));
+    putVarint(outBytes, end - begin);
+    std::uint32_t previousTick = firstTick;
+    for (std::size_t index = begin; index < end; ++index)
+    {
+        putVarint(outBytes, inputs[index].tick - previousTick);
+        putMove(outBytes, inputs[index].command);
+        previousTick = inputs[index].tick;
+    }
+}
+
+bool RaceProtocol::readFrameType(const unsigned char* data, std::size_t size, FrameType& outType)
+{
+    if (size == 0 || (data[0] != static_cast<unsigned char>(FrameType::Hello) &&
+                      data[0] != static_cast<unsigned char>(FrameType::Inputs)))
+    {
+        return false;
+    }
+    outType = static_cast<FrameType>(data[0]);
+    return true;
+}
+
+bool RaceProtocol::decodeHello(const unsigned char* data, std::size_t size, Hello& outHello)
+{
+    FrameReader reader(data, size);
+    std::uint8_t type = 0;
+    std::uint8_t version = 0;
+    return reader.readU8(type) && type == static_cast<std::uint8_t>(FrameType::Hello) && reader.readU8(version) &&
+           version == kVersion && reader.readU8(outHello.player) && reader.readU8(outHello.inputDelay) &&
+           reader.readU64(outHello.levelHash) && reader.readVarint32(outHello.seed) && reader.atEnd();
+}
+
+bool RaceProtocol::decodeInputs(const unsigned char* data, std::size_t size, Inputs& outInputs)
+{
+    FrameReader reader(data, size);
+    std::uint8_t type = 0;
+    std::uint32_t span = 0;
+    std::uint64_t ackDelta = 0;
+    std::uint32_t count = 0;
+    if (!reader.readU8(type) || type != static_cast<std::uint8_t>(FrameType::Inputs) ||
+        !reader.readVarint32(outInputs.endTick) || !reader.readVarint32(span) || span > outInputs.endTick ||
+        !reader.readVarint(ackDelta) || !reader.readVarint32(count) || count > size)
+    {
+        return false;
+    }
+    const std::int64_t ack = static_cast<std::int64_t>(outInputs.endTick) + zigzagDecode(ackDelta);
+    if (ack < 0 || ack > 0xFFFFFFFFLL)
+    {
+        return false;
+    }
+    outInputs.ack = static_cast<std::uint32_t>(ack);
+    outInputs.firstTick = outInputs.endTick - span;
+
+    outInputs.inputs.clear();
+    std::uint32_t tick = outInputs.firstTick;
+    for (std::uint32_t index = 0; index < count; ++index)
+    {
+        std::uint32_t delta = 0;
+        TimedInput input;
+        if (!reader.readVarint32(delta) || delta >= outInputs.endTick - tick || !readMove(reader, input.command))
+        {
+            return false;
+        }
+        tick += delta;
+        input.tick = tick;
+        outInputs.inputs.emplace_back(input);
+    }
+    return reader.atEnd();
+}
+
+} // namespace tripeaks
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "models/InputCommand.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 双人竞速的同步帧编解码（无连接的数据报，每个数据报一帧）。
+ * Hello : u8 类型(1), u8 版本, u8 玩家序号, u8 输入延迟, u64 关卡哈希, varint 种子
+ * Inputs: u8 类型(2), varint endTick, varint (endTick - firstTick), zigzag varint (ack - endTick),
+ *         varint 输入条数, 每条 = varint 与上一条（首条与 firstTick）的 tick 差 + 走法
+ * 走法：0 抽牌, 1 回退, 2..0xFE 为点击 cardId 0..252 的桌面牌，0xFF 后跟 varint cardId。
+ * Inputs 表示发送方在 [firstTick, endTick) 内的全部输入，ack 为发送方已完整收到的对方 tick 数；
+ * 未被确认的输入在之后每一帧中重发，丢包与乱序都不需要重传机制。常见的一步只占两字节。
+ * 只做内存中的编解码。
+ */
+class RaceProtocol
+{
+public:
+    enum class FrameType : std::uint8_t
+    {
+        Hello = 1,
+        Inputs = 2
+    };
+
+    static constexpr std::uint8_t kVersion = 1;
+
+    struct Hello
+    {
+        std::uint64_t levelHash = 0;
+        std::uint32_t seed = 0;
+        std::uint8_t player = 0;
+        std::uint8_t inputDelay = 0;
+    };
+
+    // 对战时间线上的一条输入
+    struct TimedInput
+    {
+        std::uint32_t tick = 0;
+        InputCommand command;
+    };
+
+    struct Inputs
+    {
+        std::uint32_t ack = 0;
+        std::uint32_t firstTick = 0;
+        std::uint32_t endTick = 0;
+        std::vector<TimedInput> inputs;     // tick 非递减，且都在 [firstTick, endTick) 内；解码时复用容量
+    };
+
+    static void appendHello(const Hello& hello, std::vector<unsigned char>& outBytes);
+    // inputs 中 tick 不在 [firstTick, endTick) 内的条目不编码
+    static void appendInputs(std::uint32_t ack, std::uint32_t firstTick, std::uint32_t endTick,
+                             const TimedInput* inputs, std::size_t count, std::vector<unsigned char>& outBytes);
+
+    // 读取帧类型；空帧或未知类型返回false
+    static bool readFrameType(const unsigned char* data, std::size_t size, FrameType& outType);
+    static bool decodeHello(const unsigned char* data, std::size_t size, Hello& outHello);
+    static bool decodeInputs(const unsigned char* data, std::size_t size, Inputs& outInputs);
+};
+
+} // namespace tripeaks
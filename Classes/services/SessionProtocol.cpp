@@ -0,0 +1,358 @@
+#include "services/SessionProtocol.h"
+
+#include <algorithm>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr std::size_t kStatePayloadSize = 20;
+
+constexpr std::uint8_t kMoveStock = 0;
+constexpr std::uint8_t kMoveUndo = 1;
+constexpr std::uint8_t kMoveCard = 2;
+
+constexpr std::uint8_t kStateFound = 1U << 0;
+
+void putU8(std::vector<unsigned char>& bytes, std::uint8_t value)
+{
+    bytes.emplace_back(value);
+}
+
+void putU16(std::vector<unsigned char>& bytes, std::uint16_t value)
+{
+    bytes.emplace_back(static_cast<unsigned char>(value));
+    bytes.emplace_back(static_cast<unsigned char>(value >> 8));
+}
+
+void putU32(std::vector<unsigned char>& bytes, std::uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        bytes.emplace_back(static_cast<unsigned char>(value >> shift));
+    }
+}
+
+void putU64(std::vector<unsigned char>& bytes, std::uint64_t value)
+{
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        bytes.emplace_back(static_cast<unsigned char>(value >> shift));
+    }
+}
+
+// 帧头的长度字段在负载写完后回填
+std::size_t beginFrame(std::vector<unsigned char>& bytes, SessionProtocol::Opcode opcode)
+{
+    const std::size_t start = bytes.size();
+    putU16(bytes, 0);
+    putU8(bytes, static_cast<std::uint8_t>(opcode));
+    return start;
+}
+
+void endFrame(std::vector<unsigned char>& bytes, std::size_t start)
+{
+    const std::size_t payload = bytes.size() - start - SessionProtocol::kFrameHeaderSize;
+    bytes[start] = static_cast<unsigned char>(payload);
+    bytes[start + 1] = static_cast<unsigned char>(payload >> 8);
+}
+
+/**
+ * 小端顺序读取，越界后所有读取都失败
+ */
+class PayloadReader
+{
+public:
+    PayloadReader(const unsigned char* data, std::size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    bool readU8(std::uint8_t& outValue)
+    {
+        std::uint64_t value = 0;
+        const bool ok = readBytes(1, value);
+        outValue = static_cast<std::uint8_t>(value);
+        return ok;
+    }
+
+    bool readU16(std::uint16_t& outValue)
+    {
+        std::uint64_t value = 0;
+        const bool ok = readBytes(2, value);
+        outValue = static_cast<std::uint16_t>(value);
+        return ok;
+    }
+
+    bool readU32(std::uint32_t& outValue)
+    {
+        std::uint64_t value = 0;
+        const bool ok = readBytes(4, value);
+        outValue = static_cast<std::uint32_t>(value);
+        return ok;
+    }
+
+    bool readU64(std::uint64_t& outValue)
+    {
+        return readBytes(8, outValue);
+    }
+
+    bool atEnd() const { return !_failed && _offset == _size; }
+
+private:
+    bool readBytes(std::size_t count, std::uint64_t& outValue)
+    {
+        outValue = 0;
+        if (_failed || _size - _offset < count)
+        {
+            _failed = true;
+            return false;
+        }
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            outValue |= static_cast<std::uint64_t>(_data[_offset + index]) << (8 * index);
+        }
+        _offset += count;
+        return true;
+    }
+
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _offset = 0;
+    bool _failed = false;
+};
+
+// 读取帧头；完整帧时返回true并给出负载位置
+SessionProtocol::DecodeStatus readFrame(const unsigned char* data, std::size_t size, std::uint8_t& outOpcode,
+                                        const unsigned char*& outPayload, std::size_t& outPayloadSize,
+                                        std::size_t& outConsumed)
+{
+    if (size < SessionProtocol::kFrameHeaderSize)
+    {
+        return SessionProtocol::DecodeStatus::NeedMore;
+    }
+    const std::size_t payloadSize = static_cast<std::size_t>(data[0]) | (static_cast<std::size_t>(data[1]) << 8);
+    if (size < SessionProtocol::kFrameHeaderSize + payloadSize)
+    {
+        return SessionProtocol::DecodeStatus::NeedMore;
+    }
+    outOpcode = data[2];
+    outPayload = data + SessionProtocol::kFrameHeaderSize;
+    outPayloadSize = payloadSize;
+    outConsumed = SessionProtocol::kFrameHeaderSize + payloadSize;
+    return SessionProtocol::DecodeStatus::Complete;
+}
+
+bool readMoves(PayloadReader& reader, std::vector<InputCommand>& outMoves)
+{
+    std::uint16_t count = 0;
+    if (!reader.readU16(count))
+    {
+        return false;
+    }
+    outMoves.clear();
+    outMoves.reserve(count);
+    for (std::uint16_t index = 0; index < count; ++index)
+    {
+        std::uint8_t kind = 0;
+        if (!reader.readU8(kind))
+        {
+            return false;
+        }
+        InputCommand command;
+        switch (kind)
+        {
+        case kMoveStock:
+            command.type = InputCommand::Type::StockTap;
+            break;
+        case kMoveUndo:
+            command.type = InputCommand::Type::Undo;
+            break;
+        case kMoveCard:
+        {
+            std::uint16_t cardId = 0;
+            if (!reader.readU16(cardId))
+            {
+                return false;
+            }
+            command.type = InputCommand::Type::CardTap;
+            command.cardId = cardId;
+            break;
+        }
+        default:
+            return false;
+        }
+        outMoves.emplace_back(command);
+    }
+    return true;
+}
+
+} // namespace
+
+// C++14 中按引用使用（std::min 等）时需要类外定义
+constexpr std::size_t SessionProtocol::kFrameHeaderSize;
+constexpr std::size_t SessionProtocol::kMaxPayloadSize;
+constexpr std::uint8_t SessionProtocol::kResponseFlag;
+constexpr std::size_t SessionProtocol::kMaxMovesPerApply;
+
+SessionProtocol::DecodeStatus SessionProtocol::decodeRequest(const unsigned char* data, std::size_t size,
+                                                             Request& outRequest, std::size_t& outConsumed,
+                                                             ErrorCode* outError)
+{
+    std::uint8_t opcode = 0;
+    const unsigned char* payload = nullptr;
+    std::size_t payloadSize = 0;
+    const DecodeStatus frameStatus = readFrame(data, size, opcode, payload, payloadSize, outConsumed);
+    if (frameStatus != DecodeStatus::Complete)
+    {
+        return frameStatus;
+    }
+
+    PayloadReader reader(payload, payloadSize);
+    bool ok = false;
+    outRequest.opcode = static_cast<Opcode>(opcode);
+    switch (outRequest.opcode)
+    {
+    case Opcode::Create:
+        ok = reader.readU16(outRequest.level) && reader.readU32(outRequest.seed);
+        break;
+    case Opcode::Apply:
+        ok = reader.readU32(outRequest.session) && readMoves(reader, outRequest.moves);
+        break;
+    case Opcode::Query:
+    case Opcode::Destroy:
+        ok = reader.readU32(outRequest.session);
+        break;
+    default:
+        if (outError)
+        {
+            *outError = ErrorCode::UnknownOpcode;
+        }
+        return DecodeStatus::Malformed;
+    }
+
+    if (!ok || !reader.atEnd())
+    {
+        if (outError)
+        {
+            *outError = ErrorCode::MalformedPayload;
+        }
+        return DecodeStatus::Malformed;
+    }
+    return DecodeStatus::Complete;
+}
+
+void SessionProtocol::appendStateResponse(Opcode opcode, const State& state, std::vector<unsigned char>& outBytes)
+{
+    const std::size_t start =
+        beginFrame(outBytes, static_cast<Opcode>(static_cast<std::uint8_t>(opcode) | kResponseFlag));
+    putU32(outBytes, state.session);
+    putU8(outBytes, state.found ? kStateFound : 0);
+    putU16(outBytes, state.applied);
+    putU32(outBytes, state.moveCount);
+    putU8(outBytes, static_cast<std::uint8_t>(state.gameState));
+    putU64(outBytes, state.stateHash);
+    endFrame(outBytes, start);
+}
+
+void SessionProtocol::appendErrorResponse(ErrorCode error, std::vector<unsigned char>& outBytes)
+{
+    const std::size_t start = beginFrame(outBytes, Opcode::Error);
+    putU8(outBytes, static_cast<std::uint8_t>(error));
+    endFrame(outBytes, start);
+}
+
+void SessionProtocol::appendCreateRequest(std::uint16_t level, std::uint32_t seed, std::vector<unsigned char>& outBytes)
+{
+    const std::size_t start = beginFrame(outBytes, Opcode::Create);
+    putU16(outBytes, level);
+    putU32(outBytes, seed);
+    endFrame(outBytes, start);
+}
+
+std::size_t SessionProtocol::appendApplyRequest(std::uint32_t session, const InputCommand* moves, std::size_t count,
+                                                std::vector<unsigned char>& outBytes)
+{
+    count = std::min(count, kMaxMovesPerApply);
+    const std::size_t start = beginFrame(outBytes, Opcode::Apply);
+    putU32(outBytes, session);
+    putU16(outBytes, static_cast<std::uint16_t>(count));
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        switch (moves[index].type)
+        {
+        case InputCommand::Type::CardTap:
+            putU8(outBytes, kMoveCard);
+            putU16(outBytes, static_cast<std::uint16_t>(moves[index].cardId));
+            break;
+        case InputCommand::Type::StockTap:
+            putU8(outBytes, kMoveStock);
+            break;
+        default:
+            putU8(outBytes, kMoveUndo);
+            break;
+        }
+    }
+    endFrame(outBytes, start);
+    return count;
+}
+
+void SessionProtocol::appendSessionRequest(Opcode opcode, std::uint32_t session, std::vector<unsigned char>& outBytes)
+{
+    const std::size_t start = beginFrame(outBytes, opcode);
+    putU32(outBytes, session);
+    endFrame(outBytes, start);
+}
+
+SessionProtocol::DecodeStatus SessionProtocol::decodeResponse(const unsigned char* data, std::size_t size,
+                                                              Response& outResponse, std::size_t& outConsumed)
+{
+    std::uint8_t opcode = 0;
+    const unsigned char* payload = nullptr;
+    std::size_t payloadSize = 0;
+    const DecodeStatus frameStatus = readFrame(data, size, opcode, payload, payloadSize, outConsumed);
+    if (frameStatus != DecodeStatus::Complete)
+    {
+        return frameStatus;
+    }
+
+    PayloadReader reader(payload, payloadSize);
+    if (opcode == static_cast<std::uint8_t>(Opcode::Error))
+    {
+        std::uint8_t error = 0;
+        if (!reader.readU8(error) || !reader.atEnd())
+        {
+            return DecodeStatus::Malformed;
+        }
+        outResponse.opcode = Opcode::Error;
+        outResponse.error = static_cast<ErrorCode>(error);
+        return DecodeStatus::Complete;
+    }
+
+    if ((opcode & kResponseFlag) == 0 || payloadSize != kStatePayloadSize)
+    {
+        return DecodeStatus::Malformed;
+    }
+    std::uint8_t flags = 0;
+    std::uint8_t gameState = 0;
+    State& state = outResponse.state;
+    reader.readU32(state.session);
+    reader.readU8(flags);
+    reader.readU16(state.applied);
+    reader.readU32(state.moveCount);
+    reader.readU8(gameState);
+    reader.readU64(state.stateHash);
+    if (!reader.atEnd() || gameState > static_cast<std::uint8_t>(GameState::Lost))
+    {
+        return DecodeStatus::Malformed;
+    }
+    outResponse.opcode = static_cast<Opcode>(opcode & ~kResponseFlag);
+    state.found = (flags & kStateFound) != 0;
+    state.gameState = static_cast<GameState>(gameState);
+    return DecodeStatus::Complete;
+}
+
+} // namespace tripeaks
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "models/BoardEvent.h"
+#include "models/InputCommand.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 无界面会话服务的二进制协议（本机套接字，小端）。
+ * 每帧 = u16 负载长度 + u8 操作码 + 负载；请求与应答一一对应，同一连接上按请求顺序应答。
+ *   Create  (1): u16 关卡编号, u32 种子
+ *   Apply   (2): u32 会话, u16 走法数, 走法...；走法为 u8 类型（0 抽牌, 1 回退, 2 点击桌面牌 + u16 cardId）
+ *   Query   (3): u32 会话
+ *   Destroy (4): u32 会话
+ * 应答操作码 = 请求操作码 | 0x80，负载为会话状态（20字节）；无法解析的请求应答 Error (0xFF) + u8 错误码后关闭连接。
+ * 只做内存中的编解码，解码直接读取连接的接收缓冲区，不复制帧。
+ */
+class SessionProtocol
+{
+public:
+    enum class Opcode : std::uint8_t
+    {
+        Create = 1,
+        Apply = 2,
+        Query = 3,
+        Destroy = 4,
+        Error = 0xFF
+    };
+
+    enum class ErrorCode : std::uint8_t
+    {
+        UnknownOpcode = 1,
+        MalformedPayload = 2
+    };
+
+    enum class DecodeStatus
+    {
+        Complete,
+        NeedMore,
+        Malformed
+    };
+
+    static constexpr std::size_t kFrameHeaderSize = 3;
+    static constexpr std::size_t kMaxPayloadSize = 0xFFFF;
+    static constexpr std::uint8_t kResponseFlag = 0x80;
+    // 点击桌面牌占3字节，一帧最多容纳的走法数
+    static constexpr std::size_t kMaxMovesPerApply = (kMaxPayloadSize - 6) / 3;
+
+    struct Request
+    {
+        Opcode opcode = Opcode::Query;
+        std::uint16_t level = 0;
+        std::uint32_t seed = 0;
+        std::uint32_t session = 0;
+        std::vector<InputCommand> moves;    // Apply
+    };
+
+    struct State
+    {
+        std::uint32_t session = 0;
+        bool found = false;
+        std::uint16_t applied = 0;
+        std::uint32_t moveCount = 0;
+        GameState gameState = GameState::Playing;
+        std::uint64_t stateHash = 0;
+    };
+
+    struct Response
+    {
+        Opcode opcode = Opcode::Error;      // 去掉 kResponseFlag 后的请求操作码
+        ErrorCode error = ErrorCode::UnknownOpcode;
+        State state;
+    };
+
+    // 服务端：从缓冲区开头解码一个请求，Complete 时 outConsumed 为该帧的字节数
+    static DecodeStatus decodeRequest(const unsigned char* data, std::size_t size, Request& outRequest,
+                                      std::size_t& outConsumed, ErrorCode* outError = nullptr);
+    static void appendStateResponse(Opcode opcode, const State& state, std::vector<unsigned char>& outBytes);
+    static void appendErrorResponse(ErrorCode error, std::vector<unsigned char>& outBytes);
+
+    // 客户端（后端、压测工具）
+    static void appendCreateRequest(std::uint16_t level, std::uint32_t seed, std::vector<unsigned char>& outBytes);
+    // 超出 kMaxMovesPerApply 的部分不编码，返回本帧编码的走法数
+    static std::size_t appendApplyRequest(std::uint32_t session, const InputCommand* moves, std::size_t count,
+                                          std::vector<unsigned char>& outBytes);
+    static void appendSessionRequest(Opcode opcode, std::uint32_t session, std::vector<unsigned char>& outBytes);
+    static DecodeStatus decodeResponse(const unsigned char* data, std::size_t size, Response& outResponse,
+                                       std::size_t& outConsumed);
+};
+
+} // namespace tripeaks
@@ -0,0 +1,439 @@
+#include "services/SessionSerializer.h"
+
+#include "utils/HashUtils.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+const char kSnapshotMagic[4] = {'T', 'P', 'S', 'S'};
+const char kJournalMagic[4] = {'T', 'P', 'J', 'L'};
+constexpr std::uint32_t kSnapshotVersion = 2;
+constexpr std::uint32_t kJournalVersion = 1;
+
+constexpr unsigned char kCardFaceUp = 1U << 0;
+constexpr unsigned char kCardRemoved = 1U << 1;
+constexpr unsigned char kCardInPlayfield = 1U << 2;
+
+// 快照文件 = 固定头 + 载荷
+struct SnapshotHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t levelHash;
+    std::uint64_t sequence;
+    std::uint32_t payloadSize;
+    std::uint32_t payloadChecksum;
+};
+static_assert(sizeof(SnapshotHeader) == 32, "snapshot header layout must stay fixed");
+
+// 日志文件 = 固定头 + 若干条定长记录
+struct JournalHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t levelHash;
+    std::uint64_t baseSequence;     // 对应快照的序号，之后的记录从 baseSequence + 1 开始
+};
+static_assert(sizeof(JournalHeader) == 24, "journal header layout must stay fixed");
+
+struct JournalRecord
+{
+    std::uint64_t sequence;
+    std::uint32_t type;
+    std::int32_t cardId;
+    std::uint32_t checksum;         // 前三个字段的校验和
+    std::uint32_t reserved;
+};
+static_assert(sizeof(JournalRecord) == 24, "journal record layout must stay fixed");
+
+std::uint32_t checksumRecord(const JournalRecord& record)
+{
+    return HashUtils::fnv1a32(&record, offsetof(JournalRecord, checksum));
+}
+
+template <typename T>
+void writeValue(std::vector<unsigned char>& bytes, const T& value)
+{
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(&value);
+    bytes.insert(bytes.end(), data, data + sizeof(T));
+}
+
+/**
+ * 带边界检查的顺序读取，越界后所有读取都失败
+ */
+class ByteReader
+{
+public:
+    ByteReader(const unsigned char* data, std::size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    template <typename T>
+    bool read(T& outValue)
+    {
+        if (_failed || _size - _offset < sizeof(T))
+        {
+            _failed = true;
+            return false;
+        }
+        std::memcpy(&outValue, _data + _offset, sizeof(T));
+        _offset += sizeof(T);
+        return true;
+    }
+
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _offset == _size; }
+
+private:
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _offset = 0;
+    bool _failed = false;
+};
+
+void setError(std::string* errorMessage, const char* message)
+{
+    if (errorMessage)
+    {
+        *errorMessage = message;
+    }
+}
+
+void writeCardIds(std::vector<unsigned char>& bytes, const std::vector<int>& cardIds)
+{
+    writeValue(bytes, static_cast<std::uint32_t>(cardIds.size()));
+    for (int cardId : cardIds)
+    {
+        writeValue(bytes, static_cast<std::int32_t>(cardId));
+    }
+}
+
+bool readCardIds(ByteReader& reader, const GameModel& model, std::vector<int>& outCardIds)
+{
+    std::uint32_t count = 0;
+    if (!reader.read(count) || count > model.getCards().size())
+    {
+        return false;
+    }
+    outCardIds.clear();
+    outCardIds.reserve(count);
+    for (std::uint32_t index = 0; index < count; ++index)
+    {
+        std::int32_t cardId = -1;
+        if (!reader.read(cardId) || !model.getCardById(cardId))
+        {
+            return false;
+        }
+        outCardIds.emplace_back(cardId);
+    }
+    return true;
+}
+
+} // namespace
+
+std::uint64_t SessionSerializer::computeLevelHash(const LevelConfig& config)
+{
+    std::uint64_t hash = HashUtils::kFnv1a64Basis;
+    const auto mix = [&hash](const void* data, std::size_t size) { HashUtils::mixFnv1a64(hash, data, size); };
+    const auto mixCards = [&mix](const std::vector<LevelCardConfig>& cards) {
+        const std::uint32_t count = static_cast<std::uint32_t>(cards.size());
+        mix(&count, sizeof(count));
+        for (const LevelCardConfig& card : cards)
+        {
+            mix(&card.cardFace, sizeof(card.cardFace));
+            mix(&card.cardSuit, sizeof(card.cardSuit));
+            mix(&card.position.x, sizeof(card.position.x));
+            mix(&card.position.y, sizeof(card.position.y));
+            const unsigned char faceUp = card.faceUp ? 1 : 0;
+            mix(&faceUp, sizeof(faceUp));
+            const std::uint32_t coveredCount = static_cast<std::uint32_t>(card.coveredBy.size());
+            mix(&coveredCount, sizeof(coveredCount));
+            if (!card.coveredBy.empty())
+            {
+                mix(card.coveredBy.data(), card.coveredBy.size() * sizeof(int));
+            }
+        }
+    };
+    mixCards(config.playfieldCards);
+    mixCards(config.stackCards);
+    mix(&config.stockRecycles, sizeof(config.stockRecycles));
+    // 同一布局换一种配对规则就是另一关，旧存档中的走法在新规则下可能不合法
+    const std::int32_t matchRule = static_cast<std::int32_t>(config.matchRule);
+    mix(&matchRule, sizeof(matchRule));
+    return hash;
+}
+
+void SessionSerializer::writeSnapshot(const GameModel& model, const std::vector<UndoMove>& undoMoves,
+                                      std::uint64_t levelHash, std::uint64_t sequence,
+                                      std::vector<unsigned char>& outBytes)
+{
+    outBytes.clear();
+    outBytes.resize(sizeof(SnapshotHeader));
+
+    const std::vector<Card>& cards = model.getCards();
+    writeValue(outBytes, static_cast<std::uint32_t>(cards.size()));
+    for (const Card& card : cards)
+    {
+        writeValue(outBytes, static_cast<std::int32_t>(card.id));
+        writeValue(outBytes, static_cast<unsigned char>(card.face));
+        writeValue(outBytes, static_cast<unsigned char>(card.suit));
+        writeValue(outBytes, static_cast<unsigned char>((card.faceUp ? kCardFaceUp : 0)
+                                                        | (card.removed ? kCardRemoved : 0)
+                                                        | (card.isInPlayfield ? kCardInPlayfield : 0)));
+    }
+    writeCardIds(outBytes, model.getPlayfieldCardIds());
+    writeCardIds(outBytes, model.getStockCardIds());
+    writeCardIds(outBytes, model.getWastePileIds());
+    writeValue(outBytes, static_cast<std::int32_t>(model.getTrayCardId()));
+    writeValue(outBytes, static_cast<std::int32_t>(model.getStockRecycleCount()));
+
+    writeValue(outBytes, static_cast<std::uint32_t>(undoMoves.size()));
+    for (const UndoMove& move : undoMoves)
+    {
+        writeValue(outBytes, static_cast<unsigned char>(move.type));
+        writeValue(outBytes, static_cast<std::int32_t>(move.movedCardId));
+        writeValue(outBytes, static_cast<std::int32_t>(move.previousTrayCardId));
+        writeValue(outBytes, static_cast<std::int32_t>(move.previousPlayfieldIndex));
+        writeValue(outBytes, static_cast<std::int32_t>(move.previousStockIndex));
+        writeValue(outBytes, static_cast<std::uint32_t>(move.flipStates.size()));
+        for (const CardFlipState& flip : move.flipStates)
+        {
+            writeValue(outBytes, static_cast<std::int32_t>(flip.cardId));
+            writeValue(outBytes, static_cast<unsigned char>(flip.previousFaceUp ? 1 : 0));
+        }
+    }
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.levelHash = levelHash;
+    header.sequence = sequence;
+    header.payloadSize = static_cast<std::uint32_t>(outBytes.size() - sizeof(SnapshotHeader));
+    header.payloadChecksum = HashUtils::fnv1a32(outBytes.data() + sizeof(SnapshotHeader), header.payloadSize);
+    std::memcpy(outBytes.data(), &header, sizeof(header));
+}
+
+bool SessionSerializer::readSnapshot(const std::vector<unsigned char>& bytes, std::uint64_t levelHash,
+                                     GameModel& model, std::vector<UndoMove>& outUndoMoves,
+                                     std::uint64_t& outSequence, std::string* errorMessage)
+{
+    SnapshotHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        setError(errorMessage, "Session snapshot is truncated");
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || header.version != kSnapshotVersion)
+    {
+        setError(errorMessage, "Session snapshot has an unknown format");
+        return false;
+    }
+    if (header.levelHash != levelHash)
+    {
+        setError(errorMessage, "Session snapshot belongs to another level");
+        return false;
+    }
+    if (header.payloadSize != bytes.size() - sizeof(header)
+        || header.payloadChecksum != HashUtils::fnv1a32(bytes.data() + sizeof(header), header.payloadSize))
+    {
+        setError(errorMessage, "Session snapshot is corrupted");
+        return false;
+    }
+
+    // 先完整解析到临时变量，全部有效后才修改模型
+    ByteReader reader(bytes.data() + sizeof(header), header.payloadSize);
+    std::uint32_t cardCount = 0;
+    reader.read(cardCount);
+    if (reader.failed() || cardCount != model.getCards().size())
+    {
+        setError(errorMessage, "Session snapshot does not match the level layout");
+        return false;
+    }
+
+    struct CardState
+    {
+        std::int32_t id = -1;
+        unsigned char face = 0;
+        unsigned char suit = 0;
+        unsigned char flags = 0;
+    };
+    std::vector<CardState> cardStates(cardCount);
+    for (CardState& state : cardStates)
+    {
+        reader.read(state.id);
+        reader.read(state.face);
+        reader.read(state.suit);
+        reader.read(state.flags);
+        const Card* card = model.getCardById(state.id);
+        if (reader.failed() || !card || state.face > static_cast<unsigned char>(CardFaceType::King)
+            || state.suit > static_cast<unsigned char>(CardSuit::Spades)
+            || ((state.flags & kCardInPlayfield) != 0) != card->isInPlayfield)
+        {
+            setError(errorMessage, "Session snapshot does not match the level layout");
+            return false;
+        }
+    }
+
+    std::vector<int> playfieldIds;
+    std::vector<int> stockIds;
+    std::vector<int> wasteIds;
+    std::int32_t trayCardId = -1;
+    std::int32_t recycleCount = 0;
+    if (!readCardIds(reader, model, playfieldIds) || !readCardIds(reader, model, stockIds)
+        || !readCardIds(reader, model, wasteIds) || !reader.read(trayCardId)
+        || (trayCardId >= 0 && !model.getCardById(trayCardId)) || !reader.read(recycleCount) || recycleCount < 0
+        || stockIds.size() + wasteIds.size() > cardCount)
+    {
+        setError(errorMessage, "Session snapshot is corrupted");
+        return false;
+    }
+
+    std::uint32_t undoCount = 0;
+    reader.read(undoCount);
+    std::vector<UndoMove> undoMoves;
+    for (std::uint32_t index = 0; index < undoCount && !reader.failed(); ++index)
+    {
+        UndoMove move;
+        unsigned char type = 0;
+        std::int32_t movedCardId = -1;
+        std::int32_t previousTrayCardId = -1;
+        std::int32_t previousPlayfieldIndex = -1;
+        std::int32_t previousStockIndex = -1;
+        std::uint32_t flipCount = 0;
+        reader.read(type);
+        reader.read(movedCardId);
+        reader.read(previousTrayCardId);
+        reader.read(previousPlayfieldIndex);
+        reader.read(previousStockIndex);
+        reader.read(flipCount);
+        if (reader.failed() || type > static_cast<unsigned char>(UndoMove::Type::RecycleWaste)
+            || flipCount > cardCount)
+        {
+            setError(errorMessage, "Session snapshot is corrupted");
+            return false;
+        }
+        move.type = static_cast<UndoMove::Type>(type);
+        move.movedCardId = movedCardId;
+        move.previousTrayCardId = previousTrayCardId;
+        move.previousPlayfieldIndex = previousPlayfieldIndex;
+        move.previousStockIndex = previousStockIndex;
+        move.flipStates.resize(flipCount);
+        for (CardFlipState& flip : move.flipStates)
+        {
+            std::int32_t cardId = -1;
+            unsigned char previousFaceUp = 0;
+            reader.read(cardId);
+            reader.read(previousFaceUp);
+            flip.cardId = cardId;
+            flip.previousFaceUp = previousFaceUp != 0;
+        }
+        undoMoves.emplace_back(std::move(move));
+    }
+    if (reader.failed() || !reader.atEnd())
+    {
+        setError(errorMessage, "Session snapshot is corrupted");
+        return false;
+    }
+
+    for (const CardState& state : cardStates)
+    {
+        model.setCardFaceAndSuit(state.id, static_cast<CardFaceType>(state.face), static_cast<CardSuit>(state.suit));
+        model.setCardFaceUp(state.id, (state.flags & kCardFaceUp) != 0);
+        model.setCardRemoved(state.id, (state.flags & kCardRemoved) != 0);
+    }
+    model.setPlayfieldCardIds(std::move(playfieldIds));
+    // 按元素赋值，保留模型生成时预留的容量
+    model.getStockCardIds().assign(stockIds.begin(), stockIds.end());
+    model.getWastePileIds().assign(wasteIds.begin(), wasteIds.end());
+    model.setTrayCard(trayCardId);
+    model.setStockRecycleCount(recycleCount);
+
+    outUndoMoves = std::move(undoMoves);
+    outSequence = header.sequence;
+    return true;
+}
+
+void SessionSerializer::writeJournalHeader(std::uint64_t levelHash, std::uint64_t baseSequence,
+                                           std::vector<unsigned char>& outBytes)
+{
+    JournalHeader header;
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    header.levelHash = levelHash;
+    header.baseSequence = baseSequence;
+    writeValue(outBytes, header);
+}
+
+void SessionSerializer::appendJournalRecord(std::uint64_t sequence, const InputCommand& command,
+                                            std::vector<unsigned char>& outBytes)
+{
+    JournalRecord record;
+    record.sequence = sequence;
+    record.type = static_cast<std::uint32_t>(command.type);
+    record.cardId = command.cardId;
+    record.checksum = 0;
+    record.reserved = 0;
+    record.checksum = checksumRecord(record);
+    writeValue(outBytes, record);
+}
+
+bool SessionSerializer::readJournal(const std::vector<unsigned char>& bytes, std::uint64_t levelHash,
+                                    std::uint64_t afterSequence, std::vector<InputCommand>& outCommands,
+                                    std::string* errorMessage)
+{
+    outCommands.clear();
+
+    JournalHeader header;
+    if (bytes.size() < sizeof(header))
+    {
+        setError(errorMessage, "Session journal is truncated");
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) != 0 || header.version != kJournalVersion
+        || header.levelHash != levelHash)
+    {
+        setError(errorMessage, "Session journal does not belong to this level");
+        return false;
+    }
+
+    std::uint64_t expectedSequence = afterSequence + 1;
+    for (std::size_t offset = sizeof(header); offset + sizeof(JournalRecord) <= bytes.size();
+         offset += sizeof(JournalRecord))
+    {
+        JournalRecord record;
+        std::memcpy(&record, bytes.data() + offset, sizeof(record));
+        if (record.checksum != checksumRecord(record)
+            || record.type > static_cast<std::uint32_t>(InputCommand::Type::Undo))
+        {
+            break;
+        }
+        // 快照已覆盖的记录（快照写入后、日志截断前崩溃时会残留）直接跳过
+        if (record.sequence < expectedSequence)
+        {
+            continue;
+        }
+        if (record.sequence != expectedSequence)
+        {
+            break;
+        }
+
+        InputCommand command;
+        command.type = static_cast<InputCommand::Type>(record.type);
+        command.cardId = record.cardId;
+        outCommands.emplace_back(command);
+        ++expectedSequence;
+    }
+    return true;
+}
+
+} // namespace tripeaks
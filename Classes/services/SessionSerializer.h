@@ -0,0 +1,53 @@
+#pragma once
+
+#include "configs/models/LevelConfig.h"
+#include "models/GameModel.h"
+#include "models/InputCommand.h"
+#include "models/UndoMove.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 会话存档的二进制编解码。
+ * 快照只记录一局中会变化的状态（点数花色、翻面/移除标记、桌面/备用牌堆/弃牌堆顺序、手牌、翻回次数、回退栈），
+ * 卡牌位置与覆盖关系由关卡配置重新生成，恢复时先 generateFromConfig 再套用快照。
+ * 日志由固定长度的输入记录组成，每条带序号与校验和，进程被杀时写了一半的尾部记录在读取时被丢弃。
+ * 只做内存中的编解码，不访问文件。
+ */
+class SessionSerializer
+{
+public:
+    // 关卡配置的哈希，存档与当前关卡不一致时拒绝恢复
+    static std::uint64_t computeLevelHash(const LevelConfig& config);
+
+    static void writeSnapshot(const GameModel& model, const std::vector<UndoMove>& undoMoves,
+                              std::uint64_t levelHash, std::uint64_t sequence, std::vector<unsigned char>& outBytes);
+
+    /**
+     * 把快照套用到已由同一关卡配置生成的模型上
+     * @param outSequence 快照覆盖到的最后一条日志序号
+     */
+    static bool readSnapshot(const std::vector<unsigned char>& bytes, std::uint64_t levelHash, GameModel& model,
+                             std::vector<UndoMove>& outUndoMoves, std::uint64_t& outSequence,
+                             std::string* errorMessage = nullptr);
+
+    static void writeJournalHeader(std::uint64_t levelHash, std::uint64_t baseSequence,
+                                   std::vector<unsigned char>& outBytes);
+    static void appendJournalRecord(std::uint64_t sequence, const InputCommand& command,
+                                    std::vector<unsigned char>& outBytes);
+
+    /**
+     * 读取日志中序号紧接 afterSequence 的连续记录，遇到残缺、校验失败或序号不连续的记录即停止
+     * @return 日志头无效或属于其他关卡时返回false
+     */
+    static bool readJournal(const std::vector<unsigned char>& bytes, std::uint64_t levelHash,
+                            std::uint64_t afterSequence, std::vector<InputCommand>& outCommands,
+                            std::string* errorMessage = nullptr);
+};
+
+} // namespace tripeaks
@@ -0,0 +1,241 @@
+#include "services/TriPeaksLayoutGenerator.h"
+
+#include "models/MatchRule.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <sstream>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr int kCardsPerDeck = 52;
+
+// 从若干副洗好的牌中依次发牌，保证点数花色分布与真实牌组一致
+class DeckDealer
+{
+public:
+    explicit DeckDealer(unsigned int seed)
+        : _engine(seed)
+    {
+        for (int i = 0; i < kCardsPerDeck; ++i)
+        {
+            _deck[i] = i;
+        }
+        _next = kCardsPerDeck;
+    }
+
+    void deal(LevelCardConfig& config)
+    {
+        if (_next >= kCardsPerDeck)
+        {
+            std::shuffle(_deck.begin(), _deck.end(), _engine);
+            _next = 0;
+        }
+        const int value = _deck[_next++];
+        config.cardFace = value % 13;
+        config.cardSuit = value / 13;
+    }
+
+private:
+    std::mt19937 _engine;
+    std::array<int, kCardsPerDeck> _deck;
+    int _next = 0;
+};
+
+bool validateOptions(const TriPeaksLayoutOptions& options, std::string* errorMessage)
+{
+    const char* error = nullptr;
+    if (options.peakCount < 1)
+    {
+        error = "peakCount must be at least 1";
+    }
+    else if (options.peakDepth < 1)
+    {
+        error = "peakDepth must be at least 1";
+    }
+    else if (options.peakOverlap < 0 || options.peakOverlap >= options.peakDepth)
+    {
+        error = "peakOverlap must be in [0, peakDepth - 1]";
+    }
+    else if (options.stockCount < 0)
+    {
+        error = "stockCount must not be negative";
+    }
+    else if (options.stockRecycles < -1)
+    {
+        error = "stockRecycles must be -1 or greater";
+    }
+
+    if (error && errorMessage)
+    {
+        *errorMessage = error;
+    }
+    return error == nullptr;
+}
+
+} // namespace
+
+bool TriPeaksLayoutGenerator::generate(const TriPeaksLayoutOptions& options,
+                                       LevelConfig& outConfig,
+                                       std::string* errorMessage)
+{
+    if (!validateOptions(options, errorMessage))
+    {
+        return false;
+    }
+
+    // 卡牌位置以半列为单位：第r行第c张牌位于 2*stride*peak + (depth-1-r) + 2c，
+    // 被下一行 ±1 半列处的两张牌覆盖。相邻山峰落在同一半列的牌合并为一张共享牌。
+    const int depth = options.peakDepth;
+    const int stride = depth - options.peakOverlap;
+    const int columnCount = 2 * stride * (options.peakCount - 1) + 2 * (depth - 1) + 1;
+
+    std::vector<int> cellIds(static_cast<std::size_t>(depth) * columnCount, -1);
+    auto cellAt = [&](int row, int column) -> int& {
+        return cellIds[static_cast<std::size_t>(row) * columnCount + column];
+    };
+
+    outConfig.playfieldCards.clear();
+    outConfig.stackCards.clear();
+    outConfig.stockRecycles = options.stockRecycles;
+    outConfig.matchRule = options.matchRule;
+    outConfig.playfieldCards.reserve(static_cast<std::size_t>(options.peakCount) * depth * (depth + 1) / 2);
+
+    DeckDealer dealer(options.seed);
+    const float centerColumn = static_cast<float>(columnCount - 1) * 0.5F;
+
+    for (int row = 0; row < depth; ++row)
+    {
+        for (int peak = 0; peak < options.peakCount; ++peak)
+        {
+            const int firstColumn = 2 * stride * peak + (depth - 1 - row);
+            for (int index = 0; index <= row; ++index)
+            {
+                int& cell = cellAt(row, firstColumn + 2 * index);
+                if (cell >= 0)
+                {
+                    continue;
+                }
+
+                cell = static_cast<int>(outConfig.playfieldCards.size());
+
+                LevelCardConfig config;
+                config.position.x = (firstColumn + 2 * index - centerColumn) * options.columnSpacing * 0.5F;
+                config.position.y = options.topY - row * options.rowSpacing;
+                config.faceUp = row == depth - 1;
+                if (options.randomizeCards)
+                {
+                    dealer.deal(config);
+                }
+                outConfig.playfieldCards.emplace_back(std::move(config));
+            }
+        }
+    }
+
+    for (int row = 0; row + 1 < depth; ++row)
+    {
+        for (int column = 0; column < columnCount; ++column)
+        {
+            const int cardId = cellAt(row, column);
+            if (cardId < 0)
+            {
+                continue;
+            }
+
+            auto& coveredBy = outConfig.playfieldCards[cardId].coveredBy;
+            if (column > 0 && cellAt(row + 1, column - 1) >= 0)
+            {
+                coveredBy.emplace_back(cellAt(row + 1, column - 1));
+            }
+            if (column + 1 < columnCount && cellAt(row + 1, column + 1) >= 0)
+            {
+                coveredBy.emplace_back(cellAt(row + 1, column + 1));
+            }
+        }
+    }
+
+    outConfig.stackCards.resize(static_cast<std::size_t>(options.stockCount));
+    if (options.randomizeCards)
+    {
+        for (LevelCardConfig& config : outConfig.stackCards)
+        {
+            dealer.deal(config);
+        }
+    }
+
+    return true;
+}
+
+bool TriPeaksLayoutGenerator::generateJson(const TriPeaksLayoutOptions& options,
+                                           std::string& outJson,
+                                           std::string* errorMessage)
+{
+    LevelConfig config;
+    if (!generate(options, config, errorMessage))
+    {
+        return false;
+    }
+
+    outJson = toJson(config);
+    return true;
+}
+
+std::string TriPeaksLayoutGenerator::toJson(const LevelConfig& config)
+{
+    std::ostringstream oss;
+    oss.precision(9);
+
+    auto writeCards = [&oss](const std::vector<LevelCardConfig>& cards) {
+        oss << '[';
+        for (std::size_t i = 0; i < cards.size(); ++i)
+        {
+            const LevelCardConfig& card = cards[i];
+            if (i > 0)
+            {
+                oss << ',';
+            }
+            oss << "\n    {\"CardFace\":" << card.cardFace
+                << ",\"CardSuit\":" << card.cardSuit
+                << ",\"FaceUp\":" << (card.faceUp ? "true" : "false")
+                << ",\"Position\":{\"x\":" << card.position.x << ",\"y\":" << card.position.y << '}';
+            if (!card.coveredBy.empty())
+            {
+                oss << ",\"coveredBy\":[";
+                for (std::size_t j = 0; j < card.coveredBy.size(); ++j)
+                {
+                    if (j > 0)
+                    {
+                        oss << ',';
+                    }
+                    oss << card.coveredBy[j];
+                }
+                oss << ']';
+            }
+            oss << '}';
+        }
+        oss << (cards.empty() ? "]" : "\n  ]");
+    };
+
+    oss << "{\n  \"playfieldCards\": ";
+    writeCards(config.playfieldCards);
+    oss << ",\n  \"stackCards\": ";
+    writeCards(config.stackCards);
+    if (config.stockRecycles != 0)
+    {
+        oss << ",\n  \"stockRecycles\": " << config.stockRecycles;
+    }
+    if (config.matchRule != MatchRule::TriPeaks)
+    {
+        oss << ",\n  \"matchRule\": \"" << getMatchRuleName(config.matchRule) << '"';
+    }
+    oss << "\n}\n";
+
+    return oss.str();
+}
+
+} // namespace tripeaks
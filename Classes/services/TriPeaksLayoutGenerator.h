@@ -0,0 +1,60 @@
+#pragma once
+
+#include "configs/models/LevelConfig.h"
+
+#include <string>
+
+namespace tripeaks
+{
+
+// 程序化布局参数：N个山峰、每峰层数、相邻山峰共享的底部列数以及stock张数
+struct TriPeaksLayoutOptions
+{
+    int peakCount = 3;              // 山峰数量，>= 1
+    int peakDepth = 4;              // 每个山峰的层数（含峰顶），>= 1
+    int peakOverlap = 1;            // 相邻山峰共享的底部列数，0 ~ peakDepth-1
+    int stockCount = 24;            // stock牌数量，>= 0
+    int stockRecycles = 0;          // stock用完后弃牌堆可翻回的次数，-1 表示不限
+    MatchRule matchRule = MatchRule::TriPeaks;  // 配对规则（玩法变体）
+    float columnSpacing = 110.0F;   // 同一行相邻卡牌的水平间距
+    float rowSpacing = 70.0F;       // 相邻两行的垂直间距
+    float topY = 600.0F;            // 峰顶所在行的y坐标（布局水平居中于x=0）
+    bool randomizeCards = true;     // true: 按seed洗牌分配点数花色; false: 保留-1由模型生成器随机
+    unsigned int seed = 1;          // 洗牌随机种子，相同参数+种子生成相同关卡
+};
+
+/**
+ * 程序化生成TriPeaks风格关卡的服务，用于规模测试和压力测试。
+ * 默认参数（3峰、4层、共享1列）生成与标准TriPeaks一致的28张桌面牌。
+ * 生成结果的卡牌ID顺序与 GameModel::addCard 一致（先桌面牌后stock牌），
+ * 可直接交给 GameModelFromLevelGenerator::generateFromConfig，或序列化为加载器可读取的JSON。
+ * 复杂度与卡牌数量线性相关，可在毫秒级生成数万张卡牌的布局。
+ */
+class TriPeaksLayoutGenerator
+{
+public:
+    /**
+     * 生成关卡配置
+     * @param options 布局参数
+     * @param outConfig 输出的关卡配置
+     * @param errorMessage 参数非法时输出错误信息，可为空
+     * @return 参数合法并生成成功返回true
+     */
+    static bool generate(const TriPeaksLayoutOptions& options,
+                         LevelConfig& outConfig,
+                         std::string* errorMessage = nullptr);
+
+    /**
+     * 生成关卡并输出为 LevelConfigLoader 可读取的JSON文本
+     */
+    static bool generateJson(const TriPeaksLayoutOptions& options,
+                             std::string& outJson,
+                             std::string* errorMessage = nullptr);
+
+    /**
+     * 将关卡配置序列化为 LevelConfigLoader 可读取的JSON文本
+     */
+    static std::string toJson(const LevelConfig& config);
+};
+
+} // namespace tripeaks
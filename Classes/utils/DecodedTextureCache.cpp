@@ -0,0 +1,324 @@
+#include "utils/DecodedTextureCache.h"
+
+#include "utils/HashUtils.h"
+#include "utils/TraceRecorder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tripeaks
+{
+
+namespace
+{
+
+const char kCacheMagic[4] = {'T', 'P', 'D', 'T'};
+constexpr std::uint32_t kCacheVersion = 1;
+constexpr std::uint32_t kFlagPremultiplied = 1U << 0;
+constexpr std::uint32_t kFlagPadded = 1U << 1;
+constexpr std::uint32_t kBytesPerPixel = 4;
+
+// 缓存文件 = 固定头 + 自上而下逐行存储的 RGBA8888 像素
+struct CacheHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t sourceHash;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 32, "cache header layout must stay fixed");
+
+std::uint32_t nextPowerOfTwo(std::uint32_t value)
+{
+    std::uint32_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * 只读映射整个文件；不支持 mmap 的平台退化为整体读入内存
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (file)
+        {
+            _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            _data = reinterpret_cast<const unsigned char*>(_buffer.data());
+            _size = _buffer.size();
+        }
+#else
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return;
+        }
+        struct stat info;
+        if (::fstat(descriptor, &info) == 0 && info.st_size > 0)
+        {
+            void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE,
+                                   descriptor, 0);
+            if (mapping != MAP_FAILED)
+            {
+                _data = static_cast<const unsigned char*>(mapping);
+                _size = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        ::close(descriptor);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (_data)
+        {
+            ::munmap(const_cast<unsigned char*>(_data), _size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+private:
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+#ifdef _WIN32
+    std::vector<char> _buffer;
+#endif
+};
+
+} // namespace
+
+DecodedTextureCache::DecodedTextureCache(std::string directory)
+    : DecodedTextureCache(std::move(directory), Options())
+{
+}
+
+DecodedTextureCache::DecodedTextureCache(std::string directory, Options options)
+    : _directory(std::move(directory))
+    , _options(options)
+{
+    if (!_directory.empty() && _directory.back() != '/')
+    {
+        _directory += '/';
+    }
+    // FileUtils 的目录操作不保证线程安全，在构造时（主线程）准备好目录
+    cocos2d::FileUtils::getInstance()->createDirectory(_directory);
+}
+
+std::string DecodedTextureCache::getDefaultDirectory()
+{
+    return cocos2d::FileUtils::getInstance()->getWritablePath() + "decoded_textures/";
+}
+
+cocos2d::Image* DecodedTextureCache::loadImage(const std::string& fullPath, bool* fromCache,
+                                               std::string* errorMessage) const
+{
+    if (fromCache)
+    {
+        *fromCache = false;
+    }
+
+    const cocos2d::Data source = cocos2d::FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (source.isNull())
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Failed to read image: " + fullPath;
+        }
+        return nullptr;
+    }
+
+    const std::uint64_t sourceHash = HashUtils::fnv1a64(source.getBytes(), static_cast<std::size_t>(source.getSize()));
+    const std::string cachePath = getCachePath(fullPath);
+    if (cocos2d::Image* cached = loadCachedImage(cachePath, sourceHash))
+    {
+        if (fromCache)
+        {
+            *fromCache = true;
+        }
+        return cached;
+    }
+
+    auto image = new (std::nothrow) cocos2d::Image();
+    bool decoded = false;
+    {
+        TRIPEAKS_TRACE_SCOPE("startup", "decodePng");
+        decoded = image && image->initWithImageData(source.getBytes(), source.getSize());
+    }
+    if (!decoded)
+    {
+        CC_SAFE_RELEASE(image);
+        if (errorMessage)
+        {
+            *errorMessage = "Failed to decode image: " + fullPath;
+        }
+        return nullptr;
+    }
+
+    // 缓存写入失败不影响本次加载，下次启动会再次尝试
+    std::string writeError;
+    if (!writeCachedImage(cachePath, sourceHash, image, &writeError))
+    {
+        CCLOG("DecodedTextureCache: %s", writeError.c_str());
+        return image;
+    }
+
+    // 补齐尺寸时改用刚写入的缓存，保证首次与后续启动得到相同尺寸的纹理
+    if (_options.padToPowerOfTwo)
+    {
+        if (cocos2d::Image* padded = loadCachedImage(cachePath, sourceHash))
+        {
+            image->release();
+            return padded;
+        }
+    }
+    return image;
+}
+
+std::string DecodedTextureCache::getCachePath(const std::string& fullPath) const
+{
+    // 以源路径的哈希命名，源文件内容的哈希记录在文件头中用于判断是否过期
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.rgba",
+                  static_cast<unsigned long long>(HashUtils::fnv1a64(fullPath.data(), fullPath.size())));
+    return _directory + name;
+}
+
+cocos2d::Image* DecodedTextureCache::loadCachedImage(const std::string& cachePath, std::uint64_t sourceHash) const
+{
+    TRIPEAKS_TRACE_SCOPE("startup", "loadDecodedCache");
+
+    const MappedFile file(cachePath);
+    if (!file.data() || file.size() < sizeof(CacheHeader))
+    {
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    const std::uint32_t expectedPadding = _options.padToPowerOfTwo ? kFlagPadded : 0;
+    const std::size_t pixelBytes = static_cast<std::size_t>(header.width) * header.height * kBytesPerPixel;
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion
+        || header.sourceHash != sourceHash || (header.flags & kFlagPadded) != expectedPadding
+        || header.width == 0 || header.height == 0 || file.size() != sizeof(CacheHeader) + pixelBytes)
+    {
+        return nullptr;
+    }
+
+    auto image = new (std::nothrow) cocos2d::Image();
+    if (!image
+        || !image->initWithRawData(file.data() + sizeof(CacheHeader), static_cast<ssize_t>(pixelBytes),
+                                   static_cast<int>(header.width), static_cast<int>(header.height), 8,
+                                   (header.flags & kFlagPremultiplied) != 0))
+    {
+        CC_SAFE_RELEASE(image);
+        return nullptr;
+    }
+    return image;
+}
+
+bool DecodedTextureCache::writeCachedImage(const std::string& cachePath, std::uint64_t sourceHash,
+                                           cocos2d::Image* image, std::string* errorMessage) const
+{
+    // 只缓存 RGBA8888，其他像素格式（如无透明通道的 RGB888）直接使用解码结果
+    if (image->getRenderFormat() != cocos2d::Texture2D::PixelFormat::RGBA8888 || image->getBitPerPixel() != 32)
+    {
+        return true;
+    }
+
+    const std::uint32_t width = static_cast<std::uint32_t>(image->getWidth());
+    const std::uint32_t height = static_cast<std::uint32_t>(image->getHeight());
+    const std::uint32_t storedWidth = _options.padToPowerOfTwo ? nextPowerOfTwo(width) : width;
+    const std::uint32_t storedHeight = _options.padToPowerOfTwo ? nextPowerOfTwo(height) : height;
+
+    CacheHeader header;
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.sourceHash = sourceHash;
+    header.width = storedWidth;
+    header.height = storedHeight;
+    header.flags = (image->hasPremultipliedAlpha() ? kFlagPremultiplied : 0)
+        | (_options.padToPowerOfTwo ? kFlagPadded : 0);
+    header.reserved = 0;
+
+    // 先写临时文件再改名，避免中途退出留下不完整的缓存
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Failed to open texture cache file: " + tempPath;
+            }
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const std::size_t rowBytes = static_cast<std::size_t>(width) * kBytesPerPixel;
+        const std::vector<char> rowPadding((storedWidth - width) * kBytesPerPixel, 0);
+        for (std::uint32_t row = 0; row < height; ++row)
+        {
+            file.write(reinterpret_cast<const char*>(image->getData() + row * rowBytes),
+                       static_cast<std::streamsize>(rowBytes));
+            file.write(rowPadding.data(), static_cast<std::streamsize>(rowPadding.size()));
+        }
+        const std::vector<char> emptyRow(static_cast<std::size_t>(storedWidth) * kBytesPerPixel, 0);
+        for (std::uint32_t row = height; row < storedHeight; ++row)
+        {
+            file.write(emptyRow.data(), static_cast<std::streamsize>(emptyRow.size()));
+        }
+
+        if (!file)
+        {
+            if (errorMessage)
+            {
+                *errorMessage = "Failed to write texture cache file: " + tempPath;
+            }
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Failed to replace texture cache file: " + cachePath;
+        }
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace tripeaks
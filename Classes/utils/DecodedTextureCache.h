@@ -0,0 +1,52 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include <cstdint>
+#include <string>
+
+namespace tripeaks
+{
+
+/**
+ * 解码后纹理的磁盘缓存。
+ * 首次加载时解码 PNG，并把预乘后的 RGBA8888 像素连同源文件哈希写到可写目录；
+ * 之后的启动直接 mmap 缓存文件构造 Image，省去 PNG 解压。源文件内容变化（哈希不符）、
+ * 缓存文件缺失或损坏时透明地回退到 PNG 解码并重写缓存。
+ * loadImage 不访问 GL，可在工作线程调用；纹理上传仍需在主线程通过 TextureCache::addImage 完成。
+ */
+class DecodedTextureCache
+{
+public:
+    struct Options
+    {
+        // 把像素补齐到2的幂尺寸（右侧与下方透明填充）。补齐后纹理尺寸变大，只适用于按帧矩形取图的图集
+        bool padToPowerOfTwo = false;
+    };
+
+    explicit DecodedTextureCache(std::string directory);
+    DecodedTextureCache(std::string directory, Options options);
+
+    // 默认缓存目录：可写路径下的 decoded_textures/
+    static std::string getDefaultDirectory();
+
+    /**
+     * 加载图片，优先读取磁盘缓存
+     * @param fullPath 源图片的完整路径（FileUtils::fullPathForFilename 的结果，该函数本身不是线程安全的）
+     * @param fromCache 可选，返回是否命中缓存
+     * @return 引用计数为1的 Image，由调用方 release；源文件无法读取或解码时返回nullptr
+     */
+    cocos2d::Image* loadImage(const std::string& fullPath, bool* fromCache = nullptr,
+                              std::string* errorMessage = nullptr) const;
+
+private:
+    std::string getCachePath(const std::string& fullPath) const;
+    cocos2d::Image* loadCachedImage(const std::string& cachePath, std::uint64_t sourceHash) const;
+    bool writeCachedImage(const std::string& cachePath, std::uint64_t sourceHash, cocos2d::Image* image,
+                          std::string* errorMessage) const;
+
+    std::string _directory;
+    Options _options;
+};
+
+} // namespace tripeaks
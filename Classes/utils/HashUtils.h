@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tripeaks
+{
+
+/**
+ * FNV-1a 哈希：存档校验和、关卡与局面哈希、解码纹理缓存的来源校验共用。
+ * 结果会写入存档与缓存文件，算法与初始值不能改动。
+ */
+class HashUtils
+{
+public:
+    static constexpr std::uint64_t kFnv1a64Basis = 14695981039346656037ULL;
+
+    // 把一段数据混入已有的 64 位哈希，可分段调用；hash 从 kFnv1a64Basis 开始
+    static void mixFnv1a64(std::uint64_t& hash, const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            hash ^= bytes[index];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    static std::uint64_t fnv1a64(const void* data, std::size_t size)
+    {
+        std::uint64_t hash = kFnv1a64Basis;
+        mixFnv1a64(hash, data, size);
+        return hash;
+    }
+
+    static std::uint32_t fnv1a32(const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::uint32_t hash = 2166136261U;
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            hash ^= bytes[index];
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+};
+
+} // namespace tripeaks
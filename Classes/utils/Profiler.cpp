@@ -0,0 +1,202 @@
+#include "utils/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr int kSectionCount = static_cast<int>(ProfileSection::Count);
+constexpr int kCounterCount = static_cast<int>(ProfileCounter::Count);
+constexpr int kHistorySize = Profiler::kHistoryFrames;
+
+struct ProfilerState
+{
+    // 当前帧累计
+    std::int64_t frameNanos[kSectionCount] = {};
+    int frameCalls[kSectionCount] = {};
+
+    // 滚动窗口
+    float frameSeconds[kHistorySize] = {};
+    std::int64_t sectionNanos[kSectionCount][kHistorySize] = {};
+    int sectionCalls[kSectionCount][kHistorySize] = {};
+    int writeIndex = 0;
+    int frameCount = 0;
+
+    std::int64_t counters[kCounterCount] = {};
+};
+
+ProfilerState& getState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+struct StartupState
+{
+    std::chrono::steady_clock::time_point launchTime;
+    bool launched = false;
+    double timeToFirstFrameMs = -1.0;
+};
+
+StartupState& getStartupState()
+{
+    static StartupState state;
+    return state;
+}
+
+// 统计归属的线程（主线程），由 markLaunchBegin / endFrame 登记
+std::atomic<std::thread::id> g_ownerThread{};
+
+bool isOwnerThread()
+{
+    return g_ownerThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+double percentile(float* sorted, int count, double ratio)
+{
+    const int index = std::min(count - 1, static_cast<int>(ratio * count));
+    return sorted[index] * 1000.0;
+}
+
+} // namespace
+
+void Profiler::addSample(ProfileSection section, std::int64_t nanoseconds)
+{
+    // 模型代码也会在会话分片、提示搜索等工作线程上运行，这些计时不属于任何一帧，直接丢弃
+    if (!isOwnerThread())
+    {
+        return;
+    }
+    ProfilerState& state = getState();
+    const int index = static_cast<int>(section);
+    state.frameNanos[index] += nanoseconds;
+    ++state.frameCalls[index];
+}
+
+void Profiler::setCounter(ProfileCounter counter, std::int64_t value)
+{
+    if (!isOwnerThread())
+    {
+        return;
+    }
+    getState().counters[static_cast<int>(counter)] = value;
+}
+
+void Profiler::endFrame(float frameSeconds)
+{
+    g_ownerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    ProfilerState& state = getState();
+    const int slot = state.writeIndex;
+    state.frameSeconds[slot] = frameSeconds;
+    for (int section = 0; section < kSectionCount; ++section)
+    {
+        state.sectionNanos[section][slot] = state.frameNanos[section];
+        state.sectionCalls[section][slot] = state.frameCalls[section];
+        state.frameNanos[section] = 0;
+        state.frameCalls[section] = 0;
+    }
+    state.writeIndex = (slot + 1) % kHistorySize;
+    state.frameCount = std::min(state.frameCount + 1, kHistorySize);
+}
+
+void Profiler::getSnapshot(Snapshot& outSnapshot)
+{
+    const ProfilerState& state = getState();
+    outSnapshot = Snapshot{};
+    outSnapshot.frameCount = state.frameCount;
+    std::copy(state.counters, state.counters + kCounterCount, outSnapshot.counters);
+    outSnapshot.timeToFirstFrameMs = getStartupState().timeToFirstFrameMs;
+
+    const int count = state.frameCount;
+    if (count == 0)
+    {
+        return;
+    }
+
+    // 窗口未写满时有效数据位于 [0, count)，写满后整个数组都有效
+    float sorted[kHistorySize];
+    std::copy(state.frameSeconds, state.frameSeconds + count, sorted);
+    std::sort(sorted, sorted + count);
+    outSnapshot.frameP50Ms = percentile(sorted, count, 0.50);
+    outSnapshot.frameP95Ms = percentile(sorted, count, 0.95);
+    outSnapshot.frameP99Ms = percentile(sorted, count, 0.99);
+    outSnapshot.frameMaxMs = sorted[count - 1] * 1000.0;
+
+    for (int section = 0; section < kSectionCount; ++section)
+    {
+        std::int64_t totalNanos = 0;
+        std::int64_t maxNanos = 0;
+        std::int64_t totalCalls = 0;
+        for (int frame = 0; frame < count; ++frame)
+        {
+            totalNanos += state.sectionNanos[section][frame];
+            maxNanos = std::max(maxNanos, state.sectionNanos[section][frame]);
+            totalCalls += state.sectionCalls[section][frame];
+        }
+
+        SectionStats& stats = outSnapshot.sections[section];
+        stats.averageMs = static_cast<double>(totalNanos) / count / 1.0e6;
+        stats.maxMs = static_cast<double>(maxNanos) / 1.0e6;
+        stats.callsPerFrame = static_cast<double>(totalCalls) / count;
+    }
+}
+
+void Profiler::reset()
+{
+    getState() = ProfilerState{};
+}
+
+void Profiler::markLaunchBegin()
+{
+    g_ownerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    StartupState& startup = getStartupState();
+    startup.launchTime = std::chrono::steady_clock::now();
+    startup.launched = true;
+    startup.timeToFirstFrameMs = -1.0;
+}
+
+void Profiler::markFirstInteractiveFrame()
+{
+    StartupState& startup = getStartupState();
+    if (!startup.launched || startup.timeToFirstFrameMs >= 0.0)
+    {
+        return;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - startup.launchTime;
+    startup.timeToFirstFrameMs = std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+double Profiler::getTimeToFirstFrameMs()
+{
+    return getStartupState().timeToFirstFrameMs;
+}
+
+const char* Profiler::getSectionName(ProfileSection section)
+{
+    switch (section)
+    {
+    case ProfileSection::Input:
+        return "input";
+    case ProfileSection::Model:
+        return "model";
+    case ProfileSection::CardRefresh:
+        return "refresh";
+    case ProfileSection::Layout:
+        return "layout";
+    case ProfileSection::Tweens:
+        return "tweens";
+    case ProfileSection::BatchUpdate:
+        return "batch";
+    case ProfileSection::HitTest:
+        return "hittest";
+    default:
+        return "?";
+    }
+}
+
+} // namespace tripeaks
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// 调试构建默认开启分段计时，发布构建中 TRIPEAKS_PROFILE_SCOPE 展开为空
+#ifndef TRIPEAKS_ENABLE_PROFILER
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define TRIPEAKS_ENABLE_PROFILER 1
+#else
+#define TRIPEAKS_ENABLE_PROFILER 0
+#endif
+#endif
+
+namespace tripeaks
+{
+
+// 分段计时的子系统
+enum class ProfileSection
+{
+    Input,          // 控制器处理输入队列
+    Model,          // 模型状态修改
+    CardRefresh,    // 卡牌可操作状态刷新
+    Layout,         // 布局（重建牌桌、备用牌堆）
+    Tweens,         // 补间动画推进
+    BatchUpdate,    // 批量渲染节点排序与顶点重写
+    HitTest,        // 触摸命中查询
+    Count
+};
+
+// 由各模块上报的瞬时计数
+enum class ProfileCounter
+{
+    ActiveTweens,
+    BatchCards,
+    Count
+};
+
+/**
+ * 帧耗时与子系统耗时统计。
+ * 各段耗时按帧累加，endFrame 时写入固定长度的滚动窗口；不分配内存。
+ * 只统计调用 markLaunchBegin / endFrame 的主线程，其他线程上的 addSample / setCounter 直接忽略。
+ */
+class Profiler
+{
+public:
+    static constexpr int kHistoryFrames = 240;
+
+    struct SectionStats
+    {
+        double averageMs = 0.0;     // 窗口内平均每帧耗时
+        double maxMs = 0.0;         // 窗口内单帧最大耗时
+        double callsPerFrame = 0.0;
+    };
+
+    struct Snapshot
+    {
+        int frameCount = 0;
+        double frameP50Ms = 0.0;
+        double frameP95Ms = 0.0;
+        double frameP99Ms = 0.0;
+        double frameMaxMs = 0.0;
+        SectionStats sections[static_cast<int>(ProfileSection::Count)];
+        std::int64_t counters[static_cast<int>(ProfileCounter::Count)] = {};
+        double timeToFirstFrameMs = -1.0;   // 尚未进入首个可交互帧时为负
+    };
+
+    static void addSample(ProfileSection section, std::int64_t nanoseconds);
+    static void setCounter(ProfileCounter counter, std::int64_t value);
+
+    // 结束当前帧：记录帧耗时并把本帧各段累计值写入滚动窗口
+    static void endFrame(float frameSeconds);
+
+    static void getSnapshot(Snapshot& outSnapshot);
+    static void reset();
+
+    // 启动计时：应用启动时开始，游戏场景首次绘制完成时结束；不受 reset 影响，发布构建同样记录
+    static void markLaunchBegin();
+    static void markFirstInteractiveFrame();
+    static double getTimeToFirstFrameMs();
+
+    static const char* getSectionName(ProfileSection section);
+};
+
+/**
+ * 作用域计时器，析构时把耗时累加到对应分段
+ */
+class ScopedProfileTimer
+{
+public:
+    explicit ScopedProfileTimer(ProfileSection section)
+        : _section(section)
+        , _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedProfileTimer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - _start;
+        Profiler::addSample(_section, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    ScopedProfileTimer(const ScopedProfileTimer&) = delete;
+    ScopedProfileTimer& operator=(const ScopedProfileTimer&) = delete;
+
+private:
+    ProfileSection _section;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace tripeaks
+
+#define TRIPEAKS_PROFILE_CONCAT_INNER(a, b) a##b
+#define TRIPEAKS_PROFILE_CONCAT(a, b) TRIPEAKS_PROFILE_CONCAT_INNER(a, b)
+
+#if TRIPEAKS_ENABLE_PROFILER
+#define TRIPEAKS_PROFILE_SCOPE(section) \
+    ::tripeaks::ScopedProfileTimer TRIPEAKS_PROFILE_CONCAT(profileScope, __LINE__)(::tripeaks::ProfileSection::section)
+#define TRIPEAKS_PROFILE_COUNTER(counter, value) \
+    ::tripeaks::Profiler::setCounter(::tripeaks::ProfileCounter::counter, static_cast<std::int64_t>(value))
+#else
+#define TRIPEAKS_PROFILE_SCOPE(section) ((void)0)
+#define TRIPEAKS_PROFILE_COUNTER(counter, value) ((void)0)
+#endif
@@ -0,0 +1,282 @@
+#include "utils/TraceRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr std::size_t kCapacity = TraceRecorder::kEventsPerThread;
+static_assert((kCapacity & (kCapacity - 1)) == 0, "trace ring capacity must be a power of two");
+
+struct TraceEvent
+{
+    const char* category = nullptr;
+    const char* name = nullptr;
+    const char* argName = nullptr;
+    std::int64_t argValue = 0;
+    std::uint64_t id = 0;
+    std::int64_t timestampNanos = 0;
+    char phase = 'i';
+};
+
+// 单生产者环形缓冲区：只有所属线程写入，导出线程通过 writeCount 判断哪些事件有效
+struct ThreadBuffer
+{
+    std::uint32_t threadId = 0;
+    std::atomic<const char*> threadName{nullptr};
+    std::atomic<std::uint64_t> writeCount{0};
+    TraceEvent events[kCapacity];
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;   // 线程退出后保留，以便导出其事件
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<bool>& getEnabledFlag()
+{
+    static std::atomic<bool> enabled{true};
+    return enabled;
+}
+
+std::int64_t nowNanos()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+ThreadBuffer& getThreadBuffer()
+{
+    // 只有线程第一次记录时加锁注册
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer)
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.emplace_back(new ThreadBuffer());
+        buffer = registry.buffers.back().get();
+        buffer->threadId = static_cast<std::uint32_t>(registry.buffers.size());
+    }
+    return *buffer;
+}
+
+void record(char phase, const char* category, const char* name, std::uint64_t id, const char* argName,
+            std::int64_t argValue)
+{
+    if (!getEnabledFlag().load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    ThreadBuffer& buffer = getThreadBuffer();
+    const std::uint64_t index = buffer.writeCount.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.events[index & (kCapacity - 1)];
+    event.category = category;
+    event.name = name;
+    event.argName = argName;
+    event.argValue = argValue;
+    event.id = id;
+    event.timestampNanos = nowNanos();
+    event.phase = phase;
+    buffer.writeCount.store(index + 1, std::memory_order_release);
+}
+
+void appendEscaped(std::string& out, const char* text)
+{
+    for (const char* cursor = text ? text : ""; *cursor; ++cursor)
+    {
+        const char ch = *cursor;
+        if (ch == '"' || ch == '\\')
+        {
+            out += '\\';
+            out += ch;
+        }
+        else if (static_cast<unsigned char>(ch) < 0x20)
+        {
+            out += ' ';
+        }
+        else
+        {
+            out += ch;
+        }
+    }
+}
+
+void appendEvent(std::string& out, const TraceEvent& event, std::uint32_t threadId)
+{
+    char numbers[96];
+    out += "{\"name\":\"";
+    appendEscaped(out, event.name);
+    out += "\",\"cat\":\"";
+    appendEscaped(out, event.category);
+    out += "\",\"ph\":\"";
+    out += event.phase;
+    std::snprintf(numbers, sizeof(numbers), "\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+                  static_cast<double>(event.timestampNanos) / 1000.0, threadId);
+    out += numbers;
+
+    if (event.phase == 'b' || event.phase == 'e')
+    {
+        std::snprintf(numbers, sizeof(numbers), ",\"id\":\"0x%llx\"", static_cast<unsigned long long>(event.id));
+        out += numbers;
+    }
+    else if (event.phase == 'i')
+    {
+        out += ",\"s\":\"t\"";
+    }
+
+    if (event.argName)
+    {
+        out += ",\"args\":{\"";
+        appendEscaped(out, event.argName);
+        std::snprintf(numbers, sizeof(numbers), "\":%lld}", static_cast<long long>(event.argValue));
+        out += numbers;
+    }
+    out += '}';
+}
+
+} // namespace
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    getEnabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::isEnabled()
+{
+    return getEnabledFlag().load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    getThreadBuffer().threadName.store(name, std::memory_order_release);
+}
+
+void TraceRecorder::beginEvent(const char* category, const char* name, const char* argName, std::int64_t argValue)
+{
+    record('B', category, name, 0, argName, argValue);
+}
+
+void TraceRecorder::endEvent(const char* category, const char* name)
+{
+    record('E', category, name, 0, nullptr, 0);
+}
+
+void TraceRecorder::instantEvent(const char* category, const char* name, const char* argName, std::int64_t argValue)
+{
+    record('i', category, name, 0, argName, argValue);
+}
+
+void TraceRecorder::asyncBeginEvent(const char* category, const char* name, std::uint64_t id)
+{
+    record('b', category, name, id, nullptr, 0);
+}
+
+void TraceRecorder::asyncEndEvent(const char* category, const char* name, std::uint64_t id)
+{
+    record('e', category, name, id, nullptr, 0);
+}
+
+std::string TraceRecorder::toChromeTraceJson()
+{
+    std::vector<ThreadBuffer*> buffers;
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& buffer : registry.buffers)
+        {
+            buffers.emplace_back(buffer.get());
+        }
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&json, &first]() {
+        if (!first)
+        {
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    std::vector<TraceEvent> events;
+    events.reserve(kCapacity);
+    for (ThreadBuffer* buffer : buffers)
+    {
+        if (const char* threadName = buffer->threadName.load(std::memory_order_acquire))
+        {
+            separator();
+            char header[64];
+            std::snprintf(header, sizeof(header), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,",
+                          buffer->threadId);
+            json += header;
+            json += "\"args\":{\"name\":\"";
+            appendEscaped(json, threadName);
+            json += "\"}}";
+        }
+
+        // 先复制再复查写入计数：复制期间可能已被覆盖（包括正在写入的下一个槽位）的最旧事件一律丢弃
+        const std::uint64_t end = buffer->writeCount.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+        events.clear();
+        for (std::uint64_t index = begin; index < end; ++index)
+        {
+            events.emplace_back(buffer->events[index & (kCapacity - 1)]);
+        }
+        const std::uint64_t after = buffer->writeCount.load(std::memory_order_acquire);
+        const std::uint64_t firstValid = after + 1 > kCapacity ? after + 1 - kCapacity : 0;
+
+        for (std::uint64_t index = std::max(begin, firstValid); index < end; ++index)
+        {
+            separator();
+            appendEvent(json, events[static_cast<std::size_t>(index - begin)], buffer->threadId);
+        }
+    }
+
+    json += "]}\n";
+    return json;
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& path, std::string* errorMessage)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Failed to open trace file: " + path;
+        }
+        return false;
+    }
+
+    const std::string json = toChromeTraceJson();
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!file)
+    {
+        if (errorMessage)
+        {
+            *errorMessage = "Failed to write trace file: " + path;
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace tripeaks
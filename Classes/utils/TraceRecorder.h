@@ -0,0 +1,89 @@
+#pragma once
+
+#include "utils/Profiler.h"
+
+#include <cstdint>
+#include <string>
+
+// 时间线追踪默认随调试构建开启；QA 包可在构建时定义 TRIPEAKS_ENABLE_TRACING=1 单独打开
+#ifndef TRIPEAKS_ENABLE_TRACING
+#define TRIPEAKS_ENABLE_TRACING TRIPEAKS_ENABLE_PROFILER
+#endif
+
+namespace tripeaks
+{
+
+/**
+ * 时间线事件记录器。
+ * 每个线程首次记录时注册一个固定容量的环形缓冲区，之后的记录只写本线程缓冲区并发布写入计数，
+ * 不加锁也不分配内存；缓冲区写满后覆盖最旧的事件。
+ * dump 时把所有线程最近的事件导出为 Chrome trace-event JSON（chrome://tracing 或 Perfetto 可直接打开）。
+ * 事件名、分类与参数名必须是字符串字面量等生命周期足够长的常量。
+ */
+class TraceRecorder
+{
+public:
+    static constexpr std::size_t kEventsPerThread = 8192;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // 为当前线程命名，显示在时间线的线程标题上
+    static void setThreadName(const char* name);
+
+    static void beginEvent(const char* category, const char* name, const char* argName = nullptr,
+                           std::int64_t argValue = 0);
+    static void endEvent(const char* category, const char* name);
+    static void instantEvent(const char* category, const char* name, const char* argName = nullptr,
+                             std::int64_t argValue = 0);
+    // 跨帧的异步区间（如动画），以 id 配对
+    static void asyncBeginEvent(const char* category, const char* name, std::uint64_t id);
+    static void asyncEndEvent(const char* category, const char* name, std::uint64_t id);
+
+    static std::string toChromeTraceJson();
+    static bool writeChromeTrace(const std::string& path, std::string* errorMessage = nullptr);
+};
+
+/**
+ * 作用域事件：构造时记录开始，析构时记录结束
+ */
+class ScopedTraceEvent
+{
+public:
+    ScopedTraceEvent(const char* category, const char* name, const char* argName = nullptr, std::int64_t argValue = 0)
+        : _category(category)
+        , _name(name)
+    {
+        TraceRecorder::beginEvent(category, name, argName, argValue);
+    }
+
+    ~ScopedTraceEvent()
+    {
+        TraceRecorder::endEvent(_category, _name);
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+private:
+    const char* _category;
+    const char* _name;
+};
+
+} // namespace tripeaks
+
+#if TRIPEAKS_ENABLE_TRACING
+#define TRIPEAKS_TRACE_SCOPE(category, name) \
+    ::tripeaks::ScopedTraceEvent TRIPEAKS_PROFILE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRIPEAKS_TRACE_SCOPE_ARG(category, name, argName, argValue) \
+    ::tripeaks::ScopedTraceEvent TRIPEAKS_PROFILE_CONCAT(traceScope, __LINE__)(category, name, argName, argValue)
+#define TRIPEAKS_TRACE_INSTANT(category, name) ::tripeaks::TraceRecorder::instantEvent(category, name)
+#define TRIPEAKS_TRACE_ASYNC_BEGIN(category, name, id) ::tripeaks::TraceRecorder::asyncBeginEvent(category, name, id)
+#define TRIPEAKS_TRACE_ASYNC_END(category, name, id) ::tripeaks::TraceRecorder::asyncEndEvent(category, name, id)
+#else
+#define TRIPEAKS_TRACE_SCOPE(category, name) ((void)0)
+#define TRIPEAKS_TRACE_SCOPE_ARG(category, name, argName, argValue) ((void)0)
+#define TRIPEAKS_TRACE_INSTANT(category, name) ((void)0)
+#define TRIPEAKS_TRACE_ASYNC_BEGIN(category, name, id) ((void)0)
+#define TRIPEAKS_TRACE_ASYNC_END(category, name, id) ((void)0)
+#endif
@@ -0,0 +1,496 @@
+#include "views/CardBatchNode.h"
+
+#include "utils/Profiler.h"
+#include "views/CardFaceCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+// 16位索引单次最多寻址65536个顶点，即16384张卡牌；超出时分段绘制
+constexpr std::size_t kMaxQuadsPerDraw = 65536 / 4;
+
+constexpr int kFaceCount = 52;
+
+int toFaceIndex(CardFaceType face, CardSuit suit)
+{
+    return static_cast<int>(suit) * 13 + static_cast<int>(face);
+}
+
+} // namespace
+
+CardBatchNode* CardBatchNode::create(const CardFaceCache& faceCache)
+{
+    auto node = new (std::nothrow) CardBatchNode();
+    if (node && node->initWithFaceCache(faceCache))
+    {
+        node->autorelease();
+        return node;
+    }
+    CC_SAFE_DELETE(node);
+    return nullptr;
+}
+
+CardBatchNode::~CardBatchNode()
+{
+    CC_SAFE_RELEASE(_texture);
+    if (_vbo)
+    {
+        glDeleteBuffers(1, &_vbo);
+    }
+    if (_ibo)
+    {
+        glDeleteBuffers(1, &_ibo);
+    }
+}
+
+bool CardBatchNode::initWithFaceCache(const CardFaceCache& faceCache)
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    _texture = faceCache.getTexture();
+    cocos2d::SpriteFrame* backFrame = faceCache.getBackFrame();
+    if (!_texture || !backFrame)
+    {
+        return false;
+    }
+    _texture->retain();
+
+    const float texWidth = static_cast<float>(_texture->getPixelsWide());
+    const float texHeight = static_cast<float>(_texture->getPixelsHigh());
+    auto toUV = [texWidth, texHeight](cocos2d::SpriteFrame* frame) {
+        UVRect uv;
+        if (frame)
+        {
+            const cocos2d::Rect& rect = frame->getRectInPixels();
+            uv.u0 = rect.getMinX() / texWidth;
+            uv.v0 = rect.getMinY() / texHeight;
+            uv.u1 = rect.getMaxX() / texWidth;
+            uv.v1 = rect.getMaxY() / texHeight;
+        }
+        return uv;
+    };
+
+    for (int index = 0; index < kFaceCount; ++index)
+    {
+        _faceUVs[index] = toUV(faceCache.getFaceFrame(static_cast<CardFaceType>(index % 13),
+                                                      static_cast<CardSuit>(index / 13)));
+    }
+    _backUV = toUV(backFrame);
+
+    const cocos2d::Size bakedSize = backFrame->getOriginalSize();
+    _cardSize = cocos2d::Size(bakedSize.width / faceCache.getBakeScale(),
+                              bakedSize.height / faceCache.getBakeScale());
+    _hitGrid.reset(0, _cardSize);
+
+    setGLProgramState(cocos2d::GLProgramState::getOrCreateWithGLProgramName(
+        cocos2d::GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, _texture));
+
+    setupBuffers();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = cocos2d::EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](cocos2d::EventCustom*) {
+        _vbo = 0;
+        _ibo = 0;
+        _uploadedIndexQuads = 0;
+        _bufferDirty = true;
+        setupBuffers();
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+int CardBatchNode::addCard(CardFaceType face, CardSuit suit, bool faceUp)
+{
+    CardQuad card;
+    card.faceIndex = static_cast<unsigned char>(toFaceIndex(face, suit));
+    card.faceUp = faceUp;
+    card.orderIndex = static_cast<int>(_cards.size());
+
+    const int slot = static_cast<int>(_cards.size());
+    _cards.emplace_back(card);
+    _drawOrder.emplace_back(slot);
+    _boundsDirtySlots.emplace_back(slot);
+    _vertices.resize(_cards.size() * 4);
+    _orderDirty = true;
+    return slot;
+}
+
+void CardBatchNode::clearCards()
+{
+    _cards.clear();
+    _drawOrder.clear();
+    _dirtySlots.clear();
+    _boundsDirtySlots.clear();
+    _vertices.clear();
+    _hitGrid.reset(0, _cardSize);
+    _orderDirty = true;
+    _bufferDirty = true;
+}
+
+void CardBatchNode::setCardPosition(int slot, const cocos2d::Vec2& position)
+{
+    _cards[slot].position = position;
+    markDirty(slot);
+    markBoundsDirty(slot);
+}
+
+cocos2d::Vec2 CardBatchNode::getCardPosition(int slot) const
+{
+    return _cards[slot].position;
+}
+
+void CardBatchNode::setCardScale(int slot, float scaleX, float scaleY)
+{
+    _cards[slot].scaleX = scaleX;
+    _cards[slot].scaleY = scaleY;
+    markDirty(slot);
+    markBoundsDirty(slot);
+}
+
+float CardBatchNode::getCardScaleX(int slot) const
+{
+    return _cards[slot].scaleX;
+}
+
+float CardBatchNode::getCardScaleY(int slot) const
+{
+    return _cards[slot].scaleY;
+}
+
+void CardBatchNode::setCardRotation(int slot, float rotation)
+{
+    _cards[slot].rotation = rotation;
+    markDirty(slot);
+    markBoundsDirty(slot);
+}
+
+void CardBatchNode::setCardTint(int slot, const cocos2d::Color3B& tint)
+{
+    CardQuad& card = _cards[slot];
+    if (card.tint == tint)
+    {
+        return;
+    }
+    card.tint = tint;
+    markDirty(slot);
+}
+
+void CardBatchNode::setCardFace(int slot, CardFaceType face, CardSuit suit)
+{
+    _cards[slot].faceIndex = static_cast<unsigned char>(toFaceIndex(face, suit));
+    markDirty(slot);
+}
+
+void CardBatchNode::setCardFaceUp(int slot, bool faceUp)
+{
+    _cards[slot].faceUp = faceUp;
+    markDirty(slot);
+}
+
+void CardBatchNode::setCardVisible(int slot, bool visible)
+{
+    _cards[slot].visible = visible;
+    markDirty(slot);
+    markBoundsDirty(slot);
+}
+
+void CardBatchNode::setCardZOrder(int slot, int zOrder)
+{
+    CardQuad& card = _cards[slot];
+    if (card.zOrder == zOrder)
+    {
+        return;
+    }
+    card.zOrder = zOrder;
+    _orderDirty = true;
+}
+
+int CardBatchNode::getCardZOrder(int slot) const
+{
+    return _cards[slot].zOrder;
+}
+
+int CardBatchNode::findTopmostCardAt(const cocos2d::Vec2& point, const std::function<bool(int)>& filter)
+{
+    TRIPEAKS_PROFILE_SCOPE(HitTest);
+    updateHitGrid();
+    // 以实际绘制位置判定上下：层级相同的卡牌按上一次的绘制顺序稳定排列，不一定与槽位顺序相同
+    updateDrawOrder();
+
+    int bestSlot = -1;
+    for (int slot : _hitGrid.getCandidates(point))
+    {
+        const CardQuad& card = _cards[slot];
+        if (bestSlot >= 0)
+        {
+            if (card.orderIndex <= _cards[bestSlot].orderIndex)
+            {
+                continue;
+            }
+        }
+        if (!card.visible || !containsPoint(card, point) || (filter && !filter(slot)))
+        {
+            continue;
+        }
+        bestSlot = slot;
+    }
+    return bestSlot;
+}
+
+void CardBatchNode::draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags)
+{
+    if (_cards.empty())
+    {
+        return;
+    }
+
+    {
+        TRIPEAKS_PROFILE_SCOPE(BatchUpdate);
+        updateDrawOrder();
+        updateVertices();
+        updateHitGrid();
+    }
+    TRIPEAKS_PROFILE_COUNTER(BatchCards, _cards.size());
+
+    _customCommand.init(_globalZOrder, transform, flags);
+    _customCommand.func = CC_CALLBACK_0(CardBatchNode::onDraw, this, transform, flags);
+    renderer->addCommand(&_customCommand);
+}
+
+void CardBatchNode::markDirty(int slot)
+{
+    CardQuad& card = _cards[slot];
+    if (!card.dirty)
+    {
+        card.dirty = true;
+        _dirtySlots.emplace_back(slot);
+    }
+}
+
+void CardBatchNode::markBoundsDirty(int slot)
+{
+    CardQuad& card = _cards[slot];
+    if (!card.boundsDirty)
+    {
+        card.boundsDirty = true;
+        _boundsDirtySlots.emplace_back(slot);
+    }
+}
+
+void CardBatchNode::updateHitGrid()
+{
+    for (int slot : _boundsDirtySlots)
+    {
+        CardQuad& card = _cards[slot];
+        _hitGrid.update(slot, getCardBounds(card), card.visible);
+        card.boundsDirty = false;
+    }
+    _boundsDirtySlots.clear();
+}
+
+cocos2d::Rect CardBatchNode::getCardBounds(const CardQuad& card) const
+{
+    float halfWidth = std::abs(_cardSize.width * 0.5F * card.scaleX);
+    float halfHeight = std::abs(_cardSize.height * 0.5F * card.scaleY);
+    if (card.rotation != 0.0F)
+    {
+        const float radians = CC_DEGREES_TO_RADIANS(card.rotation);
+        const float cosValue = std::abs(std::cos(radians));
+        const float sinValue = std::abs(std::sin(radians));
+        const float rotatedWidth = halfWidth * cosValue + halfHeight * sinValue;
+        halfHeight = halfWidth * sinValue + halfHeight * cosValue;
+        halfWidth = rotatedWidth;
+    }
+    return cocos2d::Rect(card.position.x - halfWidth, card.position.y - halfHeight, halfWidth * 2.0F, halfHeight * 2.0F);
+}
+
+void CardBatchNode::updateDrawOrder()
+{
+    if (!_orderDirty)
+    {
+        return;
+    }
+
+    std::stable_sort(_drawOrder.begin(), _drawOrder.end(), [this](int lhs, int rhs) {
+        return _cards[lhs].zOrder < _cards[rhs].zOrder;
+    });
+
+    // 顺序变化后所有顶点都需要重写到新的位置
+    _dirtySlots.clear();
+    for (std::size_t index = 0; index < _drawOrder.size(); ++index)
+    {
+        CardQuad& card = _cards[_drawOrder[index]];
+        card.orderIndex = static_cast<int>(index);
+        card.dirty = true;
+        _dirtySlots.emplace_back(_drawOrder[index]);
+    }
+    _orderDirty = false;
+}
+
+void CardBatchNode::updateVertices()
+{
+    if (_dirtySlots.empty())
+    {
+        return;
+    }
+
+    for (int slot : _dirtySlots)
+    {
+        CardQuad& card = _cards[slot];
+        writeQuad(card, &_vertices[static_cast<std::size_t>(card.orderIndex) * 4]);
+        card.dirty = false;
+    }
+    _dirtySlots.clear();
+    _bufferDirty = true;
+}
+
+void CardBatchNode::writeQuad(const CardQuad& card, cocos2d::V3F_C4B_T2F* vertices) const
+{
+    if (!card.visible)
+    {
+        // 不可见的卡牌写入退化四边形，保持索引缓冲不变
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            vertices[corner].vertices = cocos2d::Vec3(card.position.x, card.position.y, 0.0F);
+            vertices[corner].colors = cocos2d::Color4B(0, 0, 0, 0);
+        }
+        return;
+    }
+
+    const UVRect& uv = card.faceUp ? _faceUVs[card.faceIndex] : _backUV;
+    const cocos2d::Color3B& tint = card.faceUp ? card.tint : cocos2d::Color3B::WHITE;
+    const cocos2d::Color4B color(tint.r, tint.g, tint.b, 255);
+
+    const float halfWidth = _cardSize.width * 0.5F * card.scaleX;
+    const float halfHeight = _cardSize.height * 0.5F * card.scaleY;
+
+    // 与 cocos2d::Node 一致：正角度为顺时针旋转
+    const float radians = CC_DEGREES_TO_RADIANS(card.rotation);
+    const float cosValue = std::cos(radians);
+    const float sinValue = std::sin(radians);
+
+    // 顶点顺序：左下、右下、左上、右上
+    const float cornerX[4] = {-halfWidth, halfWidth, -halfWidth, halfWidth};
+    const float cornerY[4] = {-halfHeight, -halfHeight, halfHeight, halfHeight};
+    const float cornerU[4] = {uv.u0, uv.u1, uv.u0, uv.u1};
+    const float cornerV[4] = {uv.v1, uv.v1, uv.v0, uv.v0};
+
+    for (int corner = 0; corner < 4; ++corner)
+    {
+        const float x = cornerX[corner] * cosValue + cornerY[corner] * sinValue;
+        const float y = -cornerX[corner] * sinValue + cornerY[corner] * cosValue;
+        vertices[corner].vertices = cocos2d::Vec3(card.position.x + x, card.position.y + y, 0.0F);
+        vertices[corner].colors = color;
+        vertices[corner].texCoords = cocos2d::Tex2F(cornerU[corner], cornerV[corner]);
+    }
+}
+
+bool CardBatchNode::containsPoint(const CardQuad& card, const cocos2d::Vec2& point) const
+{
+    const float halfWidth = std::abs(_cardSize.width * 0.5F * card.scaleX);
+    const float halfHeight = std::abs(_cardSize.height * 0.5F * card.scaleY);
+    if (halfWidth <= 0.0F || halfHeight <= 0.0F)
+    {
+        return false;
+    }
+
+    const cocos2d::Vec2 offset = point - card.position;
+    float localX = offset.x;
+    float localY = offset.y;
+    if (card.rotation != 0.0F)
+    {
+        const float radians = CC_DEGREES_TO_RADIANS(card.rotation);
+        const float cosValue = std::cos(radians);
+        const float sinValue = std::sin(radians);
+        localX = offset.x * cosValue - offset.y * sinValue;
+        localY = offset.x * sinValue + offset.y * cosValue;
+    }
+    return std::abs(localX) <= halfWidth && std::abs(localY) <= halfHeight;
+}
+
+void CardBatchNode::setupBuffers()
+{
+    glGenBuffers(1, &_vbo);
+    glGenBuffers(1, &_ibo);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void CardBatchNode::onDraw(const cocos2d::Mat4& transform, uint32_t flags)
+{
+    const std::size_t quadCount = _cards.size();
+    if (quadCount == 0 || !_vbo || !_ibo)
+    {
+        return;
+    }
+
+    if (cocos2d::Configuration::getInstance()->supportsShareableVAO())
+    {
+        cocos2d::GL::bindVAO(0);
+    }
+
+    getGLProgramState()->apply(transform);
+    cocos2d::GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+    cocos2d::GL::bindTexture2D(_texture->getName());
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    if (_bufferDirty)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(cocos2d::V3F_C4B_T2F) * _vertices.size(), _vertices.data(), GL_DYNAMIC_DRAW);
+        _bufferDirty = false;
+    }
+
+    // 索引缓冲对每一段都相同，只在容量增长时重建
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
+    const std::size_t indexQuads = std::min(quadCount, kMaxQuadsPerDraw);
+    if (indexQuads > _uploadedIndexQuads)
+    {
+        _indices.resize(indexQuads * 6);
+        for (std::size_t quad = 0; quad < indexQuads; ++quad)
+        {
+            const GLushort base = static_cast<GLushort>(quad * 4);
+            GLushort* index = &_indices[quad * 6];
+            index[0] = base;
+            index[1] = static_cast<GLushort>(base + 1);
+            index[2] = static_cast<GLushort>(base + 2);
+            index[3] = static_cast<GLushort>(base + 2);
+            index[4] = static_cast<GLushort>(base + 1);
+            index[5] = static_cast<GLushort>(base + 3);
+        }
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+        _uploadedIndexQuads = indexQuads;
+    }
+
+    cocos2d::GL::enableVertexAttribs(cocos2d::GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    const GLsizei stride = sizeof(cocos2d::V3F_C4B_T2F);
+    for (std::size_t first = 0; first < quadCount; first += kMaxQuadsPerDraw)
+    {
+        const std::size_t count = std::min(kMaxQuadsPerDraw, quadCount - first);
+        const std::size_t base = first * 4 * sizeof(cocos2d::V3F_C4B_T2F);
+        glVertexAttribPointer(cocos2d::GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<GLvoid*>(base + offsetof(cocos2d::V3F_C4B_T2F, vertices)));
+        glVertexAttribPointer(cocos2d::GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              reinterpret_cast<GLvoid*>(base + offsetof(cocos2d::V3F_C4B_T2F, colors)));
+        glVertexAttribPointer(cocos2d::GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<GLvoid*>(base + offsetof(cocos2d::V3F_C4B_T2F, texCoords)));
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count * 6), GL_UNSIGNED_SHORT, nullptr);
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, count * 4);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+} // namespace tripeaks
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include "configs/models/LevelConfig.h"
+#include "views/CardSpatialGrid.h"
+
+#include <functional>
+#include <vector>
+
+namespace tripeaks
+{
+
+class CardFaceCache;
+
+/**
+ * 单节点批量卡牌渲染器。
+ * 所有卡牌的四边形保存在同一个顶点缓冲中，每张卡牌只占紧凑数组中的一个槽位
+ * （位置、缩放/旋转、着色、牌面UV、正反面、可见性与层级），整桌卡牌通过一个
+ * CustomCommand 提交，不再为每张卡牌创建节点子树。
+ * 纹理来自 CardFaceCache 的烘焙纹理页；只有被修改过的槽位会重写顶点，层级变化时才重新排序。
+ * 触摸命中通过 CardSpatialGrid 在本节点坐标系中查询，卡牌移动后在下一次查询或绘制时增量更新网格。
+ */
+class CardBatchNode : public cocos2d::Node
+{
+public:
+    static CardBatchNode* create(const CardFaceCache& faceCache);
+
+    bool initWithFaceCache(const CardFaceCache& faceCache);
+
+    // 添加一张卡牌并返回其槽位索引
+    int addCard(CardFaceType face, CardSuit suit, bool faceUp);
+    // 移除所有卡牌（保留已分配的容量）
+    void clearCards();
+    int getCardCount() const { return static_cast<int>(_cards.size()); }
+
+    void setCardPosition(int slot, const cocos2d::Vec2& position);
+    cocos2d::Vec2 getCardPosition(int slot) const;
+
+    void setCardScale(int slot, float scaleX, float scaleY);
+    float getCardScaleX(int slot) const;
+    float getCardScaleY(int slot) const;
+
+    void setCardRotation(int slot, float rotation);
+
+    // 着色只作用于牌面（牌背颜色已烘焙）
+    void setCardTint(int slot, const cocos2d::Color3B& tint);
+    void setCardFace(int slot, CardFaceType face, CardSuit suit);
+    void setCardFaceUp(int slot, bool faceUp);
+    void setCardVisible(int slot, bool visible);
+    void setCardZOrder(int slot, int zOrder);
+    int getCardZOrder(int slot) const;
+
+    // 卡牌在本节点坐标系中未缩放时的尺寸
+    const cocos2d::Size& getCardSize() const { return _cardSize; }
+
+    /**
+     * 查找包含指定点（本节点坐标系）且满足过滤条件的最上层卡牌
+     * 只检查空间网格中触点所在桶的候选卡牌，开销与牌桌规模无关
+     * @return 槽位索引，没有命中返回-1
+     */
+    int findTopmostCardAt(const cocos2d::Vec2& point, const std::function<bool(int)>& filter);
+
+    void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+protected:
+    CardBatchNode() = default;
+    ~CardBatchNode() override;
+
+private:
+    struct UVRect
+    {
+        float u0 = 0.0F;
+        float v0 = 0.0F;
+        float u1 = 0.0F;
+        float v1 = 0.0F;
+    };
+
+    struct CardQuad
+    {
+        cocos2d::Vec2 position;
+        float scaleX = 1.0F;
+        float scaleY = 1.0F;
+        float rotation = 0.0F;
+        int zOrder = 0;
+        int orderIndex = 0;              // 在绘制顺序中的位置
+        cocos2d::Color3B tint = cocos2d::Color3B::WHITE;
+        unsigned char faceIndex = 0;     // 0~51: suit*13+face
+        bool faceUp = false;
+        bool visible = true;
+        bool dirty = true;
+        bool boundsDirty = true;         // 空间网格中的登记需要更新
+    };
+
+    void markDirty(int slot);
+    void markBoundsDirty(int slot);
+    void updateHitGrid();
+    cocos2d::Rect getCardBounds(const CardQuad& card) const;
+    void updateDrawOrder();
+    void updateVertices();
+    void writeQuad(const CardQuad& card, cocos2d::V3F_C4B_T2F* vertices) const;
+    bool containsPoint(const CardQuad& card, const cocos2d::Vec2& point) const;
+
+    void setupBuffers();
+    void onDraw(const cocos2d::Mat4& transform, uint32_t flags);
+
+    std::vector<CardQuad> _cards;
+    std::vector<int> _drawOrder;                 // 按层级排序后的槽位
+    std::vector<int> _dirtySlots;
+    std::vector<int> _boundsDirtySlots;
+    CardSpatialGrid _hitGrid;
+    std::vector<cocos2d::V3F_C4B_T2F> _vertices; // 按绘制顺序，每张牌4个顶点
+    std::vector<GLushort> _indices;
+
+    UVRect _faceUVs[52];
+    UVRect _backUV;
+    cocos2d::Size _cardSize;
+    cocos2d::Texture2D* _texture = nullptr;
+    cocos2d::BlendFunc _blendFunc = cocos2d::BlendFunc::ALPHA_PREMULTIPLIED;
+
+    cocos2d::CustomCommand _customCommand;
+    GLuint _vbo = 0;
+    GLuint _ibo = 0;
+    std::size_t _uploadedIndexQuads = 0;
+    bool _orderDirty = true;
+    bool _bufferDirty = true;
+};
+
+} // namespace tripeaks
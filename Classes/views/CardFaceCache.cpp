@@ -0,0 +1,399 @@
+#include "views/CardFaceCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+std::string faceToString(CardFaceType face)
+{
+    switch (face)
+    {
+    case CardFaceType::Ace:
+        return "A";
+    case CardFaceType::Two:
+        return "2";
+    case CardFaceType::Three:
+        return "3";
+    case CardFaceType::Four:
+        return "4";
+    case CardFaceType::Five:
+        return "5";
+    case CardFaceType::Six:
+        return "6";
+    case CardFaceType::Seven:
+        return "7";
+    case CardFaceType::Eight:
+        return "8";
+    case CardFaceType::Nine:
+        return "9";
+    case CardFaceType::Ten:
+        return "10";
+    case CardFaceType::Jack:
+        return "J";
+    case CardFaceType::Queen:
+        return "Q";
+    case CardFaceType::King:
+        return "K";
+    default:
+        return "?";
+    }
+}
+
+bool isRedSuit(CardSuit suit)
+{
+    return suit == CardSuit::Hearts || suit == CardSuit::Diamonds;
+}
+
+// 由 tools/pack_card_atlas.py 离线打包，帧名为相对 res/ 的资源路径；
+// 各分辨率档位的帧名相同，scale 为图集像素相对原始资源的比例，按 scale 升序排列
+struct AtlasVariant
+{
+    const char* plist;
+    const char* texture;
+    float scale;
+};
+
+constexpr AtlasVariant kAtlasVariants[] = {
+    {"res/card_atlas_small.plist", "res/card_atlas_small.png", 0.5F},
+    {"res/card_atlas_medium.plist", "res/card_atlas_medium.png", 0.75F},
+    {"res/card_atlas.plist", "res/card_atlas.png", 1.0F},
+};
+const char* const kCardFrameName = "card_general.png";
+
+// 纹理页按 8x7 网格排布 52 张牌面 + 1 张牌背
+constexpr int kPageColumns = 8;
+constexpr int kPageRows = 7;
+constexpr int kBackCellIndex = 52;
+
+// 烘焙缩放上限（卡牌显示缩放不超过0.7）以及纹理页像素尺寸上限
+constexpr float kMaxBakeScale = 0.7F;
+constexpr float kMinBakeScale = 0.25F;
+constexpr float kMaxPagePixels = 2048.0F;
+
+/**
+ * 牌面在屏幕上相对原始资源所需的最大像素密度。
+ * 精灵的点尺寸 = 资源像素 / 内容缩放因子，点到屏幕像素的比例为 GLView 的缩放，
+ * 因此显示缩放为 kMaxBakeScale 时每个原始像素对应 kMaxBakeScale * glScale / contentScale 个屏幕像素。
+ * 小分辨率档位上该值远小于1，无需上传和采样全分辨率的图集。
+ */
+float getRequiredSourceScale()
+{
+    auto director = cocos2d::Director::getInstance();
+    const cocos2d::GLView* glview = director->getOpenGLView();
+    const float contentScale = director->getContentScaleFactor();
+    if (!glview || contentScale <= 0.0F)
+    {
+        return kMaxBakeScale;
+    }
+    return std::max(kMinBakeScale, std::min(kMaxBakeScale, kMaxBakeScale * glview->getScaleY() / contentScale));
+}
+
+// 满足所需像素密度的最小档位；图集文件都不存在时返回nullptr，回退到散图
+const AtlasVariant* selectAtlasVariant()
+{
+    const float required = getRequiredSourceScale();
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    const AtlasVariant* fallback = nullptr;
+    for (const AtlasVariant& variant : kAtlasVariants)
+    {
+        if (!fileUtils->isFileExist(variant.plist))
+        {
+            continue;
+        }
+        if (variant.scale >= required)
+        {
+            return &variant;
+        }
+        fallback = &variant;
+    }
+    return fallback;
+}
+
+int toFaceIndex(CardFaceType face, CardSuit suit)
+{
+    return static_cast<int>(suit) * 13 + static_cast<int>(face);
+}
+
+} // namespace
+
+CardFaceCache::~CardFaceCache()
+{
+    for (cocos2d::SpriteFrame* frame : _faceFrames)
+    {
+        CC_SAFE_RELEASE(frame);
+    }
+    CC_SAFE_RELEASE(_backFrame);
+    CC_SAFE_RELEASE(_page);
+}
+
+bool CardFaceCache::build()
+{
+    if (_page)
+    {
+        return true;
+    }
+
+    loadAtlas();
+
+    // 低分辨率档位的图集按其比例放大绘制，使卡牌的逻辑尺寸与原始资源一致
+    const AtlasVariant* variant = selectAtlasVariant();
+    const float atlasScale = variant ? variant->scale : 1.0F;
+    cocos2d::Size cardSize = createBackNode()->getContentSize();
+    cardSize.width /= atlasScale;
+    cardSize.height /= atlasScale;
+
+    // 纹理页中每个原始像素对应 _bakeScale 个纹素，只需覆盖屏幕上的实际显示密度
+    const float contentScale = cocos2d::Director::getInstance()->getContentScaleFactor();
+    _bakeScale = std::min({getRequiredSourceScale(),
+                           kMaxPagePixels / (contentScale * cardSize.width * kPageColumns),
+                           kMaxPagePixels / (contentScale * cardSize.height * kPageRows)});
+
+    const float cellWidth = std::ceil(cardSize.width * _bakeScale);
+    const float cellHeight = std::ceil(cardSize.height * _bakeScale);
+    _page = cocos2d::RenderTexture::create(static_cast<int>(cellWidth * kPageColumns),
+                                           static_cast<int>(cellHeight * kPageRows),
+                                           cocos2d::Texture2D::PixelFormat::RGBA8888);
+    if (!_page)
+    {
+        return false;
+    }
+    _page->retain();
+
+    cocos2d::Texture2D* texture = _page->getSprite()->getTexture();
+
+    _page->beginWithClear(0.0F, 0.0F, 0.0F, 0.0F);
+    for (int index = 0; index <= kBackCellIndex; ++index)
+    {
+        const cocos2d::Rect cell((index % kPageColumns) * cellWidth, (index / kPageColumns) * cellHeight,
+                                 cellWidth, cellHeight);
+
+        cocos2d::Sprite* node = index < kBackCellIndex
+            ? createFaceNode(static_cast<CardFaceType>(index % 13), static_cast<CardSuit>(index / 13))
+            : createBackNode();
+
+        // RenderTexture 的像素自下而上存储，竖直翻转绘制后帧矩形可直接按自上而下的纹理坐标使用
+        node->setScale(_bakeScale / atlasScale, -_bakeScale / atlasScale);
+        node->setPosition(cell.getMidX(), cell.getMidY());
+        node->visit();
+
+        cocos2d::SpriteFrame* frame = cocos2d::SpriteFrame::createWithTexture(texture, cell);
+        frame->retain();
+        if (index < kBackCellIndex)
+        {
+            _faceFrames[index] = frame;
+        }
+        else
+        {
+            _backFrame = frame;
+        }
+    }
+    _page->end();
+
+    texture->setAntiAliasTexParameters();
+
+    return true;
+}
+
+cocos2d::SpriteFrame* CardFaceCache::getFaceFrame(CardFaceType face, CardSuit suit) const
+{
+    const int index = toFaceIndex(face, suit);
+    if (index < 0 || index >= kFaceCount)
+    {
+        return nullptr;
+    }
+    return _faceFrames[index];
+}
+
+cocos2d::SpriteFrame* CardFaceCache::getBackFrame() const
+{
+    return _backFrame;
+}
+
+cocos2d::Texture2D* CardFaceCache::getTexture() const
+{
+    return _page ? _page->getSprite()->getTexture() : nullptr;
+}
+
+cocos2d::Sprite* CardFaceCache::createAtlasSprite(const std::string& frameName)
+{
+    // 优先使用图集中的帧以便同一纹理的精灵自动合批
+    if (cocos2d::SpriteFrame* frame = cocos2d::SpriteFrameCache::getInstance()->getSpriteFrameByName(frameName))
+    {
+        return cocos2d::Sprite::createWithSpriteFrame(frame);
+    }
+    return cocos2d::Sprite::create("res/" + frameName);
+}
+
+void CardFaceCache::loadAtlas()
+{
+    const AtlasVariant* variant = selectAtlasVariant();
+    auto frameCache = cocos2d::SpriteFrameCache::getInstance();
+    if (variant && !frameCache->isSpriteFramesWithFileLoaded(variant->plist))
+    {
+        frameCache->addSpriteFramesWithFile(variant->plist);
+    }
+}
+
+std::vector<std::string> CardFaceCache::getTexturePaths()
+{
+    if (const AtlasVariant* variant = selectAtlasVariant())
+    {
+        return {variant->texture};
+    }
+
+    std::vector<std::string> paths;
+    paths.emplace_back(std::string("res/") + kCardFrameName);
+    for (int face = 0; face < 13; ++face)
+    {
+        paths.emplace_back("res/" + getNumberFrameName(static_cast<CardFaceType>(face), false));
+        paths.emplace_back("res/" + getNumberFrameName(static_cast<CardFaceType>(face), true));
+    }
+    for (int suit = 0; suit < 4; ++suit)
+    {
+        paths.emplace_back("res/" + getSuitFrameName(static_cast<CardSuit>(suit)));
+    }
+    return paths;
+}
+
+cocos2d::Sprite* CardFaceCache::createBackNode() const
+{
+    cocos2d::Sprite* back = createAtlasSprite(kCardFrameName);
+    if (!back)
+    {
+        back = cocos2d::Sprite::create();
+        back->setTextureRect({0.0F, 0.0F, 128.0F, 170.0F});
+    }
+    back->setColor({26, 82, 173});
+    back->setAnchorPoint({0.5F, 0.5F});
+    return back;
+}
+
+cocos2d::Sprite* CardFaceCache::createFaceNode(CardFaceType face, CardSuit suit) const
+{
+    cocos2d::Sprite* front = createAtlasSprite(kCardFrameName);
+    if (!front)
+    {
+        front = cocos2d::Sprite::create();
+        front->setTextureRect({0.0F, 0.0F, 128.0F, 170.0F});
+        front->setColor({235, 235, 235});
+    }
+    front->setAnchorPoint({0.5F, 0.5F});
+
+    const cocos2d::Size cardSize = front->getContentSize();
+    const float halfWidth = cardSize.width * 0.5F;
+    const float halfHeight = cardSize.height * 0.5F;
+
+    const bool red = isRedSuit(suit);
+    const std::string numberFrame = getNumberFrameName(face, red);
+    const std::string suitFrame = getSuitFrameName(suit);
+
+    const float paddingX = cardSize.width * 0.08F;
+    const float paddingY = cardSize.height * 0.08F;
+    const float cornerSpacing = cardSize.height * 0.02F;
+    const float cornerShiftX = cardSize.width * 0.5F;
+    const float cornerShiftY = cardSize.height * 0.5F;
+    const float rankTargetHeight = cardSize.height * 0.22F;
+    const float cornerSuitTargetHeight = cardSize.height * 0.14F;
+    const float centerSuitTargetHeight = cardSize.height * 0.32F;
+    const float centerShiftX = cardSize.width * 0.5F;
+    const float centerShiftY = cardSize.height * 0.5F;
+
+    auto getNodeSize = [](cocos2d::Node* node) {
+        cocos2d::Size size = node->getContentSize();
+        size.width *= node->getScaleX();
+        size.height *= node->getScaleY();
+        return size;
+    };
+
+    auto createRankNode = [&]() -> cocos2d::Node* {
+        if (auto sprite = createAtlasSprite(numberFrame))
+        {
+            const float contentHeight = sprite->getContentSize().height;
+            if (contentHeight > 0.0F)
+            {
+                sprite->setScale(rankTargetHeight / contentHeight);
+            }
+            return sprite;
+        }
+
+        auto label = cocos2d::Label::createWithSystemFont(faceToString(face), "Arial", rankTargetHeight);
+        label->setColor(red ? cocos2d::Color3B::RED : cocos2d::Color3B::BLACK);
+        return label;
+    };
+
+    auto createSuitNode = [&](float targetHeight) -> cocos2d::Sprite* {
+        cocos2d::Sprite* sprite = createAtlasSprite(suitFrame);
+        if (!sprite)
+        {
+            sprite = cocos2d::Sprite::create();
+            sprite->setTextureRect({0.0F, 0.0F, 50.0F, 50.0F});
+            sprite->setColor(red ? cocos2d::Color3B::RED : cocos2d::Color3B::BLACK);
+        }
+        const float contentHeight = sprite->getContentSize().height;
+        if (contentHeight > 0.0F)
+        {
+            sprite->setScale(targetHeight / contentHeight);
+        }
+        return sprite;
+    };
+
+    // 左上角与右下角（旋转180度）的点数+花色角标
+    auto addCorner = [&](const cocos2d::Vec2& anchor, const cocos2d::Vec2& position, float rotation) {
+        auto container = cocos2d::Node::create();
+        container->ignoreAnchorPointForPosition(false);
+        container->setAnchorPoint(anchor);
+        container->setPosition(position);
+        container->setRotation(rotation);
+        front->addChild(container, 2);
+
+        cocos2d::Node* rankNode = createRankNode();
+        rankNode->setAnchorPoint({0.0F, 1.0F});
+        rankNode->setPosition({0.0F, 0.0F});
+        container->addChild(rankNode);
+
+        cocos2d::Sprite* suitNode = createSuitNode(cornerSuitTargetHeight);
+        suitNode->setAnchorPoint({0.0F, 1.0F});
+        suitNode->setPosition({0.0F, -getNodeSize(rankNode).height - cornerSpacing});
+        container->addChild(suitNode);
+    };
+
+    addCorner({0.0F, 1.0F}, {-halfWidth + paddingX + cornerShiftX, halfHeight - paddingY + cornerShiftY}, 0.0F);
+    addCorner({1.0F, 0.0F}, {halfWidth - paddingX + cornerShiftX, -halfHeight + paddingY + cornerShiftY}, 180.0F);
+
+    cocos2d::Sprite* centerSuit = createSuitNode(centerSuitTargetHeight);
+    centerSuit->setAnchorPoint({0.5F, 0.5F});
+    centerSuit->setPosition({centerShiftX, centerShiftY});
+    front->addChild(centerSuit, 1);
+
+    return front;
+}
+
+std::string CardFaceCache::getNumberFrameName(CardFaceType face, bool isRed)
+{
+    const std::string prefix = isRed ? "number/small_red_" : "number/small_black_";
+    return prefix + faceToString(face) + ".png";
+}
+
+std::string CardFaceCache::getSuitFrameName(CardSuit suit)
+{
+    switch (suit)
+    {
+    case CardSuit::Clubs:
+        return "suits/club.png";
+    case CardSuit::Diamonds:
+        return "suits/diamond.png";
+    case CardSuit::Hearts:
+        return "suits/heart.png";
+    case CardSuit::Spades:
+        return "suits/spade.png";
+    default:
+        return "";
+    }
+}
+
+} // namespace tripeaks
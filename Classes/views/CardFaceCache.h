@@ -0,0 +1,70 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include "configs/models/LevelConfig.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 卡牌牌面烘焙缓存。
+ * 将52种点数/花色组合的牌面（底图、角标点数花色及其镜像、中心花色）以及牌背
+ * 一次性渲染到同一张离屏纹理页上，每张卡牌只需一个牌面精灵和一个牌背精灵即可显示，
+ * 避免每张牌十余个节点的变换与遍历开销，且所有卡牌共享同一纹理便于合批。
+ * 由 GameView 持有，生命周期与视图一致。
+ */
+class CardFaceCache
+{
+public:
+    CardFaceCache() = default;
+    ~CardFaceCache();
+
+    CardFaceCache(const CardFaceCache&) = delete;
+    CardFaceCache& operator=(const CardFaceCache&) = delete;
+
+    /**
+     * 加载卡牌图集并烘焙全部牌面，重复调用时直接返回已有结果
+     * @return 烘焙成功返回true
+     */
+    bool build();
+    bool isBuilt() const { return _page != nullptr; }
+
+    // 牌面/牌背在纹理页上的帧，未烘焙时返回nullptr
+    cocos2d::SpriteFrame* getFaceFrame(CardFaceType face, CardSuit suit) const;
+    cocos2d::SpriteFrame* getBackFrame() const;
+
+    cocos2d::Texture2D* getTexture() const;
+
+    // 烘焙缩放：纹理页中的牌面尺寸 = 原始卡牌尺寸 * bakeScale，显示时需乘以 1/bakeScale 还原
+    float getBakeScale() const { return _bakeScale; }
+
+    // 从卡牌图集创建精灵，图集缺失时回退到 res/ 下的散图
+    static cocos2d::Sprite* createAtlasSprite(const std::string& frameName);
+
+    // 把卡牌图集的帧注册到 SpriteFrameCache；纹理已在 TextureCache 中时不再解码
+    static void loadAtlas();
+
+    // 烘焙牌面所需的全部纹理文件：图集存在时只有图集纹理，否则为各张散图
+    static std::vector<std::string> getTexturePaths();
+
+private:
+    cocos2d::Sprite* createFaceNode(CardFaceType face, CardSuit suit) const;
+    cocos2d::Sprite* createBackNode() const;
+
+    static std::string getNumberFrameName(CardFaceType face, bool isRed);
+    static std::string getSuitFrameName(CardSuit suit);
+
+    static constexpr int kFaceCount = 52;
+
+    cocos2d::RenderTexture* _page = nullptr;
+    std::array<cocos2d::SpriteFrame*, kFaceCount> _faceFrames{};
+    cocos2d::SpriteFrame* _backFrame = nullptr;
+    float _bakeScale = 1.0F;
+};
+
+} // namespace tripeaks
@@ -0,0 +1,146 @@
+#include "views/CardSpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr std::size_t kMinBucketCount = 64;
+
+std::size_t nextPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+void CardSpatialGrid::reset(std::size_t cardCount, const cocos2d::Size& cellSize)
+{
+    _inverseCellWidth = cellSize.width > 0.0F ? 1.0F / cellSize.width : 1.0F;
+    _inverseCellHeight = cellSize.height > 0.0F ? 1.0F / cellSize.height : 1.0F;
+
+    for (std::vector<int>& bucket : _buckets)
+    {
+        bucket.clear();
+    }
+    _ranges.clear();
+
+    const std::size_t bucketCount = nextPowerOfTwo(std::max(kMinBucketCount, cardCount));
+    if (bucketCount > _buckets.size())
+    {
+        _buckets.resize(bucketCount);
+    }
+    _bucketMask = _buckets.size() - 1;
+}
+
+void CardSpatialGrid::update(int slot, const cocos2d::Rect& bounds, bool visible)
+{
+    if (slot >= static_cast<int>(_ranges.size()))
+    {
+        _ranges.resize(slot + 1);
+        // 桶数量保持在卡牌数量的同一量级，保证每个桶内候选数量为常数
+        if (_ranges.size() > _buckets.size() * 2)
+        {
+            rehash(_buckets.size() * 4);
+        }
+    }
+
+    CellRange range;
+    if (visible)
+    {
+        range.minX = toCellX(bounds.getMinX());
+        range.minY = toCellY(bounds.getMinY());
+        range.maxX = toCellX(bounds.getMaxX());
+        range.maxY = toCellY(bounds.getMaxY());
+    }
+
+    CellRange& current = _ranges[slot];
+    if (current == range)
+    {
+        return;
+    }
+
+    erase(slot, current);
+    insert(slot, range);
+    current = range;
+}
+
+const std::vector<int>& CardSpatialGrid::getCandidates(const cocos2d::Vec2& point) const
+{
+    static const std::vector<int> kEmpty;
+    if (_buckets.empty())
+    {
+        return kEmpty;
+    }
+    return _buckets[toBucket(toCellX(point.x), toCellY(point.y))];
+}
+
+int CardSpatialGrid::toCellX(float x) const
+{
+    return static_cast<int>(std::floor(x * _inverseCellWidth));
+}
+
+int CardSpatialGrid::toCellY(float y) const
+{
+    return static_cast<int>(std::floor(y * _inverseCellHeight));
+}
+
+std::size_t CardSpatialGrid::toBucket(int cellX, int cellY) const
+{
+    const unsigned int hash = static_cast<unsigned int>(cellX) * 73856093U ^ static_cast<unsigned int>(cellY) * 19349663U;
+    return hash & _bucketMask;
+}
+
+void CardSpatialGrid::insert(int slot, const CellRange& range)
+{
+    for (int cellY = range.minY; cellY <= range.maxY; ++cellY)
+    {
+        for (int cellX = range.minX; cellX <= range.maxX; ++cellX)
+        {
+            _buckets[toBucket(cellX, cellY)].emplace_back(slot);
+        }
+    }
+}
+
+void CardSpatialGrid::erase(int slot, const CellRange& range)
+{
+    for (int cellY = range.minY; cellY <= range.maxY; ++cellY)
+    {
+        for (int cellX = range.minX; cellX <= range.maxX; ++cellX)
+        {
+            std::vector<int>& bucket = _buckets[toBucket(cellX, cellY)];
+            auto iter = std::find(bucket.begin(), bucket.end(), slot);
+            if (iter != bucket.end())
+            {
+                *iter = bucket.back();
+                bucket.pop_back();
+            }
+        }
+    }
+}
+
+void CardSpatialGrid::rehash(std::size_t bucketCount)
+{
+    for (std::vector<int>& bucket : _buckets)
+    {
+        bucket.clear();
+    }
+    _buckets.resize(nextPowerOfTwo(bucketCount));
+    _bucketMask = _buckets.size() - 1;
+
+    for (std::size_t slot = 0; slot < _ranges.size(); ++slot)
+    {
+        insert(static_cast<int>(slot), _ranges[slot]);
+    }
+}
+
+} // namespace tripeaks
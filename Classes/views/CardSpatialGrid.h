@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include <vector>
+
+namespace tripeaks
+{
+
+/**
+ * 卡牌触摸命中用的空间哈希网格。
+ * 以卡牌尺寸为单元格将牌桌（CardBatchNode 坐标系）划分为网格，每张卡牌登记在其包围盒覆盖的
+ * 单元格中（通常不超过4个）。单元格坐标哈希到固定数量的桶，查询时只需检查触点所在桶内的少量卡牌，
+ * 与牌桌规模无关。卡牌移动时只在覆盖的单元格范围变化时才更新登记。
+ */
+class CardSpatialGrid
+{
+public:
+    // 清空并按卡牌数量与单元格尺寸重新初始化（保留已分配的容量）
+    void reset(std::size_t cardCount, const cocos2d::Size& cellSize);
+
+    // 更新卡牌包围盒；visible为false时从网格移除
+    void update(int slot, const cocos2d::Rect& bounds, bool visible);
+
+    // 返回触点所在桶内的候选卡牌（可能包含不覆盖该点或重复的槽位，需调用方精确判定）
+    const std::vector<int>& getCandidates(const cocos2d::Vec2& point) const;
+
+private:
+    struct CellRange
+    {
+        int minX = 0;
+        int minY = 0;
+        int maxX = -1;
+        int maxY = -1;
+
+        bool operator==(const CellRange& other) const
+        {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    int toCellX(float x) const;
+    int toCellY(float y) const;
+    std::size_t toBucket(int cellX, int cellY) const;
+
+    void insert(int slot, const CellRange& range);
+    void erase(int slot, const CellRange& range);
+    void rehash(std::size_t bucketCount);
+
+    std::vector<std::vector<int>> _buckets;
+    std::vector<CellRange> _ranges;          // 每个槽位当前登记的单元格范围
+    std::size_t _bucketMask = 0;
+    float _inverseCellWidth = 1.0F;
+    float _inverseCellHeight = 1.0F;
+};
+
+} // namespace tripeaks
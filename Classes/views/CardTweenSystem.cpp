@@ -0,0 +1,286 @@
+#include "views/CardTweenSystem.h"
+
+#include "utils/TraceRecorder.h"
+#include "views/CardBatchNode.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+// 动画生命周期在时间线上显示为以 槽位*通道 为 id 的异步区间
+const char* const kTraceCategory = "anim";
+
+} // namespace
+
+void CardTweenSystem::setBatch(CardBatchNode* batch)
+{
+    _batch = batch;
+    clear();
+}
+
+void CardTweenSystem::moveTo(int slot, const cocos2d::Vec2& target, float duration, Ease ease)
+{
+    if (!_batch)
+    {
+        return;
+    }
+
+    // 新建或重定向：都从卡牌当前所在的位置出发
+    if (findTween(slot, Channel::Move))
+    {
+        TRIPEAKS_TRACE_INSTANT(kTraceCategory, "retarget");
+    }
+    Tween& tween = acquireTween(slot, Channel::Move);
+    tween.ease = ease;
+    tween.elapsed = 0.0F;
+    tween.duration = duration;
+    tween.from = _batch->getCardPosition(slot);
+    tween.to = target;
+}
+
+void CardTweenSystem::flipTo(int slot, bool faceUp, float duration, float fullScale)
+{
+    if (!_batch)
+    {
+        return;
+    }
+
+    if (Tween* tween = findTween(slot, Channel::Flip))
+    {
+        if (tween->faceUp == faceUp)
+        {
+            return;
+        }
+
+        // 折返：镜像翻转进度，当前显示的面保持不变
+        TRIPEAKS_TRACE_INSTANT(kTraceCategory, "reverseFlip");
+        const float progress = tween->duration > 0.0F ? std::min(tween->elapsed / tween->duration, 1.0F) : 1.0F;
+        tween->duration = duration;
+        tween->elapsed = (1.0F - progress) * duration;
+        tween->fullScale = fullScale;
+        tween->faceUp = faceUp;
+        tween->swapped = !tween->swapped;
+        tween->fence = _fence;
+        return;
+    }
+
+    Tween& tween = acquireTween(slot, Channel::Flip);
+    tween.ease = Ease::Linear;
+    tween.elapsed = 0.0F;
+    tween.duration = duration;
+    tween.fullScale = fullScale;
+    tween.faceUp = faceUp;
+    tween.swapped = false;
+}
+
+void CardTweenSystem::cancel(int slot)
+{
+    for (int channel = 0; channel < kChannelCount; ++channel)
+    {
+        const std::size_t key = static_cast<std::size_t>(slot) * kChannelCount + channel;
+        if (key >= _tweenIndex.size() || _tweenIndex[key] < 0)
+        {
+            continue;
+        }
+
+        const std::size_t index = static_cast<std::size_t>(_tweenIndex[key]);
+        if (_tweens[index].channel == Channel::Flip)
+        {
+            finishFlip(_tweens[index]);
+        }
+        removeTween(index);
+    }
+}
+
+void CardTweenSystem::clear()
+{
+#if TRIPEAKS_ENABLE_TRACING
+    for (const Tween& tween : _tweens)
+    {
+        TRIPEAKS_TRACE_ASYNC_END(kTraceCategory, getTraceName(tween.channel),
+                                 static_cast<std::uint64_t>(tween.slot) * kChannelCount + static_cast<int>(tween.channel));
+    }
+#endif
+    _tweens.clear();
+    std::fill(_tweenIndex.begin(), _tweenIndex.end(), -1);
+}
+
+void CardTweenSystem::finishAll()
+{
+    if (!_batch)
+    {
+        return;
+    }
+
+    for (Tween& tween : _tweens)
+    {
+        tween.elapsed = tween.duration;
+        apply(tween);
+    }
+    clear();
+}
+
+std::uint32_t CardTweenSystem::getSettledFence() const
+{
+    std::uint32_t settled = _fence;
+    for (const Tween& tween : _tweens)
+    {
+        if (tween.fence <= settled)
+        {
+            settled = tween.fence > 0 ? tween.fence - 1 : 0;
+        }
+    }
+    return settled;
+}
+
+bool CardTweenSystem::isAnimating(int slot) const
+{
+    for (int channel = 0; channel < kChannelCount; ++channel)
+    {
+        const std::size_t key = static_cast<std::size_t>(slot) * kChannelCount + channel;
+        if (key < _tweenIndex.size() && _tweenIndex[key] >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CardTweenSystem::update(float delta)
+{
+    if (!_batch)
+    {
+        return;
+    }
+
+    delta *= _timeScale;
+    std::size_t index = 0;
+    while (index < _tweens.size())
+    {
+        Tween& tween = _tweens[index];
+        tween.elapsed += delta;
+        apply(tween);
+
+        if (tween.elapsed >= tween.duration)
+        {
+            // 末尾元素换入当前位置，本轮继续处理它
+            removeTween(index);
+            continue;
+        }
+        ++index;
+    }
+}
+
+const char* CardTweenSystem::getTraceName(Channel channel)
+{
+    return channel == Channel::Flip ? "flip" : "move";
+}
+
+float CardTweenSystem::applyEase(Ease ease, float t)
+{
+    switch (ease)
+    {
+    case Ease::QuadOut:
+        return 1.0F - (1.0F - t) * (1.0F - t);
+    case Ease::CubicInOut:
+        if (t < 0.5F)
+        {
+            return 4.0F * t * t * t;
+        }
+        else
+        {
+            const float inverse = -2.0F * t + 2.0F;
+            return 1.0F - inverse * inverse * inverse * 0.5F;
+        }
+    case Ease::Linear:
+    default:
+        return t;
+    }
+}
+
+CardTweenSystem::Tween* CardTweenSystem::findTween(int slot, Channel channel)
+{
+    const std::size_t key = static_cast<std::size_t>(slot) * kChannelCount + static_cast<int>(channel);
+    if (key >= _tweenIndex.size() || _tweenIndex[key] < 0)
+    {
+        return nullptr;
+    }
+    return &_tweens[static_cast<std::size_t>(_tweenIndex[key])];
+}
+
+CardTweenSystem::Tween& CardTweenSystem::acquireTween(int slot, Channel channel)
+{
+    if (Tween* existing = findTween(slot, channel))
+    {
+        existing->fence = _fence;
+        return *existing;
+    }
+
+    const std::size_t key = static_cast<std::size_t>(slot) * kChannelCount + static_cast<int>(channel);
+    if (key >= _tweenIndex.size())
+    {
+        _tweenIndex.resize(key + 1, -1);
+    }
+    _tweenIndex[key] = static_cast<int>(_tweens.size());
+
+    Tween tween;
+    tween.slot = slot;
+    tween.channel = channel;
+    tween.fence = _fence;
+    _tweens.emplace_back(tween);
+    TRIPEAKS_TRACE_ASYNC_BEGIN(kTraceCategory, getTraceName(channel), key);
+    return _tweens.back();
+}
+
+void CardTweenSystem::removeTween(std::size_t index)
+{
+    const Tween& removed = _tweens[index];
+    const std::size_t key = static_cast<std::size_t>(removed.slot) * kChannelCount + static_cast<int>(removed.channel);
+    _tweenIndex[key] = -1;
+    TRIPEAKS_TRACE_ASYNC_END(kTraceCategory, getTraceName(removed.channel), key);
+
+    const std::size_t last = _tweens.size() - 1;
+    if (index != last)
+    {
+        _tweens[index] = _tweens[last];
+        const Tween& moved = _tweens[index];
+        _tweenIndex[static_cast<std::size_t>(moved.slot) * kChannelCount + static_cast<int>(moved.channel)] =
+            static_cast<int>(index);
+    }
+    _tweens.pop_back();
+}
+
+void CardTweenSystem::finishFlip(const Tween& tween)
+{
+    _batch->setCardScale(tween.slot, tween.fullScale, tween.fullScale);
+    _batch->setCardFaceUp(tween.slot, tween.faceUp);
+}
+
+void CardTweenSystem::apply(Tween& tween)
+{
+    const float progress = tween.duration > 0.0F ? std::min(tween.elapsed / tween.duration, 1.0F) : 1.0F;
+    const float eased = applyEase(tween.ease, progress);
+
+    switch (tween.channel)
+    {
+    case Channel::Move:
+        _batch->setCardPosition(tween.slot, tween.from.lerp(tween.to, eased));
+        break;
+    case Channel::Flip:
+        // 前半段横向收缩到0，越过中点时换面，后半段展开
+        if (!tween.swapped && eased >= 0.5F)
+        {
+            _batch->setCardFaceUp(tween.slot, tween.faceUp);
+            tween.swapped = true;
+        }
+        _batch->setCardScale(tween.slot, std::abs(1.0F - 2.0F * eased) * tween.fullScale, tween.fullScale);
+        break;
+    }
+}
+
+} // namespace tripeaks
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "cocos2d.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tripeaks
+{
+
+class CardBatchNode;
+
+/**
+ * 卡牌补间动画系统。
+ * 所有进行中的补间保存在一个连续数组中，由 GameView 每帧统一推进一次，直接写入 CardBatchNode 的槽位；
+ * 缓动曲线用 switch 计算，不创建 cocos2d::Action，也没有逐动画的内存分配。
+ * 每个槽位的移动与翻面各至多一个补间，再次发起时从当前状态重新指向新目标（快速连点、动画中撤销）。
+ */
+class CardTweenSystem
+{
+public:
+    enum class Ease
+    {
+        Linear,
+        QuadOut,
+        CubicInOut
+    };
+
+    void setBatch(CardBatchNode* batch);
+
+    // 移动到目标位置；该槽位已有移动补间时从当前位置改为飞向新目标
+    void moveTo(int slot, const cocos2d::Vec2& target, float duration, Ease ease = Ease::Linear);
+
+    /**
+     * 翻面：横向缩放到0时切换正反面，再恢复到 fullScale
+     * 翻转途中改变目标时就地折返，不会跳变
+     */
+    void flipTo(int slot, bool faceUp, float duration, float fullScale);
+
+    // 停止该槽位的所有补间：移动停在当前位置，翻面直接落到最终状态
+    void cancel(int slot);
+    // 丢弃所有补间（卡牌槽位即将被清空时使用）
+    void clear();
+    // 所有补间直接落到终点后移除（新操作到来时收起上一批动画）
+    void finishAll();
+
+    bool isAnimating(int slot) const;
+
+    /**
+     * 动画栅栏：之后新建、重定向或折返的补间都记上该编号（编号只增不减）。
+     * getSettledFence 返回的编号及之前发起的补间都已结束或被后来的操作接管，
+     * 调用方据此等待某一批操作的动画播完，动画中回退时旧批次随之视为完成。
+     */
+    void setFence(std::uint32_t fence) { _fence = fence; }
+    std::uint32_t getSettledFence() const;
+    bool empty() const { return _tweens.empty(); }
+    std::size_t getActiveCount() const { return _tweens.size(); }
+
+    // 时间缩放：大于1时所有补间加速推进（快速模式）
+    void setTimeScale(float timeScale) { _timeScale = timeScale; }
+    float getTimeScale() const { return _timeScale; }
+
+    void update(float delta);
+
+private:
+    enum class Channel
+    {
+        Move = 0,
+        Flip = 1
+    };
+    static constexpr int kChannelCount = 2;
+
+    struct Tween
+    {
+        int slot = -1;
+        Channel channel = Channel::Move;
+        Ease ease = Ease::Linear;
+        float elapsed = 0.0F;
+        float duration = 0.0F;
+        cocos2d::Vec2 from;           // Move
+        cocos2d::Vec2 to;             // Move
+        float fullScale = 1.0F;       // Flip
+        bool faceUp = false;          // Flip: 目标面
+        bool swapped = false;         // Flip: 是否已切换到目标面
+        std::uint32_t fence = 0;      // 最近一次发起或改变目标时的栅栏编号
+    };
+
+    static float applyEase(Ease ease, float t);
+    static const char* getTraceName(Channel channel);
+
+    Tween* findTween(int slot, Channel channel);
+    Tween& acquireTween(int slot, Channel channel);
+    void removeTween(std::size_t index);
+    void finishFlip(const Tween& tween);
+    void apply(Tween& tween);
+
+    CardBatchNode* _batch = nullptr;
+    std::vector<Tween> _tweens;
+    std::vector<int> _tweenIndex;     // slot * kChannelCount + channel -> _tweens 中的索引，-1 表示无
+    float _timeScale = 1.0F;
+    std::uint32_t _fence = 0;
+};
+
+} // namespace tripeaks
@@ -1,9 +1,12 @@
 #include "views/GameView.h"
 
 #include "ui/CocosGUI.h"
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
+#include "views/ProfilerHudView.h"
 
 #include <algorithm>
-#include <sstream>
+#include <string>
 
 namespace tripeaks
 {
@@ -25,49 +28,31 @@ T clampValue(T value, T minValue, T maxValue)
     return value;
 }
 
-std::string faceToString(CardFaceType face)
+cocos2d::Vec2 toScenePosition(const CardPosition& position)
 {
-    switch (face)
-    {
-    case CardFaceType::Ace:
-        return "A";
-    case CardFaceType::Two:
-        return "2";
-    case CardFaceType::Three:
-        return "3";
-    case CardFaceType::Four:
-        return "4";
-    case CardFaceType::Five:
-        return "5";
-    case CardFaceType::Six:
-        return "6";
-    case CardFaceType::Seven:
-        return "7";
-    case CardFaceType::Eight:
-        return "8";
-    case CardFaceType::Nine:
-        return "9";
-    case CardFaceType::Ten:
-        return "10";
-    case CardFaceType::Jack:
-        return "J";
-    case CardFaceType::Queen:
-        return "Q";
-    case CardFaceType::King:
-        return "K";
-    default:
-        return "?";
-    }
-}
-
-bool isRedSuit(CardSuit suit)
-{
-    return suit == CardSuit::Hearts || suit == CardSuit::Diamonds;
+    return cocos2d::Vec2(position.x, position.y);
 }
 
 constexpr float kDesignWidth = 1080.0F;
 constexpr float kDesignHeight = 2080.0F;
 
+// 备用牌堆只展开显示顶部若干张，其余折叠为一个牌堆四边形
+constexpr int kVisibleStockCards = 8;
+constexpr int kStockPileZOrder = 499;
+// 弃牌堆顶部牌位于手牌区顶部牌（800）之下
+constexpr int kWasteZOrder = 790;
+
+constexpr float kMoveDuration = 0.2F;
+constexpr float kFlipDuration = 0.2F;
+
+// 上一批动画播完前连续到来的输入达到该数量视为积压，动画加速直到全部结束
+constexpr std::size_t kTurboInputBacklog = 3;
+constexpr float kTurboTimeScale = 3.0F;
+
+const cocos2d::Color3B kHintTint(255, 214, 96);
+// 备用牌堆顶部是牌背，乘色着色在深色牌背上看不出来，改为在触摸区域上叠一层半透明的提示色
+constexpr unsigned char kStockHintOpacity = 140;
+
 } // namespace
 
 bool GameView::init()
@@ -120,7 +105,37 @@ bool GameView::init()
     });
     undoItem->setPosition(origin.x + visibleSize.width - 80.0F,
                           origin.y + visibleSize.height - 60.0F);
-    auto menu = cocos2d::Menu::create(undoItem, nullptr);
+
+    auto restartLabel = cocos2d::Label::createWithSystemFont("Restart", "Arial", 32);
+    auto restartItem = cocos2d::MenuItemLabel::create(restartLabel, [this](cocos2d::Ref*) {
+        if (_onRestartTapped)
+        {
+            _onRestartTapped();
+        }
+    });
+    restartItem->setPosition(origin.x + 100.0F,
+                             origin.y + visibleSize.height - 60.0F);
+
+    auto hintLabel = cocos2d::Label::createWithSystemFont("Hint", "Arial", 32);
+    auto hintItem = cocos2d::MenuItemLabel::create(hintLabel, [this](cocos2d::Ref*) {
+        if (_onHintTapped)
+        {
+            _onHintTapped();
+        }
+    });
+    hintItem->setPosition(origin.x + visibleSize.width - 80.0F,
+                          origin.y + visibleSize.height - 130.0F);
+
+    auto raceLabel = cocos2d::Label::createWithSystemFont("Race", "Arial", 32);
+    auto raceItem = cocos2d::MenuItemLabel::create(raceLabel, [this](cocos2d::Ref*) {
+        if (_onRaceTapped)
+        {
+            _onRaceTapped();
+        }
+    });
+    raceItem->setPosition(origin.x + 100.0F,
+                          origin.y + visibleSize.height - 130.0F);
+    auto menu = cocos2d::Menu::create(undoItem, restartItem, hintItem, raceItem, nullptr);
     menu->setPosition({0.0F, 0.0F});
     _uiLayer->addChild(menu);
 
@@ -131,17 +146,28 @@ bool GameView::init()
     _victoryLabel->setVisible(false);
     _uiLayer->addChild(_victoryLabel);
 
-    cocos2d::Sprite* stockPlaceholder = cocos2d::Sprite::create("res/card_general.png");
-    if (!stockPlaceholder)
+    if (!_faceCache.build())
     {
-        stockPlaceholder = cocos2d::Sprite::create();
-        stockPlaceholder->setTextureRect({0.0F, 0.0F, 128.0F, 170.0F});
-        stockPlaceholder->setColor({40, 40, 40});
+        return false;
     }
+
+    _cardBatch = CardBatchNode::create(_faceCache);
+    if (!_cardBatch)
+    {
+        return false;
+    }
+    _cardLayer->addChild(_cardBatch, 0);
+    _tweens.setBatch(_cardBatch);
+    attachBoardListener();
+
+    // 备用牌堆的触摸区域只需与卡牌逻辑尺寸一致，不依赖图集档位
+    const cocos2d::Size& cardSize = _cardBatch->getCardSize();
+    cocos2d::Sprite* stockPlaceholder = cocos2d::Sprite::create();
+    stockPlaceholder->setTextureRect({0.0F, 0.0F, cardSize.width, cardSize.height});
     stockPlaceholder->setOpacity(0);
     stockPlaceholder->setScale(_cardScale);
     stockPlaceholder->setPosition(_stockBasePosition);
-    _cardLayer->addChild(stockPlaceholder, 5);
+    _cardLayer->addChild(stockPlaceholder, 900);
     _stockTouchNode = stockPlaceholder;
 
     auto listener = cocos2d::EventListenerTouchOneByOne::create();
@@ -164,10 +190,131 @@ bool GameView::init()
     _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, _stockTouchNode);
 
     updateCardScale();
+    scheduleUpdate();
+
+#if TRIPEAKS_ENABLE_PROFILER
+    // 调试构建提供性能浮层开关
+    auto hud = ProfilerHudView::create();
+    hud->setPosition(origin.x + 20.0F, origin.y + 100.0F);
+    if (cocos2d::Texture2D* pageTexture = _faceCache.getTexture())
+    {
+        hud->setExtraTextureBytes(static_cast<std::size_t>(pageTexture->getPixelsWide()) *
+                                  pageTexture->getPixelsHigh() * 4);
+    }
+    _uiLayer->addChild(hud, 100);
+
+    auto hudLabel = cocos2d::Label::createWithSystemFont("Perf", "Arial", 26);
+    auto hudItem = cocos2d::MenuItemLabel::create(hudLabel, [hud](cocos2d::Ref*) { hud->toggle(); });
+    hudItem->setPosition(origin.x + 60.0F, origin.y + 50.0F);
+    auto hudMenu = cocos2d::Menu::create(hudItem, nullptr);
+    hudMenu->setPosition({0.0F, 0.0F});
+    _uiLayer->addChild(hudMenu, 100);
+#endif
+
+#if TRIPEAKS_ENABLE_TRACING
+    // 把最近的时间线导出到可写目录，用 chrome://tracing 或 Perfetto 打开
+    auto traceLabel = cocos2d::Label::createWithSystemFont("Trace", "Arial", 26);
+    auto traceItem = cocos2d::MenuItemLabel::create(traceLabel, [this](cocos2d::Ref*) {
+        const std::string path = cocos2d::FileUtils::getInstance()->getWritablePath() + "tripeaks_trace.json";
+        std::string errorMessage;
+        showStatusMessage(TraceRecorder::writeChromeTrace(path, &errorMessage) ? "Trace saved: " + path : errorMessage);
+    });
+    traceItem->setPosition(origin.x + 160.0F, origin.y + 50.0F);
+    auto traceMenu = cocos2d::Menu::create(traceItem, nullptr);
+    traceMenu->setPosition({0.0F, 0.0F});
+    _uiLayer->addChild(traceMenu, 100);
+#endif
 
     return true;
 }
 
+void GameView::update(float delta)
+{
+    Node::update(delta);
+
+    if (_tweens.empty())
+    {
+        _autoTurbo = false;
+    }
+    _tweens.setTimeScale(_autoTurbo ? kTurboTimeScale : 1.0F);
+    {
+        TRIPEAKS_PROFILE_SCOPE(Tweens);
+        _tweens.update(delta);
+    }
+    TRIPEAKS_PROFILE_COUNTER(ActiveTweens, _tweens.getActiveCount());
+    applyQueuedChanges();
+
+    if (_onFrame)
+    {
+        _onFrame();
+    }
+}
+
+void GameView::onBoardEvents(const BoardEvent* events, std::size_t count)
+{
+    TRIPEAKS_TRACE_SCOPE_ARG("view", "onBoardEvents", "events", count);
+    clearHint();
+
+    bool stockChanged = false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const BoardEvent& event = events[index];
+        switch (event.type)
+        {
+        case BoardEvent::Type::CardRemoved:
+            replaceTrayCardWithPlayfieldCard(event.cardId, event.previousTrayCardId, event.animated);
+            break;
+        case BoardEvent::Type::CardRestored:
+            undoReplaceTrayCard(event.cardId, event.previousTrayCardId, event.animated);
+            break;
+        case BoardEvent::Type::CardFlipped:
+            flipCard(event.cardId, event.faceUp, event.animated);
+            break;
+        case BoardEvent::Type::TrayChanged:
+            switch (event.traySource)
+            {
+            case BoardEvent::TraySource::Draw:
+                replaceTrayCardWithStockCard(event.cardId, event.previousTrayCardId, event.animated);
+                break;
+            case BoardEvent::TraySource::UndoDraw:
+                undoReplaceTrayCardFromStock(event.cardId, event.previousTrayCardId, event.stockIndex,
+                                             event.animated);
+                break;
+            case BoardEvent::TraySource::Initial:
+                placeInitialTrayCard(event.cardId);
+                break;
+            }
+            break;
+        case BoardEvent::Type::StockChanged:
+            stockChanged = true;
+            break;
+        case BoardEvent::Type::WasteRecycled:
+            recycleWasteToStock();
+            break;
+        case BoardEvent::Type::WasteRestored:
+            restoreWasteFromStock();
+            break;
+        case BoardEvent::Type::StatusMessage:
+            showStatusMessage(event.message ? event.message : "");
+            break;
+        case BoardEvent::Type::GameStateChanged:
+            // 结算界面由 GameController 在最后一步的动画播完后显示，这里只负责回到进行中时收起
+            if (event.gameState == GameState::Playing)
+            {
+                hideVictory();
+            }
+            break;
+        }
+    }
+
+    // 备用牌堆与弃牌堆按模型的最终状态布局，放在批末只做一次
+    if (stockChanged)
+    {
+        layoutStock();
+    }
+    layoutWaste();
+}
+
 void GameView::bindModel(GameModel* model)
 {
     _model = model;
@@ -188,6 +335,45 @@ void GameView::setUndoCallback(const std::function<void()>& callback)
     _onUndoTapped = callback;
 }
 
+void GameView::setRestartCallback(const std::function<void()>& callback)
+{
+    _onRestartTapped = callback;
+}
+
+void GameView::setHintCallback(const std::function<void()>& callback)
+{
+    _onHintTapped = callback;
+}
+
+void GameView::setRaceCallback(const std::function<void()>& callback)
+{
+    _onRaceTapped = callback;
+}
+
+void GameView::setFrameCallback(const std::function<void()>& callback)
+{
+    _onFrame = callback;
+}
+
+void GameView::setAnimationFence(std::uint32_t fence)
+{
+    _tweens.setFence(fence);
+}
+
+bool GameView::isAnimationSettled(std::uint32_t fence) const
+{
+    return _queuedChanges.empty() && _tweens.getSettledFence() >= fence;
+}
+
+void GameView::coalesceAnimations(std::size_t inputBacklog)
+{
+    _tweens.finishAll();
+    if (inputBacklog >= kTurboInputBacklog)
+    {
+        _autoTurbo = true;
+    }
+}
+
 void GameView::buildInitialLayout()
 {
     if (!_model)
@@ -195,14 +381,22 @@ void GameView::buildInitialLayout()
         return;
     }
 
-    _cardVisuals.clear();
-    if (_stockTouchNode && _stockTouchNode->getParent())
+    TRIPEAKS_PROFILE_SCOPE(Layout);
+    TRIPEAKS_TRACE_SCOPE("view", "buildInitialLayout");
+
+    // 卡牌全部位于批量渲染节点中：重开或切换关卡时回收已有槽位与视图池，不分配新节点
+    _tweens.clear();
+    _cardBatch->clearCards();
+    _slotCardIds.clear();
+    _queuedChanges.clear();
+    _stockFirstVisible = 0;
+    _wasteTopCardId = -1;
+    _hintCardId = -1;
+    for (CardVisual& visual : _cardVisuals)
     {
-        _stockTouchNode->removeFromParentAndCleanup(false);
+        visual = CardVisual{};
     }
 
-    _cardLayer->removeAllChildrenWithCleanup(true);
-
     auto director = cocos2d::Director::getInstance();
     const cocos2d::Size visibleSize = director->getVisibleSize();
     const cocos2d::Vec2 origin = director->getVisibleOrigin();
@@ -220,8 +414,8 @@ void GameView::buildInitialLayout()
 
     if (_stockTouchNode)
     {
-        _cardLayer->addChild(_stockTouchNode, 900);
         _stockTouchNode->setPosition(_stockBasePosition);
+        _stockTouchNode->setScale(_cardScale);
     }
 
     const auto& playfieldIds = _model->getPlayfieldCardIds();
@@ -232,33 +426,52 @@ void GameView::buildInitialLayout()
         {
             continue;
         }
-        CardVisual visual = createCardVisual(*card);
-        visual.homePosition = card->position;
-        visual.root->setPosition(card->position);
+        CardVisual& visual = acquireCardVisual(cardId, *card);
+        visual.homePosition = toScenePosition(card->position);
         visual.inStock = false;
         visual.inTray = false;
-        attachCardListener(cardId, visual);
-        _cardLayer->addChild(visual.root, static_cast<int>(1000 - card->position.y));
-        _cardVisuals.emplace(cardId, visual);
+        _cardBatch->setCardPosition(visual.slot, visual.homePosition);
+        _cardBatch->setCardZOrder(visual.slot, static_cast<int>(1000 - card->position.y));
     }
 
-    const auto& stockIds = _model->getStockCardIds();
-    for (std::size_t index = 0; index < stockIds.size(); ++index)
+    // 牌堆四边形位于所有展开的备用牌之下，不对应任何卡牌
+    _stockPileSlot = _cardBatch->addCard(CardFaceType::Ace, CardSuit::Clubs, false);
+    _cardBatch->setCardScale(_stockPileSlot, _cardScale, _cardScale);
+    _cardBatch->setCardPosition(_stockPileSlot, _stockBasePosition);
+    _cardBatch->setCardZOrder(_stockPileSlot, kStockPileZOrder);
+    _cardBatch->setCardVisible(_stockPileSlot, false);
+    if (static_cast<int>(_slotCardIds.size()) <= _stockPileSlot)
+    {
+        _slotCardIds.resize(_stockPileSlot + 1, -1);
+    }
+
+    // 备用牌的位置与显隐由 layoutStock 统一决定
+    for (int cardId : _model->getStockCardIds())
     {
-        int cardId = stockIds[index];
         const Card* card = _model->getCardById(cardId);
         if (!card)
         {
             continue;
         }
-        CardVisual visual = createCardVisual(*card);
+        CardVisual& visual = acquireCardVisual(cardId, *card);
         visual.inStock = true;
         visual.inTray = false;
-        visual.homePosition = getStockCardPosition(static_cast<int>(index));
-        visual.root->setPosition(visual.homePosition);
-        visual.root->setLocalZOrder(static_cast<int>(500 + index));
-        _cardLayer->addChild(visual.root, visual.root->getLocalZOrder());
-        _cardVisuals.emplace(cardId, visual);
+    }
+
+    // 恢复存档时弃牌堆可能非空，全部放到手牌区之下并隐藏，顶部一张由 layoutWaste 显示
+    for (int cardId : _model->getWastePileIds())
+    {
+        const Card* card = _model->getCardById(cardId);
+        if (!card)
+        {
+            continue;
+        }
+        CardVisual& visual = acquireCardVisual(cardId, *card);
+        visual.inWaste = true;
+        visual.homePosition = getTrayCardPosition();
+        _cardBatch->setCardPosition(visual.slot, visual.homePosition);
+        _cardBatch->setCardZOrder(visual.slot, kWasteZOrder);
+        _cardBatch->setCardVisible(visual.slot, false);
     }
 
     // 显示手牌区顶部牌（如果tray card已经存在，更新其状态；否则创建新的visual）
@@ -272,8 +485,8 @@ void GameView::buildInitialLayout()
             existingVisual->inTray = true;
             existingVisual->inStock = false;
             existingVisual->homePosition = getTrayCardPosition();
-            existingVisual->root->setPosition(existingVisual->homePosition);
-            existingVisual->root->setLocalZOrder(800);
+            _cardBatch->setCardPosition(existingVisual->slot, existingVisual->homePosition);
+            _cardBatch->setCardZOrder(existingVisual->slot, 800);
         }
         else
         {
@@ -281,31 +494,21 @@ void GameView::buildInitialLayout()
             const Card* trayCard = _model->getCardById(trayCardId);
             if (trayCard)
             {
-                CardVisual visual = createCardVisual(*trayCard);
+                CardVisual& visual = acquireCardVisual(trayCardId, *trayCard);
                 visual.inTray = true;
                 visual.inStock = false;
                 visual.homePosition = getTrayCardPosition();
-                visual.root->setPosition(visual.homePosition);
-                visual.root->setLocalZOrder(800);
-                _cardLayer->addChild(visual.root, 800);
-                _cardVisuals.emplace(trayCardId, visual);
+                _cardBatch->setCardPosition(visual.slot, visual.homePosition);
+                _cardBatch->setCardZOrder(visual.slot, 800);
             }
         }
     }
 
-    // keep stock touch node above card sprites
-    if (_stockTouchNode)
-    {
-        _stockTouchNode->removeFromParent();
-        _cardLayer->addChild(_stockTouchNode, 900);
-        _stockTouchNode->setScale(_cardScale);
-    }
-
     layoutStock();
+    layoutWaste();
     refreshCardStates();
 }
 
-
 void GameView::moveCardBackToPlayfield(int cardId, bool animated)
 {
     CardVisual* visual = getVisual(cardId);
@@ -317,18 +520,7 @@ void GameView::moveCardBackToPlayfield(int cardId, bool animated)
     visual->inTray = false;
     visual->inStock = false;
     const cocos2d::Vec2 target = visual->homePosition;
-    visual->root->stopAllActions();
-    visual->root->setLocalZOrder(static_cast<int>(1000 - target.y));
-
-    if (animated)
-    {
-        auto move = cocos2d::MoveTo::create(0.2F, target);
-        visual->root->runAction(move);
-    }
-    else
-    {
-        visual->root->setPosition(target);
-    }
+    moveCardVisual(*visual, target, static_cast<int>(1000 - target.y), animated);
 }
 
 void GameView::moveCardToStock(int cardId, int stockIndex, bool animated)
@@ -341,20 +533,15 @@ void GameView::moveCardToStock(int cardId, int stockIndex, bool animated)
 
     visual->inTray = false;
     visual->inStock = true;
-    const cocos2d::Vec2 target = getStockCardPosition(stockIndex);
-    visual->homePosition = target;
-    visual->root->stopAllActions();
-    visual->root->setLocalZOrder(static_cast<int>(500 + stockIndex));
-
-    if (animated)
+    takeCardFromWaste(*visual);
+    if (visual->inStockPile)
     {
-        auto move = cocos2d::MoveTo::create(0.2F, target);
-        visual->root->runAction(move);
-    }
-    else
-    {
-        visual->root->setPosition(target);
+        visual->inStockPile = false;
+        _cardBatch->setCardVisible(visual->slot, true);
     }
+    const cocos2d::Vec2 target = getStockCardPosition(stockIndex);
+    visual->homePosition = target;
+    moveCardVisual(*visual, target, static_cast<int>(500 + stockIndex), animated);
 }
 
 void GameView::replaceTrayCardWithPlayfieldCard(int playfieldCardId, int oldTrayCardId, bool animated)
@@ -373,41 +560,15 @@ void GameView::replaceTrayCardWithPlayfieldCard(int playfieldCardId, int oldTray
     playfieldVisual->inTray = true;
     playfieldVisual->inStock = false;
     playfieldVisual->homePosition = trayPos;
-    playfieldVisual->root->stopAllActions();
-    playfieldVisual->root->setLocalZOrder(800);
 
-    // 如果有旧的tray牌，需要将其移回stock（如果oldTrayCardId有效）
+    // 旧的tray牌压入弃牌堆
     if (oldTrayCardId >= 0 && oldTrayVisual)
     {
-        oldTrayVisual->inTray = false;
-        oldTrayVisual->inStock = true;
-        const int stockIndex = static_cast<int>(_model->getStockCardIds().size());
-        const cocos2d::Vec2 stockPos = getStockCardPosition(stockIndex);
-        oldTrayVisual->homePosition = stockPos;
-        oldTrayVisual->root->stopAllActions();
-        oldTrayVisual->root->setLocalZOrder(static_cast<int>(500 + stockIndex));
-        
-        if (animated)
-        {
-            auto moveOld = cocos2d::MoveTo::create(0.2F, stockPos);
-            oldTrayVisual->root->runAction(moveOld);
-        }
-        else
-        {
-            oldTrayVisual->root->setPosition(stockPos);
-        }
+        moveCardToWaste(oldTrayCardId, animated);
     }
 
     // 移动桌面牌到手牌区
-    if (animated)
-    {
-        auto move = cocos2d::MoveTo::create(0.2F, trayPos);
-        playfieldVisual->root->runAction(move);
-    }
-    else
-    {
-        playfieldVisual->root->setPosition(trayPos);
-    }
+    moveCardVisual(*playfieldVisual, trayPos, 800, animated);
 }
 
 void GameView::replaceTrayCardWithStockCard(int stockCardId, int oldTrayCardId, bool animated)
@@ -426,41 +587,23 @@ void GameView::replaceTrayCardWithStockCard(int stockCardId, int oldTrayCardId,
     stockVisual->inTray = true;
     stockVisual->inStock = false;
     stockVisual->homePosition = trayPos;
-    stockVisual->root->stopAllActions();
-    stockVisual->root->setLocalZOrder(800);
 
-    // 如果有旧的tray牌，需要将其移回stock
+    // 旧的tray牌压入弃牌堆
     if (oldTrayCardId >= 0 && oldTrayVisual)
     {
-        oldTrayVisual->inTray = false;
-        oldTrayVisual->inStock = true;
-        const int stockIndex = static_cast<int>(_model->getStockCardIds().size());
-        const cocos2d::Vec2 stockPos = getStockCardPosition(stockIndex);
-        oldTrayVisual->homePosition = stockPos;
-        oldTrayVisual->root->stopAllActions();
-        oldTrayVisual->root->setLocalZOrder(static_cast<int>(500 + stockIndex));
-        
-        if (animated)
-        {
-            auto moveOld = cocos2d::MoveTo::create(0.2F, stockPos);
-            oldTrayVisual->root->runAction(moveOld);
-        }
-        else
-        {
-            oldTrayVisual->root->setPosition(stockPos);
-        }
+        moveCardToWaste(oldTrayCardId, animated);
     }
 
-    // 移动stock牌到手牌区
-    if (animated)
-    {
-        auto move = cocos2d::MoveTo::create(0.2F, trayPos);
-        stockVisual->root->runAction(move);
-    }
-    else
+    // 移动stock牌到手牌区，牌面与模型一致（翻回过的牌在备用牌堆中背面朝上）
+    takeCardFromWaste(*stockVisual);
+    if (stockVisual->inStockPile)
     {
-        stockVisual->root->setPosition(trayPos);
+        stockVisual->inStockPile = false;
+        _cardBatch->setCardVisible(stockVisual->slot, true);
     }
+    moveCardVisual(*stockVisual, trayPos, 800, animated);
+    const Card* card = _model->getCardById(stockCardId);
+    flipCard(stockCardId, card && card->faceUp, animated);
 }
 
 void GameView::undoReplaceTrayCard(int playfieldCardId, int oldTrayCardId, bool animated)
@@ -479,40 +622,20 @@ void GameView::undoReplaceTrayCard(int playfieldCardId, int oldTrayCardId, bool
     {
         playfieldVisual->inTray = false;
         playfieldVisual->inStock = false;
-        playfieldVisual->homePosition = card->position;
-        playfieldVisual->root->stopAllActions();
-        playfieldVisual->root->setLocalZOrder(static_cast<int>(1000 - card->position.y));
-
-        if (animated)
-        {
-            auto move = cocos2d::MoveTo::create(0.2F, card->position);
-            playfieldVisual->root->runAction(move);
-        }
-        else
-        {
-            playfieldVisual->root->setPosition(card->position);
-        }
+        playfieldVisual->homePosition = toScenePosition(card->position);
+        moveCardVisual(*playfieldVisual, playfieldVisual->homePosition,
+                       static_cast<int>(1000 - card->position.y), animated);
     }
 
-    // 恢复旧tray牌位置
+    // 弃牌堆顶部牌回到手牌区
     if (oldTrayCardId >= 0 && oldTrayVisual)
     {
+        takeCardFromWaste(*oldTrayVisual);
         oldTrayVisual->inTray = true;
         oldTrayVisual->inStock = false;
         const cocos2d::Vec2 trayPos = getTrayCardPosition();
         oldTrayVisual->homePosition = trayPos;
-        oldTrayVisual->root->stopAllActions();
-        oldTrayVisual->root->setLocalZOrder(800);
-        
-        if (animated)
-        {
-            auto moveOld = cocos2d::MoveTo::create(0.2F, trayPos);
-            oldTrayVisual->root->runAction(moveOld);
-        }
-        else
-        {
-            oldTrayVisual->root->setPosition(trayPos);
-        }
+        moveCardVisual(*oldTrayVisual, trayPos, 800, animated);
     }
 }
 
@@ -531,42 +654,23 @@ void GameView::undoReplaceTrayCardFromStock(int stockCardId, int oldTrayCardId,
     stockVisual->inStock = true;
     const cocos2d::Vec2 stockPos = getStockCardPosition(stockIndex);
     stockVisual->homePosition = stockPos;
-    stockVisual->root->stopAllActions();
-    stockVisual->root->setLocalZOrder(static_cast<int>(500 + stockIndex));
+    moveCardVisual(*stockVisual, stockPos, static_cast<int>(500 + stockIndex), animated);
+    const Card* card = _model->getCardById(stockCardId);
+    flipCard(stockCardId, card && card->faceUp, animated);
 
-    if (animated)
-    {
-        auto move = cocos2d::MoveTo::create(0.2F, stockPos);
-        stockVisual->root->runAction(move);
-    }
-    else
-    {
-        stockVisual->root->setPosition(stockPos);
-    }
-
-    // 恢复旧tray牌位置
+    // 弃牌堆顶部牌回到手牌区
     if (oldTrayCardId >= 0 && oldTrayVisual)
     {
+        takeCardFromWaste(*oldTrayVisual);
         oldTrayVisual->inTray = true;
         oldTrayVisual->inStock = false;
         const cocos2d::Vec2 trayPos = getTrayCardPosition();
         oldTrayVisual->homePosition = trayPos;
-        oldTrayVisual->root->stopAllActions();
-        oldTrayVisual->root->setLocalZOrder(800);
-        
-        if (animated)
-        {
-            auto moveOld = cocos2d::MoveTo::create(0.2F, trayPos);
-            oldTrayVisual->root->runAction(moveOld);
-        }
-        else
-        {
-            oldTrayVisual->root->setPosition(trayPos);
-        }
+        moveCardVisual(*oldTrayVisual, trayPos, 800, animated);
     }
 }
 
-void GameView::flipCard(int cardId, bool faceUp)
+void GameView::flipCard(int cardId, bool faceUp, bool animated)
 {
     CardVisual* visual = getVisual(cardId);
     if (!visual)
@@ -581,76 +685,320 @@ void GameView::flipCard(int cardId, bool faceUp)
 
     visual->faceUp = faceUp;
 
-    auto firstHalf = cocos2d::ScaleTo::create(0.1F, 0.0F, _cardScale);
-    auto show = cocos2d::CallFunc::create([visual, faceUp]() {
-        if (visual->front)
+    if (!animated)
+    {
+        _tweens.cancel(visual->slot);
+        _cardBatch->setCardScale(visual->slot, _cardScale, _cardScale);
+        _cardBatch->setCardFaceUp(visual->slot, faceUp);
+        return;
+    }
+
+    _tweens.flipTo(visual->slot, faceUp, kFlipDuration, _cardScale);
+}
+
+void GameView::refreshCardStates()
+{
+    if (!_model)
+    {
+        return;
+    }
+
+    TRIPEAKS_PROFILE_SCOPE(CardRefresh);
+
+    for (int cardId : _model->getPlayfieldCardIds())
+    {
+        refreshCardState(cardId);
+    }
+    refreshStockState();
+}
+
+void GameView::refreshCardState(int cardId)
+{
+    CardVisual* visual = getVisual(cardId);
+    const Card* card = _model->getCardById(cardId);
+    if (!visual || !card)
+    {
+        return;
+    }
+
+    // 离开桌面的牌（手牌区、备用牌堆）不可点击，也不再置灰
+    const bool onPlayfield = card->isInPlayfield && !card->removed;
+    const bool active = onPlayfield && card->faceUp && _model->isCardExposed(cardId);
+    _cardBatch->setCardTint(visual->slot, active || !onPlayfield ? cocos2d::Color3B::WHITE : cocos2d::Color3B(160, 160, 160));
+    visual->active = active;
+}
+
+void GameView::showCardHint(int cardId)
+{
+    clearHint();
+    const CardVisual* visual = getVisual(cardId);
+    if (!visual || !visual->active)
+    {
+        return;
+    }
+    _cardBatch->setCardTint(visual->slot, kHintTint);
+    _hintCardId = cardId;
+}
+
+void GameView::showStockHint()
+{
+    clearHint();
+    if (!_model)
+    {
+        return;
+    }
+    if (_model->getStockCardIds().empty())
+    {
+        if (_model->canRecycleWaste())
         {
-            visual->front->setVisible(faceUp);
+            showStatusMessage("Tap the stock to turn the waste pile over");
         }
-        if (visual->back)
+        return;
+    }
+    _stockTouchNode->setColor(kHintTint);
+    _stockTouchNode->setOpacity(kStockHintOpacity);
+    _stockHinted = true;
+}
+
+void GameView::clearHint()
+{
+    if (_stockHinted)
+    {
+        _stockHinted = false;
+        _stockTouchNode->setOpacity(0);
+    }
+    if (_hintCardId < 0)
+    {
+        return;
+    }
+    const int cardId = _hintCardId;
+    _hintCardId = -1;
+    refreshCardState(cardId);
+}
+
+void GameView::refreshStockState()
+{
+    // 备用牌堆用尽且不能再翻回时牌堆位置已空，改为把数量标签置灰
+    const bool exhausted = _model->getStockCardIds().empty() && !_model->canRecycleWaste();
+    if (exhausted == _stockExhausted)
+    {
+        return;
+    }
+    _stockExhausted = exhausted;
+    _stockCountLabel->setColor(exhausted ? cocos2d::Color3B(120, 120, 120) : cocos2d::Color3B::WHITE);
+}
+
+void GameView::queueChanges(const BoardChangeSet& changes)
+{
+    for (int cardId : changes.cardIds)
+    {
+        CardVisual* visual = getVisual(cardId);
+        if (visual && !visual->refreshQueued)
         {
-            visual->back->setVisible(!faceUp);
+            visual->refreshQueued = true;
+            _queuedChanges.cardIds.emplace_back(cardId);
         }
-    });
-    auto secondHalf = cocos2d::ScaleTo::create(0.1F, _cardScale, _cardScale);
-    auto sequence = cocos2d::Sequence::create(firstHalf, show, secondHalf, nullptr);
-    visual->root->runAction(sequence);
+    }
+    _queuedChanges.trayChanged = _queuedChanges.trayChanged || changes.trayChanged;
+    _queuedChanges.stockChanged = _queuedChanges.stockChanged || changes.stockChanged;
 }
 
-void GameView::refreshCardStates()
+void GameView::applyQueuedChanges()
+{
+    if (!_model || _queuedChanges.empty())
+    {
+        return;
+    }
+
+    TRIPEAKS_PROFILE_SCOPE(CardRefresh);
+    TRIPEAKS_TRACE_SCOPE_ARG("view", "applyQueuedChanges", "cards", _queuedChanges.cardIds.size());
+
+    for (int cardId : _queuedChanges.cardIds)
+    {
+        if (CardVisual* visual = getVisual(cardId))
+        {
+            visual->refreshQueued = false;
+            refreshCardState(cardId);
+        }
+    }
+    if (_queuedChanges.stockChanged)
+    {
+        layoutStock();
+        refreshStockState();
+    }
+    _queuedChanges.clear();
+}
+
+void GameView::layoutStock(int skipCardId)
 {
     if (!_model)
     {
         return;
     }
 
-    const auto& playfieldIds = _model->getPlayfieldCardIds();
-    for (int cardId : playfieldIds)
+    TRIPEAKS_PROFILE_SCOPE(Layout);
+
+    // 牌堆只在顶部增减，只需处理展开区间以及本次被压入牌堆的牌；
+    // 目标位置未变化的牌（包括正在飞向该位置的牌）保持不动
+    const auto& stockIds = _model->getStockCardIds();
+    const int stockCount = static_cast<int>(stockIds.size());
+    const int firstVisible = std::max(0, stockCount - kVisibleStockCards);
+    const int firstDirty = std::min(_stockFirstVisible, firstVisible);
+
+    for (int index = firstDirty; index < stockCount; ++index)
     {
+        const int cardId = stockIds[index];
         CardVisual* visual = getVisual(cardId);
-        const Card* card = _model->getCardById(cardId);
-        if (!visual || !card)
+        if (!visual || cardId == skipCardId)
         {
             continue;
         }
 
-        const bool active = !card->removed && card->faceUp && _model->isCardExposed(cardId);
-        if (visual->front)
+        if (index < firstVisible)
         {
-            visual->front->setColor(active ? cocos2d::Color3B::WHITE : cocos2d::Color3B(160, 160, 160));
+            foldIntoStockPile(*visual);
         }
-        if (visual->listener)
+        else if (!visual->inStock || visual->inStockPile || visual->homePosition != getStockCardPosition(index))
         {
-            visual->listener->setEnabled(active);
+            moveCardToStock(cardId, index, false);
         }
     }
+    _stockFirstVisible = firstVisible;
 
-    const bool stockAvailable = _model->getStockCardIds().empty()
-        ? false
-        : true;
-    _stockTouchNode->setColor(stockAvailable ? cocos2d::Color3B::WHITE : cocos2d::Color3B(120, 120, 120));
+    if (_stockPileSlot >= 0)
+    {
+        _cardBatch->setCardVisible(_stockPileSlot, firstVisible > 0);
+    }
+    updateStockCountLabel(stockCount);
 }
 
-void GameView::layoutStock(int skipCardId)
+void GameView::foldIntoStockPile(CardVisual& visual)
+{
+    visual.inTray = false;
+    visual.inStock = true;
+    visual.inWaste = false;
+    if (visual.inStockPile)
+    {
+        return;
+    }
+
+    stopCardAnimations(visual);
+    visual.inStockPile = true;
+    visual.homePosition = _stockBasePosition;
+    _cardBatch->setCardPosition(visual.slot, _stockBasePosition);
+    _cardBatch->setCardVisible(visual.slot, false);
+}
+
+void GameView::layoutWaste()
 {
     if (!_model)
     {
         return;
     }
 
-    const auto& stockIds = _model->getStockCardIds();
-    for (std::size_t index = 0; index < stockIds.size(); ++index)
+    // 压入弃牌堆时已隐藏原顶部牌，这里只需在出堆后显示新的顶部牌
+    const auto& wasteIds = _model->getWastePileIds();
+    const int topCardId = wasteIds.empty() ? -1 : wasteIds.back();
+    if (topCardId == _wasteTopCardId)
+    {
+        return;
+    }
+
+    CardVisual* previousTop = getVisual(_wasteTopCardId);
+    if (previousTop && previousTop->inWaste)
+    {
+        _cardBatch->setCardVisible(previousTop->slot, false);
+    }
+    CardVisual* top = getVisual(topCardId);
+    if (top && top->inWaste)
+    {
+        _cardBatch->setCardVisible(top->slot, true);
+    }
+    _wasteTopCardId = topCardId;
+}
+
+void GameView::moveCardToWaste(int cardId, bool animated)
+{
+    CardVisual* visual = getVisual(cardId);
+    if (!visual)
+    {
+        return;
+    }
+
+    // 弃牌堆中始终只有记录的顶部牌可见，原顶部牌被新压入的牌完全盖住
+    CardVisual* previousTop = getVisual(_wasteTopCardId);
+    if (previousTop && previousTop->inWaste)
+    {
+        _cardBatch->setCardVisible(previousTop->slot, false);
+    }
+    _wasteTopCardId = cardId;
+
+    visual->inTray = false;
+    visual->inStock = false;
+    visual->inWaste = true;
+    visual->homePosition = getTrayCardPosition();
+    moveCardVisual(*visual, visual->homePosition, kWasteZOrder, animated);
+}
+
+void GameView::takeCardFromWaste(CardVisual& visual)
+{
+    if (!visual.inWaste)
     {
-        if (stockIds[index] == skipCardId)
+        return;
+    }
+    visual.inWaste = false;
+    _cardBatch->setCardVisible(visual.slot, true);
+}
+
+void GameView::recycleWasteToStock()
+{
+    // 翻回的牌都还在手牌区之下；标记为离开弃牌堆后由批末的 layoutStock 放到各自位置
+    for (int cardId : _model->getStockCardIds())
+    {
+        CardVisual* visual = getVisual(cardId);
+        if (!visual)
         {
             continue;
         }
-        moveCardToStock(stockIds[index], static_cast<int>(index), false);
+        takeCardFromWaste(*visual);
+        visual->inStock = false;
+        flipCard(cardId, false, false);
     }
+    // 备用牌堆在翻回前为空，从第一张开始重新布局
+    _stockFirstVisible = 0;
+}
 
-    std::ostringstream oss;
-    oss << "Stock: " << stockIds.size();
-    _stockCountLabel->setString(oss.str());
+void GameView::restoreWasteFromStock()
+{
+    for (int cardId : _model->getWastePileIds())
+    {
+        CardVisual* visual = getVisual(cardId);
+        if (!visual)
+        {
+            continue;
+        }
+        stopCardAnimations(*visual);
+        visual->inStock = false;
+        visual->inStockPile = false;
+        visual->inWaste = true;
+        visual->homePosition = getTrayCardPosition();
+        _cardBatch->setCardPosition(visual->slot, visual->homePosition);
+        _cardBatch->setCardZOrder(visual->slot, kWasteZOrder);
+        _cardBatch->setCardVisible(visual->slot, false);
+        flipCard(cardId, true, false);
+    }
+    // 顶部牌由批末的 layoutWaste 重新显示
+    _wasteTopCardId = -1;
+}
+
+void GameView::updateStockCountLabel(int stockCount)
+{
+    if (stockCount == _stockLabelCount)
+    {
+        return;
+    }
+    _stockLabelCount = stockCount;
+    _stockCountLabel->setString("Stock: " + std::to_string(stockCount));
 }
 
 void GameView::placeInitialTrayCard(int cardId)
@@ -665,8 +1013,8 @@ void GameView::placeInitialTrayCard(int cardId)
     visual->inStock = false;
     const cocos2d::Vec2 target = getTrayCardPosition();
     visual->homePosition = target;
-    visual->root->setPosition(target);
-    visual->root->setLocalZOrder(800);
+    _cardBatch->setCardPosition(visual->slot, target);
+    _cardBatch->setCardZOrder(visual->slot, 800);
     flipCard(cardId, true);
 }
 
@@ -691,10 +1039,37 @@ void GameView::clearStatusMessage()
     }
 }
 
+RaceMiniBoardView* GameView::showRaceBoard()
+{
+    if (!_raceBoard)
+    {
+        auto director = cocos2d::Director::getInstance();
+        const cocos2d::Size visibleSize = director->getVisibleSize();
+        const cocos2d::Vec2 origin = director->getVisibleOrigin();
+        _raceBoard = RaceMiniBoardView::create();
+        // 放在 Restart / Race 按钮下方
+        _raceBoard->setPosition(origin.x + 20.0F,
+                                origin.y + visibleSize.height - 180.0F - _raceBoard->getContentSize().height);
+        _uiLayer->addChild(_raceBoard);
+    }
+    _raceBoard->setVisible(true);
+    return _raceBoard;
+}
+
+void GameView::hideRaceBoard()
+{
+    if (_raceBoard)
+    {
+        _raceBoard->setVisible(false);
+    }
+}
+
 void GameView::showVictory()
 {
     if (_victoryLabel)
     {
+        _victoryLabel->stopAllActions();
+        _victoryLabel->setString("Victory!");
         _victoryLabel->setVisible(true);
         _victoryLabel->runAction(cocos2d::RepeatForever::create(
             cocos2d::Sequence::create(
@@ -704,6 +1079,18 @@ void GameView::showVictory()
     }
 }
 
+void GameView::showGameOver(const std::string& reason)
+{
+    if (_victoryLabel)
+    {
+        _victoryLabel->stopAllActions();
+        _victoryLabel->setScale(1.0F);
+        _victoryLabel->setString("Game Over");
+        _victoryLabel->setVisible(true);
+    }
+    showStatusMessage(reason);
+}
+
 void GameView::hideVictory()
 {
     if (_victoryLabel)
@@ -726,220 +1113,99 @@ cocos2d::Vec2 GameView::getStockBasePosition() const
 
 GameView::CardVisual* GameView::getVisual(int cardId)
 {
-    auto iter = _cardVisuals.find(cardId);
-    if (iter == _cardVisuals.end())
+    if (cardId < 0 || cardId >= static_cast<int>(_cardVisuals.size()) || _cardVisuals[cardId].slot < 0)
     {
         return nullptr;
     }
-    return &iter->second;
+    return &_cardVisuals[cardId];
 }
 
 const GameView::CardVisual* GameView::getVisual(int cardId) const
 {
-    auto iter = _cardVisuals.find(cardId);
-    if (iter == _cardVisuals.end())
+    if (cardId < 0 || cardId >= static_cast<int>(_cardVisuals.size()) || _cardVisuals[cardId].slot < 0)
     {
         return nullptr;
     }
-    return &iter->second;
+    return &_cardVisuals[cardId];
 }
 
-GameView::CardVisual GameView::createCardVisual(const Card& card)
+GameView::CardVisual& GameView::acquireCardVisual(int cardId, const Card& card)
 {
-    CardVisual visual;
-    visual.root = cocos2d::Node::create();
-    visual.root->setScale(_cardScale);
-
-    visual.back = cocos2d::Sprite::create("res/card_general.png");
-    if (!visual.back)
+    // 视图池只在牌数超过历史最大值时增长，其余情况直接复用并重设牌面
+    if (cardId >= static_cast<int>(_cardVisuals.size()))
     {
-        visual.back = cocos2d::Sprite::create();
-        visual.back->setTextureRect({0.0F, 0.0F, 128.0F, 170.0F});
+        _cardVisuals.resize(cardId + 1);
     }
-    visual.back->setColor({26, 82, 173});
-    visual.back->setAnchorPoint({0.5F, 0.5F});
-    visual.root->addChild(visual.back, 0);
 
-    visual.front = cocos2d::Sprite::create("res/card_general.png");
-    if (!visual.front)
+    CardVisual& visual = _cardVisuals[cardId];
+    visual = CardVisual{};
+    visual.slot = _cardBatch->addCard(card.face, card.suit, card.faceUp);
+    visual.faceUp = card.faceUp;
+    _cardBatch->setCardScale(visual.slot, _cardScale, _cardScale);
+
+    if (static_cast<int>(_slotCardIds.size()) <= visual.slot)
     {
-        visual.front = cocos2d::Sprite::create();
-        visual.front->setTextureRect({0.0F, 0.0F, 128.0F, 170.0F});
-        visual.front->setColor({235, 235, 235});
+        _slotCardIds.resize(visual.slot + 1, -1);
     }
-    visual.front->setAnchorPoint({0.5F, 0.5F});
-    visual.root->addChild(visual.front, 1);
-
-    const cocos2d::Size cardSize = visual.front->getContentSize();
-    const float halfWidth = cardSize.width * 0.5F;
-    const float halfHeight = cardSize.height * 0.5F;
+    _slotCardIds[visual.slot] = cardId;
 
-    const bool red = isRedSuit(card.suit);
-    const std::string numberPath = getNumberSpritePath(card.face, red);
-    const std::string suitPath = getSuitSpritePath(card.suit);
-
-    const float paddingX = cardSize.width * 0.08F;
-    const float paddingY = cardSize.height * 0.08F;
-    const float cornerSpacing = cardSize.height * 0.02F;
-    const float cornerShiftX = cardSize.width * 0.5F;
-    const float cornerShiftY = cardSize.height * 0.5F;
-    const float rankTargetHeight = cardSize.height * 0.22F;
-    const float cornerSuitTargetHeight = cardSize.height * 0.14F;
-    const float centerSuitTargetHeight = cardSize.height * 0.32F;
-    const float centerShiftX = cardSize.width * 0.5F;
-    const float centerShiftY = cardSize.height * 0.5F;
-
-    auto getNodeSize = [](cocos2d::Node* node) {
-        cocos2d::Size size = node->getContentSize();
-        size.width *= node->getScaleX();
-        size.height *= node->getScaleY();
-        return size;
-    };
-
-    auto createRankNode = [&]() -> cocos2d::Node* {
-        if (auto sprite = cocos2d::Sprite::create(numberPath))
-        {
-            const float contentHeight = sprite->getContentSize().height;
-            if (contentHeight > 0.0F)
-            {
-                sprite->setScale(rankTargetHeight / contentHeight);
-            }
-            return sprite;
-        }
+    return visual;
+}
 
-        auto label = cocos2d::Label::createWithSystemFont(faceToString(card.face), "Arial", rankTargetHeight);
-        label->setColor(red ? cocos2d::Color3B::RED : cocos2d::Color3B::BLACK);
-        return label;
-    };
+void GameView::moveCardVisual(CardVisual& visual, const cocos2d::Vec2& target, int zOrder, bool animated)
+{
+    _cardBatch->setCardZOrder(visual.slot, zOrder);
 
-    auto createCornerSuitNode = [&]() -> cocos2d::Sprite* {
-        cocos2d::Sprite* sprite = cocos2d::Sprite::create(suitPath);
-        if (!sprite)
-        {
-            sprite = cocos2d::Sprite::create();
-            sprite->setTextureRect({0.0F, 0.0F, 50.0F, 50.0F});
-            sprite->setColor(red ? cocos2d::Color3B::RED : cocos2d::Color3B::BLACK);
-        }
-        const float contentHeight = sprite->getContentSize().height;
-        if (contentHeight > 0.0F)
-        {
-            sprite->setScale(cornerSuitTargetHeight / contentHeight);
-        }
-        return sprite;
-    };
+    if (!animated)
+    {
+        stopCardAnimations(visual);
+        _cardBatch->setCardPosition(visual.slot, target);
+        return;
+    }
 
-    auto topCornerContainer = cocos2d::Node::create();
-    topCornerContainer->ignoreAnchorPointForPosition(false);
-    topCornerContainer->setAnchorPoint({0.0F, 1.0F});
-    topCornerContainer->setPosition({-halfWidth + paddingX + cornerShiftX, halfHeight - paddingY + cornerShiftY});
-    visual.front->addChild(topCornerContainer, 2);
-
-    cocos2d::Node* topRankNode = createRankNode();
-    topRankNode->setAnchorPoint({0.0F, 1.0F});
-    topRankNode->setPosition({0.0F, 0.0F});
-    topCornerContainer->addChild(topRankNode);
-    visual.numberNode = topRankNode;
-
-    const cocos2d::Size rankSize = getNodeSize(topRankNode);
-
-    cocos2d::Sprite* topSuitNode = createCornerSuitNode();
-    topSuitNode->setAnchorPoint({0.0F, 1.0F});
-    topSuitNode->setPosition({0.0F, -rankSize.height - cornerSpacing});
-    topCornerContainer->addChild(topSuitNode);
-    visual.cornerSuitNode = topSuitNode;
-
-    auto bottomCornerContainer = cocos2d::Node::create();
-    bottomCornerContainer->ignoreAnchorPointForPosition(false);
-    bottomCornerContainer->setAnchorPoint({1.0F, 0.0F});
-    bottomCornerContainer->setPosition({halfWidth - paddingX + cornerShiftX, -halfHeight + paddingY + cornerShiftY});
-    bottomCornerContainer->setRotation(180.0F);
-    visual.front->addChild(bottomCornerContainer, 2);
-
-    cocos2d::Node* bottomRankNode = createRankNode();
-    bottomRankNode->setAnchorPoint({0.0F, 1.0F});
-    bottomRankNode->setPosition({0.0F, 0.0F});
-    bottomCornerContainer->addChild(bottomRankNode);
-    visual.mirroredNumberNode = bottomRankNode;
-
-    const cocos2d::Size mirroredRankSize = getNodeSize(bottomRankNode);
-
-    cocos2d::Sprite* bottomSuitNode = createCornerSuitNode();
-    bottomSuitNode->setAnchorPoint({0.0F, 1.0F});
-    bottomSuitNode->setPosition({0.0F, -mirroredRankSize.height - cornerSpacing});
-    bottomCornerContainer->addChild(bottomSuitNode);
-    visual.mirroredCornerSuitNode = bottomSuitNode;
-
-    cocos2d::Sprite* centerSuit = cocos2d::Sprite::create(suitPath);
-    if (!centerSuit)
-    {
-        centerSuit = cocos2d::Sprite::create();
-        centerSuit->setTextureRect({0.0F, 0.0F, 50.0F, 50.0F});
-        centerSuit->setColor(red ? cocos2d::Color3B::RED : cocos2d::Color3B::BLACK);
-    }
-    const float centerContentHeight = centerSuit->getContentSize().height;
-    if (centerContentHeight > 0.0F)
-    {
-        centerSuit->setScale(centerSuitTargetHeight / centerContentHeight);
-    }
-    centerSuit->setAnchorPoint({0.5F, 0.5F});
-    centerSuit->setPosition({centerShiftX, centerShiftY});
-    visual.front->addChild(centerSuit, 1);
-    visual.suitNode = centerSuit;
-
-    visual.front->setVisible(card.faceUp);
-    visual.back->setVisible(!card.faceUp);
-    visual.faceUp = card.faceUp;
+    // 进行中的移动会从当前位置改飞新目标，翻面动画不受影响
+    _tweens.moveTo(visual.slot, target, kMoveDuration);
+}
 
-    return visual;
+void GameView::stopCardAnimations(CardVisual& visual)
+{
+    // 被打断的翻转动画直接落到最终状态，避免卡牌停在半翻转的缩放上
+    _tweens.cancel(visual.slot);
 }
 
-void GameView::attachCardListener(int cardId, CardVisual& visual)
+void GameView::attachBoardListener()
 {
+    // 整个牌桌只有一个触摸监听，命中最上层的可操作卡牌
     auto listener = cocos2d::EventListenerTouchOneByOne::create();
     listener->setSwallowTouches(true);
-    listener->onTouchBegan = [this, cardId](cocos2d::Touch* touch, cocos2d::Event* event) {
+    listener->onTouchBegan = [this](cocos2d::Touch* touch, cocos2d::Event* event) {
         if (!_model || !_onCardTapped)
         {
             return false;
         }
 
-        GameView::CardVisual* visualPtr = getVisual(cardId);
-        if (!visualPtr || !visualPtr->root)
-        {
-            return false;
-        }
-
-        const cocos2d::Vec2 locationInRoot = visualPtr->root->convertToNodeSpace(touch->getLocation());
-        cocos2d::Rect touchBounds;
-        if (visualPtr->front)
-        {
-            touchBounds = visualPtr->front->getBoundingBox();
-        }
-        else if (visualPtr->back)
-        {
-            touchBounds = visualPtr->back->getBoundingBox();
-        }
-        else
-        {
-            touchBounds = cocos2d::Rect(-64.0F, -85.0F, 128.0F, 170.0F);
-        }
+        // 同一帧内先于 update 到达的触摸也要看到最新的可操作状态
+        applyQueuedChanges();
 
-        if (!touchBounds.containsPoint(locationInRoot))
+        const cocos2d::Vec2 location = _cardBatch->convertToNodeSpace(touch->getLocation());
+        const int slot = _cardBatch->findTopmostCardAt(location, [this](int candidate) {
+            const CardVisual* visual = getVisual(_slotCardIds[candidate]);
+            return visual && visual->active;
+        });
+        if (slot < 0)
         {
             return false;
         }
 
-        _onCardTapped(cardId);
+        _onCardTapped(_slotCardIds[slot]);
         return true;
     };
-    visual.listener = listener;
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, visual.root);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, _cardBatch);
 }
 
 void GameView::updateCardVisibility(CardVisual& visual)
 {
-    visual.front->setVisible(visual.faceUp);
-    visual.back->setVisible(!visual.faceUp);
+    _cardBatch->setCardFaceUp(visual.slot, visual.faceUp);
 }
 
 void GameView::updateCardScale()
@@ -957,11 +1223,11 @@ void GameView::updateCardScale()
         _cardLayer->setScale(_boardScale);
     }
 
-    for (auto& pair : _cardVisuals)
+    for (const CardVisual& visual : _cardVisuals)
     {
-        if (pair.second.root)
+        if (visual.slot >= 0)
         {
-            pair.second.root->setScale(_cardScale);
+            _cardBatch->setCardScale(visual.slot, _cardScale, _cardScale);
         }
     }
 
@@ -971,32 +1237,13 @@ void GameView::updateCardScale()
     }
 }
 
-std::string GameView::getNumberSpritePath(CardFaceType face, bool isRed) const
-{
-    const std::string prefix = isRed ? "res/number/small_red_" : "res/number/small_black_";
-    return prefix + faceToString(face) + ".png";
-}
-
-std::string GameView::getSuitSpritePath(CardSuit suit) const
-{
-    switch (suit)
-    {
-    case CardSuit::Clubs:
-        return "res/suits/club.png";
-    case CardSuit::Diamonds:
-        return "res/suits/diamond.png";
-    case CardSuit::Hearts:
-        return "res/suits/heart.png";
-    case CardSuit::Spades:
-        return "res/suits/spade.png";
-    default:
-        return "";
-    }
-}
-
 cocos2d::Vec2 GameView::getStockCardPosition(int index) const
 {
-    return _stockBasePosition + cocos2d::Vec2(index * _stockOffset * 0.4F, index * 0.5F);
+    // 展开的牌从牌堆四边形右侧依次排开
+    const int stockCount = _model ? static_cast<int>(_model->getStockCardIds().size()) : 0;
+    const int firstVisible = std::max(0, stockCount - kVisibleStockCards);
+    const int displayIndex = std::max(0, index - firstVisible) + (firstVisible > 0 ? 1 : 0);
+    return _stockBasePosition + cocos2d::Vec2(displayIndex * _stockOffset * 0.4F, displayIndex * 0.5F);
 }
 
 cocos2d::Vec2 GameView::getTrayCardPosition() const
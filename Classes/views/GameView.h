@@ -2,100 +2,166 @@
 
 #include "cocos2d.h"
 
+#include "managers/BoardEventBus.h"
 #include "models/GameModel.h"
+#include "views/CardBatchNode.h"
+#include "views/CardFaceCache.h"
+#include "views/CardTweenSystem.h"
+#include "views/RaceMiniBoardView.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace tripeaks
 {
 
-class GameView : public cocos2d::Node
+class GameView : public cocos2d::Node, public BoardEventListener
 {
 public:
     CREATE_FUNC(GameView);
 
     bool init() override;
+    void update(float delta) override;
+
+    // 按发布顺序播放一批牌桌事件，批内多次的备用牌堆变化只重新布局一次
+    void onBoardEvents(const BoardEvent* events, std::size_t count) override;
 
     void bindModel(GameModel* model);
 
     void setCardTapCallback(const std::function<void(int)>& callback);
     void setStockTapCallback(const std::function<void()>& callback);
     void setUndoCallback(const std::function<void()>& callback);
+    void setRestartCallback(const std::function<void()>& callback);
+    void setHintCallback(const std::function<void()>& callback);
+    void setRaceCallback(const std::function<void()>& callback);
+    // 每帧推进动画之后调用，GameController 在这里检查等待动画或后台结果的后续步骤
+    void setFrameCallback(const std::function<void()>& callback);
 
     void buildInitialLayout();
 
     void moveCardBackToPlayfield(int cardId, bool animated = true);
     void moveCardToStock(int cardId, int stockIndex, bool animated = true);
 
-    // 手牌区相关动画
+    // 手牌区相关动画；旧手牌压入弃牌堆，留在手牌区位置的下层
     void replaceTrayCardWithPlayfieldCard(int playfieldCardId, int oldTrayCardId, bool animated = true);
     void replaceTrayCardWithStockCard(int stockCardId, int oldTrayCardId, bool animated = true);
     void undoReplaceTrayCard(int playfieldCardId, int oldTrayCardId, bool animated = true);
     void undoReplaceTrayCardFromStock(int stockCardId, int oldTrayCardId, int stockIndex, bool animated = true);
     void placeInitialTrayCard(int cardId);
 
-    void flipCard(int cardId, bool faceUp);
+    // 弃牌堆整体翻回备用牌堆及其回退，之后由 layoutStock 布局备用牌堆
+    void recycleWasteToStock();
+    void restoreWasteFromStock();
 
-    void refreshCardStates();
+    void flipCard(int cardId, bool faceUp, bool animated = true);
+
+    // 之后发起的动画记为第 fence 批；该批及之前的动画都播完（或被后来的操作接管）且没有待应用的变化时 settled
+    void setAnimationFence(std::uint32_t fence);
+    bool isAnimationSettled(std::uint32_t fence) const;
+
+    /**
+     * 新一批输入在上一批动画播完前到来时调用：进行中的动画直接落到终点，只播放新一批的动画。
+     * inputBacklog 为连续积压的输入数，达到阈值后加速播放，直到动画全部播完
+     */
+    void coalesceAnimations(std::size_t inputBacklog);
+
+    // 记录模型产生的增量变化，每帧最多应用一次
+    void queueChanges(const BoardChangeSet& changes);
     void layoutStock(int skipCardId = -1);
+    // 弃牌堆只显示顶部一张（翻回或回退后手牌区之下露出的牌），其余隐藏
+    void layoutWaste();
 
     void showStatusMessage(const std::string& text);
     void clearStatusMessage();
 
     void showVictory();
+    // 本局失败（无路可走或已无法取胜），reason 显示在状态栏
+    void showGameOver(const std::string& reason);
     void hideVictory();
 
+    // 竞速模式下对手的缩略牌桌，首次调用时创建在界面层左上角，之后返回同一个
+    RaceMiniBoardView* showRaceBoard();
+    void hideRaceBoard();
+
+    // 高亮提示的桌面牌或备用牌堆，下一批牌桌事件到来时自动清除
+    void showCardHint(int cardId);
+    void showStockHint();
+    void clearHint();
+
     cocos2d::Vec2 getTrayBasePosition() const;
     cocos2d::Vec2 getStockBasePosition() const;
 
 private:
     struct CardVisual
     {
-        cocos2d::Node* root = nullptr;
-        cocos2d::Sprite* front = nullptr;
-        cocos2d::Sprite* back = nullptr;
-        cocos2d::Node* numberNode = nullptr;
-        cocos2d::Node* mirroredNumberNode = nullptr;
-        cocos2d::Sprite* suitNode = nullptr;
-        cocos2d::Sprite* cornerSuitNode = nullptr;
-        cocos2d::Sprite* mirroredCornerSuitNode = nullptr;
-        cocos2d::EventListenerTouchOneByOne* listener = nullptr;
+        int slot = -1;                  // 在 CardBatchNode 中的槽位
         cocos2d::Vec2 homePosition;
         bool faceUp = false;
+        bool active = false;            // 是否可点击（已翻开且未被覆盖的桌面牌）
         bool inStock = false;
         bool inTray = false;
+        bool inStockPile = false;       // 位于备用牌堆深处，折叠进牌堆四边形而不单独显示
+        bool inWaste = false;           // 位于弃牌堆，除顶部一张外隐藏
+        bool refreshQueued = false;     // 是否已在 _queuedChanges 中
     };
 
     CardVisual* getVisual(int cardId);
     const CardVisual* getVisual(int cardId) const;
 
-    CardVisual createCardVisual(const Card& card);
-    void attachCardListener(int cardId, CardVisual& visual);
+    CardVisual& acquireCardVisual(int cardId, const Card& card);
+    void moveCardVisual(CardVisual& visual, const cocos2d::Vec2& target, int zOrder, bool animated);
+    void foldIntoStockPile(CardVisual& visual);
+    void moveCardToWaste(int cardId, bool animated);
+    void takeCardFromWaste(CardVisual& visual);
+    void updateStockCountLabel(int stockCount);
+    void stopCardAnimations(CardVisual& visual);
+    void attachBoardListener();
     void updateCardVisibility(CardVisual& visual);
-    void updateCardScale();
 
-    std::string getNumberSpritePath(CardFaceType face, bool isRed) const;
-    std::string getSuitSpritePath(CardSuit suit) const;
+    // 全量刷新所有桌面牌的可操作状态，只在重建布局时使用
+    void refreshCardStates();
+    void refreshCardState(int cardId);
+    void refreshStockState();
+    void applyQueuedChanges();
+    void updateCardScale();
 
     cocos2d::Vec2 getStockCardPosition(int index) const;
     cocos2d::Vec2 getTrayCardPosition() const;
 
     GameModel* _model = nullptr;
-    std::unordered_map<int, CardVisual> _cardVisuals;
+    std::vector<CardVisual> _cardVisuals;   // 按cardId索引的卡牌视图池，跨局、跨关卡复用
+    std::vector<int> _slotCardIds;      // 槽位 -> cardId
+    BoardChangeSet _queuedChanges;      // 尚未应用到画面的增量变化
+    CardFaceCache _faceCache;
+    CardBatchNode* _cardBatch = nullptr;
+    CardTweenSystem _tweens;
+    bool _autoTurbo = false;            // 因输入积压自动进入的加速状态，动画全部结束后退出
 
     cocos2d::Node* _cardLayer = nullptr;
     cocos2d::Node* _uiLayer = nullptr;
     cocos2d::Label* _stockCountLabel = nullptr;
     cocos2d::Label* _statusLabel = nullptr;
     cocos2d::Label* _victoryLabel = nullptr;
+    RaceMiniBoardView* _raceBoard = nullptr;
 
     cocos2d::Node* _stockTouchNode = nullptr;
+    int _stockPileSlot = -1;            // 代表牌堆深处所有卡牌的单个牌背四边形
+    int _stockFirstVisible = 0;         // 上次布局时第一张展开显示的备用牌索引
+    int _stockLabelCount = -1;          // 备用牌数量标签当前显示的数值
+    int _wasteTopCardId = -1;           // 弃牌堆中当前显示的顶部牌
+    int _hintCardId = -1;               // 当前高亮提示的卡牌
+    bool _stockHinted = false;          // 备用牌堆的触摸区域正显示提示色
+    bool _stockExhausted = false;       // 数量标签当前是否已置灰
 
     std::function<void(int)> _onCardTapped;
     std::function<void()> _onStockTapped;
     std::function<void()> _onUndoTapped;
+    std::function<void()> _onRestartTapped;
+    std::function<void()> _onHintTapped;
+    std::function<void()> _onRaceTapped;
+    std::function<void()> _onFrame;
 
     float _cardScale = 0.55F;
     float _boardScale = 1.0F;
@@ -0,0 +1,130 @@
+#include "views/ProfilerHudView.h"
+
+#include "utils/Profiler.h"
+
+#include <cstdio>
+#include <string>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr float kRefreshInterval = 0.5F;
+
+int countNodes(const cocos2d::Node* node)
+{
+    int count = 1;
+    for (const cocos2d::Node* child : node->getChildren())
+    {
+        count += countNodes(child);
+    }
+    return count;
+}
+
+// TextureCache 只以文本形式报告总量，末行格式为 "... N textures, for X KB (Y MB)"
+std::size_t getCachedTextureKilobytes()
+{
+    const std::string info = cocos2d::Director::getInstance()->getTextureCache()->getCachedTextureInfo();
+    const std::size_t summary = info.rfind("for ");
+    unsigned long kilobytes = 0;
+    if (summary != std::string::npos && std::sscanf(info.c_str() + summary, "for %lu KB", &kilobytes) == 1)
+    {
+        return kilobytes;
+    }
+    return 0;
+}
+
+} // namespace
+
+bool ProfilerHudView::init()
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    _background = cocos2d::LayerColor::create({0, 0, 0, 160}, 420.0F, 300.0F);
+    addChild(_background);
+
+    _label = cocos2d::Label::createWithSystemFont("", "Courier", 18);
+    _label->setAnchorPoint({0.0F, 1.0F});
+    _label->setPosition(10.0F, 290.0F);
+    _label->setAlignment(cocos2d::TextHAlignment::LEFT);
+    addChild(_label);
+
+    setVisible(false);
+    scheduleUpdate();
+    return true;
+}
+
+void ProfilerHudView::update(float delta)
+{
+    // 隐藏时也持续采样，打开浮层即可看到完整的滚动窗口
+    Profiler::endFrame(cocos2d::Director::getInstance()->getDeltaTime());
+
+    if (!isVisible())
+    {
+        return;
+    }
+
+    _refreshTimer += delta;
+    if (_refreshTimer >= kRefreshInterval)
+    {
+        _refreshTimer = 0.0F;
+        refreshText();
+    }
+}
+
+void ProfilerHudView::toggle()
+{
+    setVisible(!isVisible());
+    if (isVisible())
+    {
+        _refreshTimer = 0.0F;
+        refreshText();
+    }
+}
+
+void ProfilerHudView::refreshText()
+{
+    Profiler::Snapshot snapshot;
+    Profiler::getSnapshot(snapshot);
+
+    auto director = cocos2d::Director::getInstance();
+    cocos2d::Renderer* renderer = director->getRenderer();
+    const cocos2d::Scene* scene = director->getRunningScene();
+    const std::size_t textureKilobytes = getCachedTextureKilobytes() + _extraTextureBytes / 1024;
+
+    char buffer[1024];
+    int length = std::snprintf(buffer, sizeof(buffer),
+                               "frame ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n",
+                               snapshot.frameP50Ms, snapshot.frameP95Ms, snapshot.frameP99Ms, snapshot.frameMaxMs);
+
+    for (int section = 0; section < static_cast<int>(ProfileSection::Count); ++section)
+    {
+        const Profiler::SectionStats& stats = snapshot.sections[section];
+        length += std::snprintf(buffer + length, sizeof(buffer) - length,
+                                "%-8s avg %.3f  max %.3f  x%.1f\n",
+                                Profiler::getSectionName(static_cast<ProfileSection>(section)),
+                                stats.averageMs, stats.maxMs, stats.callsPerFrame);
+    }
+
+    std::snprintf(buffer + length, sizeof(buffer) - length,
+                  "draws %d  verts %d  nodes %d\n"
+                  "actions %d  tweens %lld  cards %lld\n"
+                  "textures %zu KB  first frame %.0f ms",
+                  static_cast<int>(renderer->getDrawnBatches()),
+                  static_cast<int>(renderer->getDrawnVertices()),
+                  scene ? countNodes(scene) : 0,
+                  static_cast<int>(director->getActionManager()->getNumberOfRunningActions()),
+                  static_cast<long long>(snapshot.counters[static_cast<int>(ProfileCounter::ActiveTweens)]),
+                  static_cast<long long>(snapshot.counters[static_cast<int>(ProfileCounter::BatchCards)]),
+                  textureKilobytes,
+                  snapshot.timeToFirstFrameMs);
+
+    _label->setString(buffer);
+}
+
+} // namespace tripeaks
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "cocos2d.h"
+
+namespace tripeaks
+{
+
+/**
+ * 性能调试浮层。
+ * 每帧把帧耗时提交给 Profiler；可见时每隔固定间隔刷新一次文本：帧耗时分位数、各子系统耗时、
+ * 上一帧的绘制批次与顶点数、节点数量、运行中的动作数、纹理内存以及启动到首个可交互帧的耗时。
+ */
+class ProfilerHudView : public cocos2d::Node
+{
+public:
+    CREATE_FUNC(ProfilerHudView);
+
+    bool init() override;
+    void update(float delta) override;
+
+    void toggle();
+
+    // 不在 TextureCache 中的纹理（如烘焙的牌面纹理页）需要额外计入
+    void setExtraTextureBytes(std::size_t bytes) { _extraTextureBytes = bytes; }
+
+private:
+    void refreshText();
+
+    cocos2d::LayerColor* _background = nullptr;
+    cocos2d::Label* _label = nullptr;
+    float _refreshTimer = 0.0F;
+    std::size_t _extraTextureBytes = 0;
+};
+
+} // namespace tripeaks
@@ -0,0 +1,106 @@
+#include "views/RaceMiniBoardView.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+namespace tripeaks
+{
+
+namespace
+{
+
+constexpr float kMiniCardWidth = 14.0F;
+constexpr float kMiniCardHeight = 20.0F;
+constexpr float kLabelHeight = 24.0F;
+const cocos2d::Color4F kFaceUpColor(0.95F, 0.95F, 0.9F, 1.0F);
+const cocos2d::Color4F kFaceDownColor(0.2F, 0.35F, 0.75F, 1.0F);
+const cocos2d::Color4F kBorderColor(0.1F, 0.1F, 0.1F, 1.0F);
+
+} // namespace
+
+bool RaceMiniBoardView::init()
+{
+    if (!Node::init())
+    {
+        return false;
+    }
+
+    _background = cocos2d::LayerColor::create({0, 0, 0, 120});
+    addChild(_background);
+
+    _drawNode = cocos2d::DrawNode::create();
+    addChild(_drawNode);
+
+    _label = cocos2d::Label::createWithSystemFont("", "Arial", 16);
+    _label->setAnchorPoint({0.5F, 0.5F});
+    addChild(_label);
+
+    setBoardSize({240.0F, 160.0F});
+    return true;
+}
+
+void RaceMiniBoardView::setBoardSize(const cocos2d::Size& size)
+{
+    _boardSize = size;
+    setContentSize({size.width, size.height + kLabelHeight});
+    _background->setContentSize(getContentSize());
+    _label->setPosition(size.width * 0.5F, size.height + kLabelHeight * 0.5F);
+}
+
+void RaceMiniBoardView::refresh(const GameModel& model)
+{
+    _drawNode->clear();
+
+    // 包围盒取全部桌面牌（含已移除的），牌被移走时其余牌的位置不跳动
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    for (const Card& card : model.getCards())
+    {
+        if (!card.isInPlayfield)
+        {
+            continue;
+        }
+        minX = std::min(minX, card.position.x);
+        minY = std::min(minY, card.position.y);
+        maxX = std::max(maxX, card.position.x);
+        maxY = std::max(maxY, card.position.y);
+    }
+
+    const std::size_t remaining = model.getPlayfieldCardIds().size();
+    char text[32];
+    std::snprintf(text, sizeof(text), "Opponent: %zu left", remaining);
+    _label->setString(text);
+    if (minX > maxX)
+    {
+        return;
+    }
+
+    // 牌的位置为中心点，留出半张牌的边距
+    const float usableWidth = _boardSize.width - kMiniCardWidth;
+    const float usableHeight = _boardSize.height - kMiniCardHeight;
+    const float spanX = std::max(maxX - minX, 1.0F);
+    const float spanY = std::max(maxY - minY, 1.0F);
+    const float scale = std::min(usableWidth / spanX, usableHeight / spanY);
+    const float offsetX = (_boardSize.width - spanX * scale) * 0.5F;
+    const float offsetY = (_boardSize.height - spanY * scale) * 0.5F;
+
+    // 桌面牌按添加顺序由下到上叠放，与主牌桌一致
+    for (const Card& card : model.getCards())
+    {
+        if (!card.isInPlayfield || card.removed)
+        {
+            continue;
+        }
+        const float centerX = offsetX + (card.position.x - minX) * scale;
+        const float centerY = offsetY + (card.position.y - minY) * scale;
+        const cocos2d::Vec2 origin(centerX - kMiniCardWidth * 0.5F, centerY - kMiniCardHeight * 0.5F);
+        const cocos2d::Vec2 destination(origin.x + kMiniCardWidth, origin.y + kMiniCardHeight);
+        _drawNode->drawSolidRect(origin, destination, card.faceUp ? kFaceUpColor : kFaceDownColor);
+        _drawNode->drawRect(origin, destination, kBorderColor);
+    }
+}
+
+} // namespace tripeaks
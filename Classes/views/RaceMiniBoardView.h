@@ -0,0 +1,34 @@
+#pragma once
+
+#include "models/GameModel.h"
+
+#include "cocos2d.h"
+
+namespace tripeaks
+{
+
+/**
+ * 竞速模式下对手的缩略牌桌。
+ * 只画桌面牌：按桌面牌的包围盒等比缩放到视图大小，翻开的牌为浅色、未翻开的为蓝色，已移除的不画；
+ * 下方显示剩余桌面牌数。模型由调用方传入（RaceController 的预测局面），每次 refresh 整体重画。
+ */
+class RaceMiniBoardView : public cocos2d::Node
+{
+public:
+    CREATE_FUNC(RaceMiniBoardView);
+
+    bool init() override;
+
+    // 内容区域大小，默认 240x160
+    void setBoardSize(const cocos2d::Size& size);
+
+    void refresh(const GameModel& model);
+
+private:
+    cocos2d::LayerColor* _background = nullptr;
+    cocos2d::DrawNode* _drawNode = nullptr;
+    cocos2d::Label* _label = nullptr;
+    cocos2d::Size _boardSize;
+};
+
+} // namespace tripeaks
@@ -0,0 +1,302 @@
+#!/usr/bin/env python3
+"""Pack the card resources into a single texture atlas for SpriteFrameCache.
+
+Usage:
+    python3 tools/pack_card_atlas.py [--res-dir res/res] [--name card_atlas]
+                                     [--variants small:0.5,medium:0.75]
+
+Frame names are the resource paths relative to the res directory
+(e.g. "card_general.png", "number/small_red_A.png", "suits/club.png"), so
+GameView can look them up by the same relative path it used to load files.
+
+Besides the full-resolution atlas, a downscaled atlas is written for every
+resolution variant (e.g. card_atlas_small.png/.plist at half size). Frame
+names are identical across variants; CardFaceCache picks the smallest variant
+that still covers the on-screen card density and compensates for its scale.
+Only the Python standard library is required.
+"""
+
+import argparse
+import glob
+import os
+import struct
+import zlib
+
+PADDING = 2
+DEFAULT_VARIANTS = "small:0.5,medium:0.75"
+ATLAS_SOURCES = [
+    "card_general.png",
+    "number/small_*.png",
+    "suits/*.png",
+]
+
+
+def read_png(path):
+    with open(path, "rb") as handle:
+        data = handle.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s is not a PNG file" % path)
+
+    offset = 8
+    width = height = 0
+    color_type = bit_depth = interlace = None
+    idat = bytearray()
+    while offset < len(data):
+        length, chunk_type = struct.unpack(">I4s", data[offset:offset + 8])
+        chunk = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if chunk_type == b"IHDR":
+            width, height, bit_depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif chunk_type == b"IDAT":
+            idat.extend(chunk)
+        elif chunk_type == b"IEND":
+            break
+
+    if bit_depth != 8 or color_type not in (2, 6) or interlace != 0:
+        raise ValueError("%s: only 8-bit non-interlaced RGB/RGBA PNGs are supported" % path)
+
+    channels = 4 if color_type == 6 else 3
+    stride = width * channels
+    raw = zlib.decompress(bytes(idat))
+    rows = []
+    previous = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        filter_type = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            left = line[i - channels] if i >= channels else 0
+            up = previous[i]
+            up_left = previous[i - channels] if i >= channels else 0
+            if filter_type == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif filter_type == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif filter_type == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif filter_type == 4:
+                estimate = left + up - up_left
+                pa, pb, pc = abs(estimate - left), abs(estimate - up), abs(estimate - up_left)
+                predictor = left if pa <= pb and pa <= pc else (up if pb <= pc else up_left)
+                line[i] = (line[i] + predictor) & 0xFF
+        if channels == 3:
+            rgba = bytearray(width * 4)
+            for x in range(width):
+                rgba[x * 4:x * 4 + 3] = line[x * 3:x * 3 + 3]
+                rgba[x * 4 + 3] = 0xFF
+            rows.append(rgba)
+        else:
+            rows.append(line)
+        previous = line
+    return width, height, rows
+
+
+def write_png(path, width, height, pixels):
+    def chunk(chunk_type, payload):
+        body = chunk_type + payload
+        return struct.pack(">I", len(payload)) + body + struct.pack(">I", zlib.crc32(body) & 0xFFFFFFFF)
+
+    stride = width * 4
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        raw.extend(pixels[y * stride:(y + 1) * stride])
+
+    with open(path, "wb") as handle:
+        handle.write(b"\x89PNG\r\n\x1a\n")
+        handle.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        handle.write(chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+        handle.write(chunk(b"IEND", b""))
+
+
+def box_weights(source_size, target_size):
+    """For every target pixel, the (source index, coverage) pairs of its footprint."""
+    ratio = source_size / float(target_size)
+    weights = []
+    for target in range(target_size):
+        start, end = target * ratio, (target + 1) * ratio
+        taps = []
+        index = int(start)
+        while index < end and index < source_size:
+            coverage = min(end, index + 1) - max(start, index)
+            if coverage > 0:
+                taps.append((index, coverage / ratio))
+            index += 1
+        weights.append(taps)
+    return weights
+
+
+def downscale(image, scale):
+    """Area-average resample. Colour is averaged premultiplied so transparent pixels do not bleed."""
+    width, height = image["width"], image["height"]
+    target_width = max(1, int(round(width * scale)))
+    target_height = max(1, int(round(height * scale)))
+    column_weights = box_weights(width, target_width)
+    row_weights = box_weights(height, target_height)
+
+    # horizontal pass into premultiplied float rows
+    horizontal = []
+    for row in image["rows"]:
+        out = [0.0] * (target_width * 4)
+        for x, taps in enumerate(column_weights):
+            r = g = b = a = 0.0
+            for index, weight in taps:
+                alpha = row[index * 4 + 3] * weight
+                r += row[index * 4] * alpha
+                g += row[index * 4 + 1] * alpha
+                b += row[index * 4 + 2] * alpha
+                a += alpha
+            out[x * 4:x * 4 + 4] = (r, g, b, a)
+        horizontal.append(out)
+
+    rows = []
+    for taps in row_weights:
+        line = bytearray(target_width * 4)
+        for x in range(target_width):
+            r = g = b = a = 0.0
+            for index, weight in taps:
+                source = horizontal[index]
+                r += source[x * 4] * weight
+                g += source[x * 4 + 1] * weight
+                b += source[x * 4 + 2] * weight
+                a += source[x * 4 + 3] * weight
+            if a > 0.0:
+                line[x * 4] = min(255, int(round(r / a)))
+                line[x * 4 + 1] = min(255, int(round(g / a)))
+                line[x * 4 + 2] = min(255, int(round(b / a)))
+                line[x * 4 + 3] = min(255, int(round(a)))
+        rows.append(line)
+    return {"name": image["name"], "width": target_width, "height": target_height, "rows": rows}
+
+
+def parse_variants(text):
+    variants = []
+    for item in filter(None, (part.strip() for part in text.split(","))):
+        suffix, _, scale = item.partition(":")
+        scale = float(scale)
+        if not suffix or not 0.0 < scale < 1.0:
+            raise ValueError("invalid variant %r, expected name:scale with 0 < scale < 1" % item)
+        variants.append((suffix, scale))
+    return variants
+
+
+def next_power_of_two(value):
+    result = 1
+    while result < value:
+        result <<= 1
+    return result
+
+
+def shelf_pack(images, atlas_width):
+    """Place images on horizontal shelves, tallest first. Returns the used height."""
+    x = y = shelf_height = 0
+    for image in sorted(images, key=lambda item: (-item["height"], item["name"])):
+        w = image["width"] + PADDING * 2
+        h = image["height"] + PADDING * 2
+        if x + w > atlas_width:
+            x = 0
+            y += shelf_height
+            shelf_height = 0
+        image["x"] = x + PADDING
+        image["y"] = y + PADDING
+        x += w
+        shelf_height = max(shelf_height, h)
+    return y + shelf_height
+
+
+def collect_images(res_dir):
+    images = []
+    for pattern in ATLAS_SOURCES:
+        for path in sorted(glob.glob(os.path.join(res_dir, pattern))):
+            width, height, rows = read_png(path)
+            name = os.path.relpath(path, res_dir).replace(os.sep, "/")
+            images.append({"name": name, "width": width, "height": height, "rows": rows})
+    return images
+
+
+def build_atlas(images):
+    widest = max(image["width"] for image in images) + PADDING * 2
+    total_area = sum((image["width"] + PADDING * 2) * (image["height"] + PADDING * 2) for image in images)
+    atlas_width = next_power_of_two(max(widest, int(total_area ** 0.5)))
+    atlas_height = next_power_of_two(shelf_pack(images, atlas_width))
+
+    pixels = bytearray(atlas_width * atlas_height * 4)
+    for image in images:
+        for row_index, row in enumerate(image["rows"]):
+            start = ((image["y"] + row_index) * atlas_width + image["x"]) * 4
+            pixels[start:start + len(row)] = row
+    return atlas_width, atlas_height, pixels
+
+
+def write_plist(path, texture_name, atlas_width, atlas_height, images):
+    lines = [
+        '<?xml version="1.0" encoding="UTF-8"?>',
+        '<!DOCTYPE plist PUBLIC "-//Apple//DTD PLIST 1.0//EN" "http://www.apple.com/DTDs/PropertyList-1.0.dtd">',
+        '<plist version="1.0">',
+        '    <dict>',
+        '        <key>frames</key>',
+        '        <dict>',
+    ]
+    for image in sorted(images, key=lambda item: item["name"]):
+        size = "{%d,%d}" % (image["width"], image["height"])
+        lines += [
+            '            <key>%s</key>' % image["name"],
+            '            <dict>',
+            '                <key>frame</key>',
+            '                <string>{{%d,%d},%s}</string>' % (image["x"], image["y"], size),
+            '                <key>offset</key>',
+            '                <string>{0,0}</string>',
+            '                <key>rotated</key>',
+            '                <false/>',
+            '                <key>sourceColorRect</key>',
+            '                <string>{{0,0},%s}</string>' % size,
+            '                <key>sourceSize</key>',
+            '                <string>%s</string>' % size,
+            '            </dict>',
+        ]
+    lines += [
+        '        </dict>',
+        '        <key>metadata</key>',
+        '        <dict>',
+        '            <key>format</key>',
+        '            <integer>2</integer>',
+        '            <key>realTextureFileName</key>',
+        '            <string>%s</string>' % texture_name,
+        '            <key>size</key>',
+        '            <string>{%d,%d}</string>' % (atlas_width, atlas_height),
+        '            <key>textureFileName</key>',
+        '            <string>%s</string>' % texture_name,
+        '        </dict>',
+        '    </dict>',
+        '</plist>',
+        '',
+    ]
+    with open(path, "w") as handle:
+        handle.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--res-dir", default=os.path.join(os.path.dirname(__file__), "..", "res", "res"))
+    parser.add_argument("--name", default="card_atlas")
+    parser.add_argument("--variants", default=DEFAULT_VARIANTS,
+                        help="comma separated name:scale list of downscaled atlases, empty to skip")
+    args = parser.parse_args()
+
+    images = collect_images(args.res_dir)
+    outputs = [(args.name, images)]
+    for suffix, scale in parse_variants(args.variants):
+        outputs.append(("%s_%s" % (args.name, suffix), [downscale(image, scale) for image in images]))
+
+    for name, variant_images in outputs:
+        atlas_width, atlas_height, pixels = build_atlas(variant_images)
+        texture_name = name + ".png"
+        write_png(os.path.join(args.res_dir, texture_name), atlas_width, atlas_height, pixels)
+        write_plist(os.path.join(args.res_dir, name + ".plist"), texture_name, atlas_width, atlas_height,
+                    variant_images)
+        print("packed %d frames into %s (%dx%d)" % (len(variant_images), texture_name, atlas_width, atlas_height))
+
+
+if __name__ == "__main__":
+    main()
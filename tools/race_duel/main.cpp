@@ -0,0 +1,478 @@
+// Head-to-head race over loopback UDP between two bot players, for testing
+// the lockstep/rollback sync without the app.
+//
+// Usage:
+//   race_duel play --player 0|1 --port P --peer-port Q [options]
+//   race_duel pair [options]        forks both players and checks they agree
+//
+// Options:
+//   --seed N         deal seed shared by both players (default 7)
+//   --delay N        input delay in ticks at 60 ticks/s (default 4)
+//   --latency MS     injected one-way latency (default 0)
+//   --jitter MS      extra random latency up to MS, reorders packets (default 0)
+//   --loss RATE      probability of dropping an outgoing datagram (default 0)
+//   --think MS       average bot time between moves (default 120)
+//   --timeout S      give up after S seconds (default 120)
+//
+// Each player prints one line with its view of the confirmed result and the
+// state hash of both confirmed boards; `pair` exits non-zero unless the two
+// lines agree.
+
+#include "controllers/RaceController.h"
+#include "managers/RaceLink.h"
+#include "services/HintSearchService.h"
+#include "services/TriPeaksLayoutGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace tripeaks;
+
+namespace
+{
+
+constexpr int kTicksPerSecond = 60;
+constexpr int kHelloIntervalMs = 50;
+// keep sending after the result is confirmed so a lost datagram cannot strand the peer
+constexpr int kLingerMs = 500;
+
+struct DuelOptions
+{
+    int player = 0;
+    unsigned int port = 0;
+    unsigned int peerPort = 0;
+    unsigned int seed = 7;
+    unsigned int delay = 4;
+    unsigned int latencyMs = 0;
+    unsigned int jitterMs = 0;
+    float loss = 0.0F;
+    unsigned int thinkMs = 120;
+    unsigned int timeoutSeconds = 120;
+};
+
+const char* getOutcomeName(RaceOutcome outcome)
+{
+    switch (outcome)
+    {
+    case RaceOutcome::Won:
+        return "won";
+    case RaceOutcome::Lost:
+        return "lost";
+    case RaceOutcome::Draw:
+        return "draw";
+    default:
+        return "racing";
+    }
+}
+
+bool parseOptions(int argc, char** argv, DuelOptions& options)
+{
+    for (int index = 0; index + 1 < argc; index += 2)
+    {
+        const std::string arg = argv[index];
+        const char* value = argv[index + 1];
+        if (arg == "--player")
+        {
+            options.player = std::atoi(value) == 0 ? 0 : 1;
+        }
+        else if (arg == "--port")
+        {
+            options.port = static_cast<unsigned int>(std::atoi(value));
+        }
+        else if (arg == "--peer-port")
+        {
+            options.peerPort = static_cast<unsigned int>(std::atoi(value));
+        }
+        else if (arg == "--seed")
+        {
+            options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        }
+        else if (arg == "--delay")
+        {
+            options.delay = static_cast<unsigned int>(std::atoi(value));
+        }
+        else if (arg == "--latency")
+        {
+            options.latencyMs = static_cast<unsigned int>(std::atoi(value));
+        }
+        else if (arg == "--jitter")
+        {
+            options.jitterMs = static_cast<unsigned int>(std::atoi(value));
+        }
+        else if (arg == "--loss")
+        {
+            options.loss = static_cast<float>(std::atof(value));
+        }
+        else if (arg == "--think")
+        {
+            options.thinkMs = static_cast<unsigned int>(std::max(1, std::atoi(value)));
+        }
+        else if (arg == "--timeout")
+        {
+            options.timeoutSeconds = static_cast<unsigned int>(std::atoi(value));
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Plays its own board immediately, the way GameController does, and hands
+ * every applied move to the race. Mostly follows the hint search, sometimes
+ * plays a random legal move so the two players diverge.
+ */
+class Bot
+{
+public:
+    Bot(const LevelConfig& config, unsigned int seed, unsigned int botSeed) : _random(botSeed)
+    {
+        _table.start(config, seed);
+        _options.maxDepth = 4;
+        _options.maxNodes = 20000;
+        _options.outcomeMaxNodes = 0;
+    }
+
+    bool chooseMove(InputCommand& outCommand)
+    {
+        if (_table.getGameState() != GameState::Playing)
+        {
+            return false;
+        }
+
+        const GameModel& model = _table.getModel();
+        HintSearchService::Result result;
+        if (std::uniform_int_distribution<int>(0, 3)(_random) == 0)
+        {
+            pickRandomMove(model, result.move);
+        }
+        else if (!HintSearchService::findBestMove(model, _options, _cache, nullptr, result))
+        {
+            return false;
+        }
+
+        switch (result.move.type)
+        {
+        case HintSearchService::Move::Type::PlayfieldCard:
+            outCommand.type = InputCommand::Type::CardTap;
+            outCommand.cardId = result.move.cardId;
+            break;
+        case HintSearchService::Move::Type::DrawStock:
+            outCommand.type = InputCommand::Type::StockTap;
+            outCommand.cardId = -1;
+            break;
+        default:
+            return false;
+        }
+        return _table.applyInput(outCommand);
+    }
+
+    std::mt19937& getRandom() { return _random; }
+
+private:
+    void pickRandomMove(const GameModel& model, HintSearchService::Move& outMove)
+    {
+        std::vector<int> candidates;
+        const Card* tray = model.getCardById(model.getTrayCardId());
+        for (int cardId : model.getPlayfieldCardIds())
+        {
+            const Card* card = model.getCardById(cardId);
+            if (tray && card && card->faceUp && model.isCardExposed(cardId) && model.canMatch(*card, *tray))
+            {
+                candidates.emplace_back(cardId);
+            }
+        }
+        if (candidates.empty() || std::uniform_int_distribution<int>(0, 2)(_random) == 0)
+        {
+            outMove.type = HintSearchService::Move::Type::DrawStock;
+            return;
+        }
+        outMove.type = HintSearchService::Move::Type::PlayfieldCard;
+        outMove.cardId = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(_random)];
+    }
+
+    TableController _table;
+    HintSearchService::Options _options;
+    HintSearchService::Cache _cache;
+    std::mt19937 _random;
+};
+
+int play(const DuelOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    LevelConfig config;
+    std::string errorMessage;
+    if (!TriPeaksLayoutGenerator::generate(TriPeaksLayoutOptions(), config, &errorMessage))
+    {
+        std::fprintf(stderr, "Layout: %s\n", errorMessage.c_str());
+        return 1;
+    }
+
+    RaceLink::Options linkOptions;
+    linkOptions.latencyMs = options.latencyMs;
+    linkOptions.jitterMs = options.jitterMs;
+    linkOptions.lossRate = options.loss;
+    linkOptions.seed = options.seed * 31 + static_cast<unsigned int>(options.player);
+    RaceLink link;
+    if (!link.open(static_cast<std::uint16_t>(options.port), static_cast<std::uint16_t>(options.peerPort), linkOptions,
+                   &errorMessage))
+    {
+        std::fprintf(stderr, "%s\n", errorMessage.c_str());
+        return 1;
+    }
+
+    RaceController::Options raceOptions;
+    raceOptions.inputDelay = options.delay;
+    RaceController race;
+    race.start(config, options.seed, options.player, raceOptions);
+    Bot bot(config, options.seed, options.seed * 977 + static_cast<unsigned int>(options.player) * 131 + 1);
+
+    const unsigned int thinkTicks = std::max(1U, options.thinkMs * kTicksPerSecond / 1000);
+    std::uint32_t nextMoveTick = 0;
+    std::size_t moves = 0;
+    std::size_t frames = 0;
+    std::size_t frameBytes = 0;
+    std::uint32_t maxPrediction = 0;
+
+    std::vector<unsigned char> received;
+    std::vector<unsigned char> outgoing;
+    const Clock::time_point begin = Clock::now();
+    Clock::time_point connectedAt;
+    Clock::time_point lastHello;
+    Clock::time_point finishedAt;
+    bool finished = false;
+
+    for (;;)
+    {
+        const Clock::time_point now = Clock::now();
+        if (now - begin > std::chrono::seconds(options.timeoutSeconds))
+        {
+            std::printf("player=%d outcome=timeout tick=%u confirmed=%u\n", options.player, race.getTick(),
+                        race.getConfirmedTick());
+            return 1;
+        }
+
+        const bool wasConnected = race.isConnected();
+        while (link.receive(received))
+        {
+            if (!race.receiveFrame(received.data(), received.size(), &errorMessage))
+            {
+                std::fprintf(stderr, "player %d: %s\n", options.player, errorMessage.c_str());
+                return 1;
+            }
+        }
+
+        if (!race.isConnected())
+        {
+            if (now - lastHello > std::chrono::milliseconds(kHelloIntervalMs))
+            {
+                outgoing.clear();
+                race.writeHello(outgoing);
+                link.send(outgoing);
+                lastHello = now;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (!wasConnected)
+        {
+            connectedAt = now;
+            // answer once more so the peer connects even if our earlier hellos were dropped
+            outgoing.clear();
+            race.writeHello(outgoing);
+            link.send(outgoing);
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - connectedAt).count();
+        const std::uint32_t dueTick = static_cast<std::uint32_t>(elapsed * kTicksPerSecond / 1000);
+        bool advanced = false;
+        while (race.getTick() < dueTick)
+        {
+            if (!finished && race.getPredictedResult().outcome == RaceOutcome::Racing &&
+                race.getTick() >= nextMoveTick)
+            {
+                InputCommand command;
+                if (bot.chooseMove(command))
+                {
+                    race.queueLocalInput(command);
+                    ++moves;
+                }
+                nextMoveTick = race.getTick() + std::uniform_int_distribution<unsigned int>(
+                                                    thinkTicks / 2, thinkTicks + thinkTicks / 2)(bot.getRandom());
+            }
+            if (!race.advanceTick())
+            {
+                break;
+            }
+            advanced = true;
+            maxPrediction = std::max(maxPrediction, race.getTick() - race.getConfirmedTick());
+        }
+
+        if (advanced)
+        {
+            outgoing.clear();
+            race.writeInputs(outgoing);
+            link.send(outgoing);
+            ++frames;
+            frameBytes += outgoing.size();
+        }
+
+        const RaceResult& result = race.getConfirmedResult();
+        if (!finished && result.outcome != RaceOutcome::Racing && race.getPeerAckTick() > result.tick)
+        {
+            finished = true;
+            finishedAt = now;
+        }
+        if (finished && now - finishedAt > std::chrono::milliseconds(kLingerMs))
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const RaceResult& result = race.getConfirmedResult();
+    std::printf("player=%d outcome=%s tick=%u hash0=%016llx hash1=%016llx moves=%zu frames=%zu frameBytes=%zu "
+                "datagrams=%zu bytes=%zu rollbacks=%u maxPrediction=%u\n",
+                options.player, getOutcomeName(result.outcome), result.tick,
+                static_cast<unsigned long long>(race.getConfirmedTable(0).computeStateHash()),
+                static_cast<unsigned long long>(race.getConfirmedTable(1).computeStateHash()), moves, frames,
+                frameBytes, link.getSentDatagrams(), link.getSentBytes(), race.getRollbackCount(), maxPrediction);
+    std::fflush(stdout);
+    return 0;
+}
+
+// Runs one player in a child process and returns its stdout line through a pipe
+pid_t spawnPlayer(const DuelOptions& options, int& outReadFd)
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+    {
+        return -1;
+    }
+    const pid_t pid = ::fork();
+    if (pid == 0)
+    {
+        ::close(fds[0]);
+        ::dup2(fds[1], STDOUT_FILENO);
+        ::close(fds[1]);
+        std::_Exit(play(options));
+    }
+    ::close(fds[1]);
+    outReadFd = fds[0];
+    return pid;
+}
+
+std::string readAll(int fd)
+{
+    std::string text;
+    char buffer[512];
+    ssize_t count = 0;
+    while ((count = ::read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        text.append(buffer, static_cast<std::size_t>(count));
+    }
+    ::close(fd);
+    return text;
+}
+
+std::string getField(const std::string& line, const char* key)
+{
+    const std::string prefix = std::string(key) + "=";
+    std::size_t start = line.find(prefix);
+    if (start == std::string::npos)
+    {
+        return std::string();
+    }
+    start += prefix.size();
+    return line.substr(start, line.find_first_of(" \n", start) - start);
+}
+
+int pair(DuelOptions options)
+{
+    // ports derived from the pid so concurrent runs do not collide
+    const unsigned int basePort = 20000 + static_cast<unsigned int>(::getpid() % 20000) * 2;
+    DuelOptions first = options;
+    first.player = 0;
+    first.port = basePort;
+    first.peerPort = basePort + 1;
+    DuelOptions second = options;
+    second.player = 1;
+    second.port = basePort + 1;
+    second.peerPort = basePort;
+
+    int firstFd = -1;
+    int secondFd = -1;
+    const pid_t firstPid = spawnPlayer(first, firstFd);
+    const pid_t secondPid = spawnPlayer(second, secondFd);
+    if (firstPid < 0 || secondPid < 0)
+    {
+        std::fprintf(stderr, "Failed to start players\n");
+        return 1;
+    }
+    const std::string firstLine = readAll(firstFd);
+    const std::string secondLine = readAll(secondFd);
+    int firstStatus = 0;
+    int secondStatus = 0;
+    ::waitpid(firstPid, &firstStatus, 0);
+    ::waitpid(secondPid, &secondStatus, 0);
+    std::printf("%s%s", firstLine.c_str(), secondLine.c_str());
+
+    const std::string firstOutcome = getField(firstLine, "outcome");
+    const std::string secondOutcome = getField(secondLine, "outcome");
+    const bool complementary = (firstOutcome == "won" && secondOutcome == "lost") ||
+                               (firstOutcome == "lost" && secondOutcome == "won") ||
+                               (firstOutcome == "draw" && secondOutcome == "draw");
+    const bool agree = complementary && getField(firstLine, "tick") == getField(secondLine, "tick") &&
+                       getField(firstLine, "hash0") == getField(secondLine, "hash0") &&
+                       getField(firstLine, "hash1") == getField(secondLine, "hash1");
+    const bool exitedCleanly = WIFEXITED(firstStatus) && WEXITSTATUS(firstStatus) == 0 &&
+                               WIFEXITED(secondStatus) && WEXITSTATUS(secondStatus) == 0;
+    std::printf("%s\n", agree && exitedCleanly ? "players agree" : "PLAYERS DISAGREE");
+    return agree && exitedCleanly ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s play|pair [options]\n", argv[0]);
+        return 2;
+    }
+    DuelOptions options;
+    if (!parseOptions(argc - 2, argv + 2, options))
+    {
+        return 2;
+    }
+    const std::string mode = argv[1];
+    if (mode == "play")
+    {
+        if (options.port == 0 || options.peerPort == 0)
+        {
+            std::fprintf(stderr, "play needs --port and --peer-port\n");
+            return 2;
+        }
+        return play(options);
+    }
+    if (mode == "pair")
+    {
+        return pair(options);
+    }
+    std::fprintf(stderr, "Unknown mode %s\n", mode.c_str());
+    return 2;
+}
@@ -0,0 +1,398 @@
+// Headless session service over a Unix domain socket, plus a load generator.
+//
+// Usage:
+//   session_server serve <socket> [--shards N] [--tables N] [--levels N]
+//                                 [--outcome-nodes N]
+//   session_server bench <socket> [--clients N] [--sessions N] [--batches N]
+//                                 [--batch-size N] [--pipeline N] [--seed N]
+//
+// Level i is the default procedural TriPeaks layout dealt with layout seed
+// i + 1; --levels defaults to 1. Level files are read through cocos2d and only
+// by the app, so the tool builds from the core sources alone. --outcome-nodes
+// sets the node budget of the unwinnable check run after every batch; it is off
+// by default. The wire format is documented in Classes/services/SessionProtocol.h.
+
+#include "managers/GameSessionManager.h"
+#include "managers/SessionSocketServer.h"
+#include "services/SessionProtocol.h"
+#include "services/TriPeaksLayoutGenerator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace tripeaks;
+
+namespace
+{
+
+SessionSocketServer* gServer = nullptr;
+
+void onSignal(int)
+{
+    // stop() only stores a flag and writes the eventfd, both async-signal-safe
+    if (gServer)
+    {
+        gServer->stop();
+    }
+}
+
+bool parseCount(const char* text, std::size_t& outValue)
+{
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0')
+    {
+        return false;
+    }
+    outValue = static_cast<std::size_t>(value);
+    return true;
+}
+
+int serve(const std::string& socketPath, int argc, char** argv)
+{
+    GameSessionManager::Options options;
+    std::size_t levelCount = 1;
+    for (int index = 0; index + 1 < argc; index += 2)
+    {
+        const std::string arg = argv[index];
+        std::size_t* target = arg == "--shards"          ? &options.shardCount
+                              : arg == "--tables"        ? &options.activeTablesPerShard
+                              : arg == "--levels"        ? &levelCount
+                              : arg == "--outcome-nodes" ? &options.outcomeMaxNodes
+                                                         : nullptr;
+        if (!target || !parseCount(argv[index + 1], *target))
+        {
+            std::fprintf(stderr, "Invalid option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    if (levelCount == 0)
+    {
+        std::fprintf(stderr, "--levels must be at least 1\n");
+        return 2;
+    }
+
+    GameSessionManager sessions(options);
+    std::string errorMessage;
+    for (std::size_t level = 0; level < levelCount; ++level)
+    {
+        TriPeaksLayoutOptions layout;
+        layout.seed = static_cast<unsigned int>(level + 1);
+        LevelConfig config;
+        if (!TriPeaksLayoutGenerator::generate(layout, config, &errorMessage))
+        {
+            std::fprintf(stderr, "Layout %zu: %s\n", level, errorMessage.c_str());
+            return 1;
+        }
+        sessions.addLevel(config);
+    }
+
+    SessionSocketServer server(sessions);
+    if (!server.start(socketPath, &errorMessage))
+    {
+        std::fprintf(stderr, "%s\n", errorMessage.c_str());
+        return 1;
+    }
+    gServer = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::fprintf(stderr, "Serving %zu level(s) on %s with %zu shard(s)\n", levelCount, socketPath.c_str(),
+                 sessions.getShardCount());
+    server.run();
+    gServer = nullptr;
+    return 0;
+}
+
+struct BenchOptions
+{
+    std::size_t clients = 4;
+    std::size_t sessions = 64;      // per client
+    std::size_t batches = 200;      // apply requests per session
+    std::size_t batchSize = 8;      // moves per apply request
+    std::size_t pipeline = 32;      // requests in flight per client
+    std::size_t seed = 1;
+};
+
+struct BenchResult
+{
+    std::size_t requests = 0;
+    std::size_t moves = 0;
+    std::size_t applied = 0;
+    std::size_t errors = 0;
+};
+
+int connectTo(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, std::vector<unsigned char>& bytes)
+{
+    std::size_t offset = 0;
+    while (offset < bytes.size())
+    {
+        const ssize_t sent = ::send(fd, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        offset += static_cast<std::size_t>(sent);
+    }
+    bytes.clear();
+    return true;
+}
+
+/**
+ * Blocking client that keeps up to `pipeline` requests in flight and reads
+ * responses in order.
+ */
+class BenchClient
+{
+public:
+    explicit BenchClient(int fd) : _fd(fd), _input(64 * 1024) {}
+    ~BenchClient() { ::close(_fd); }
+
+    bool receive(SessionProtocol::Response& outResponse)
+    {
+        for (;;)
+        {
+            std::size_t consumed = 0;
+            const SessionProtocol::DecodeStatus status =
+                SessionProtocol::decodeResponse(_input.data() + _start, _end - _start, outResponse, consumed);
+            if (status == SessionProtocol::DecodeStatus::Complete)
+            {
+                _start += consumed;
+                return true;
+            }
+            if (status == SessionProtocol::DecodeStatus::Malformed)
+            {
+                return false;
+            }
+            if (_start > 0)
+            {
+                std::memmove(_input.data(), _input.data() + _start, _end - _start);
+                _end -= _start;
+                _start = 0;
+            }
+            const ssize_t received = ::read(_fd, _input.data() + _end, _input.size() - _end);
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0)
+            {
+                return false;
+            }
+            _end += static_cast<std::size_t>(received);
+        }
+    }
+
+private:
+    int _fd;
+    std::vector<unsigned char> _input;
+    std::size_t _start = 0;
+    std::size_t _end = 0;
+};
+
+void runBenchClient(const std::string& socketPath, const BenchOptions& options, std::size_t clientIndex,
+                    BenchResult& outResult)
+{
+    const int fd = connectTo(socketPath);
+    if (fd < 0)
+    {
+        ++outResult.errors;
+        return;
+    }
+    BenchClient client(fd);
+    std::mt19937 random(static_cast<unsigned int>(options.seed * 7919 + clientIndex));
+    std::vector<unsigned char> output;
+    SessionProtocol::Response response;
+
+    // Creates and destroys go out in pipeline-sized chunks so neither side's buffers fill up
+    std::vector<std::uint32_t> sessionIds;
+    sessionIds.reserve(options.sessions);
+    while (sessionIds.size() < options.sessions)
+    {
+        const std::size_t chunk = std::min(options.pipeline, options.sessions - sessionIds.size());
+        for (std::size_t index = 0; index < chunk; ++index)
+        {
+            SessionProtocol::appendCreateRequest(0, random(), output);
+        }
+        if (!sendAll(fd, output))
+        {
+            ++outResult.errors;
+            return;
+        }
+        for (std::size_t index = 0; index < chunk; ++index)
+        {
+            if (!client.receive(response) || response.opcode != SessionProtocol::Opcode::Create ||
+                !response.state.found)
+            {
+                ++outResult.errors;
+                return;
+            }
+            sessionIds.emplace_back(response.state.session);
+        }
+    }
+
+    // Mostly card taps on arbitrary ids (rejected taps cost a lookup), some stock draws and undos
+    std::vector<InputCommand> moves(options.batchSize);
+    const std::size_t total = options.batches * sessionIds.size();
+    std::size_t sent = 0;
+    std::size_t received = 0;
+    while (received < total)
+    {
+        while (sent < total && sent - received < options.pipeline)
+        {
+            for (InputCommand& move : moves)
+            {
+                const unsigned int roll = random() % 16;
+                move.type = roll == 0 ? InputCommand::Type::Undo
+                                      : (roll < 3 ? InputCommand::Type::StockTap : InputCommand::Type::CardTap);
+                move.cardId = static_cast<int>(random() % 28);
+            }
+            SessionProtocol::appendApplyRequest(sessionIds[sent % sessionIds.size()], moves.data(), moves.size(),
+                                                output);
+            ++sent;
+        }
+        if (!output.empty() && !sendAll(fd, output))
+        {
+            ++outResult.errors;
+            return;
+        }
+        if (!client.receive(response) || response.opcode != SessionProtocol::Opcode::Apply)
+        {
+            ++outResult.errors;
+            return;
+        }
+        ++received;
+        ++outResult.requests;
+        outResult.moves += moves.size();
+        outResult.applied += response.state.applied;
+    }
+
+    for (std::size_t first = 0; first < sessionIds.size(); first += options.pipeline)
+    {
+        const std::size_t chunk = std::min(options.pipeline, sessionIds.size() - first);
+        for (std::size_t index = 0; index < chunk; ++index)
+        {
+            SessionProtocol::appendSessionRequest(SessionProtocol::Opcode::Destroy, sessionIds[first + index], output);
+        }
+        if (!sendAll(fd, output))
+        {
+            ++outResult.errors;
+            return;
+        }
+        for (std::size_t index = 0; index < chunk; ++index)
+        {
+            if (!client.receive(response) || response.opcode != SessionProtocol::Opcode::Destroy ||
+                !response.state.found)
+            {
+                ++outResult.errors;
+                return;
+            }
+        }
+    }
+}
+
+int bench(const std::string& socketPath, int argc, char** argv)
+{
+    BenchOptions options;
+    for (int index = 0; index + 1 < argc; index += 2)
+    {
+        const std::string arg = argv[index];
+        std::size_t* target = arg == "--clients"      ? &options.clients
+                              : arg == "--sessions"   ? &options.sessions
+                              : arg == "--batches"    ? &options.batches
+                              : arg == "--batch-size" ? &options.batchSize
+                              : arg == "--pipeline"   ? &options.pipeline
+                              : arg == "--seed"       ? &options.seed
+                                                      : nullptr;
+        if (!target || !parseCount(argv[index + 1], *target))
+        {
+            std::fprintf(stderr, "Invalid option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+    options.pipeline = std::max<std::size_t>(1, options.pipeline);
+    options.batchSize = std::min(options.batchSize, SessionProtocol::kMaxMovesPerApply);
+
+    std::vector<BenchResult> results(options.clients);
+    std::vector<std::thread> threads;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < options.clients; ++index)
+    {
+        threads.emplace_back(runBenchClient, socketPath, std::cref(options), index, std::ref(results[index]));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    BenchResult total;
+    for (const BenchResult& result : results)
+    {
+        total.requests += result.requests;
+        total.moves += result.moves;
+        total.applied += result.applied;
+        total.errors += result.errors;
+    }
+    std::printf("clients=%zu sessions=%zu requests=%zu moves=%zu applied=%zu errors=%zu\n", options.clients,
+                options.clients * options.sessions, total.requests, total.moves, total.applied, total.errors);
+    std::printf("%.3f s, %.0f requests/s, %.0f moves/s\n", seconds, total.requests / seconds, total.moves / seconds);
+    return total.errors == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s serve|bench <socket> [options]\n", argv[0]);
+        return 2;
+    }
+    const std::string mode = argv[1];
+    if (mode == "serve")
+    {
+        return serve(argv[2], argc - 3, argv + 3);
+    }
+    if (mode == "bench")
+    {
+        return bench(argv[2], argc - 3, argv + 3);
+    }
+    std::fprintf(stderr, "Unknown mode %s\n", mode.c_str());
+    return 2;
+}